@@ -0,0 +1,598 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * Micro benchmarks of the library on the host.
+ *
+ * Usage: stm32common_bench [--json] [--quick] [--filter TEXT]
+ *
+ * Every benchmark is calibrated to run about 20 ms (2 ms with --quick), then measured five times. The median time
+ * per operation is reported, with --json as one JSON document on stdout for regression tracking:
+ * {"suite":"stm32common_bench","unit":"ns/op","results":[{"name":"...","iterations":...,"ns_per_op":...,
+ * "bytes_per_op":...}, ...]}
+ *
+ * Benchmarks that time every single operation also report the slowest one of the measured runs, as "max_ns". On the
+ * host, it includes the preemptions of the benchmark by the operating system.
+ *
+ * An operation of Scheduler/dispatch_<n> is one Scheduler::loop() that dispatches all n tasks. An operation of
+ * Manager/echo_<n> echoes one byte through each of n sessions. Manager/one_of_64 echoes one byte through one of 64
+ * sessions, the others are idle.
+ *
+ * stm32common_bench_instrumented is the same program linked against stm32common_host_instrumented, with the
+ * statistics, the profiler and the trace compiled in. Its suite is "stm32common_bench_instrumented", and it adds
+ * StringBuffer/write_read_64_stats: write_read_64 with the buffer statistics counting, under a name that can be
+ * compared with write_read_64 of the plain suite.
+ */
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include "DeferredCallQueue.hpp"
+#include "Hash/Base58.hpp"
+#include "Hash/MurmurHash3.hpp"
+#include "Hexdump.hpp"
+#include "LatencyHistogram.hpp"
+#include "Print.hpp"
+#include "Profiler.hpp"
+#include "RingBuffer.hpp"
+#include "Scheduler.hpp"
+#include "Serialize/CborWriter.hpp"
+#include "Serialize/JsonWriter.hpp"
+#include "Stopwatch.hpp"
+#include "StreamSession/StreamSessionAware.hpp"
+#include "StreamSession/EchoStreamSession.hpp"
+#include "StreamSession/Manager.hpp"
+#include "StringBuffer.hpp"
+#include "Timebase.hpp"
+
+using namespace Stm32Common;
+
+namespace {
+    /**
+     * Writes to stdout.
+     */
+    class StdoutPrint : public Print {
+    public:
+        size_t write(const uint8_t data) override { return fputc(data, stdout) == EOF ? 0 : 1; }
+
+        size_t write(const uint8_t *inputBytes, const size_t size) override {
+            return fwrite(inputBytes, 1, size, stdout);
+        }
+
+        size_t getWriteBuffer(uint8_t *&buffer) override {
+            buffer = scratch;
+            return sizeof(scratch);
+        }
+
+        size_t setWrittenBytes(const size_t size) override { return write(scratch, size); }
+
+        int availableForWrite() override { return sizeof(scratch); }
+
+        void flush() override { fflush(stdout); }
+
+        using Print::write;
+
+    private:
+        uint8_t scratch[128] = {};
+    };
+
+
+    /**
+     * Counts and discards the output, so the Print benchmarks measure the formatting only.
+     */
+    class NullPrint : public Print {
+    public:
+        size_t write(const uint8_t data) override {
+            sink += data;
+            return 1;
+        }
+
+        size_t write(const uint8_t *inputBytes, const size_t size) override {
+            if (size > 0) sink += inputBytes[size - 1];
+            return size;
+        }
+
+        size_t getWriteBuffer(uint8_t *&buffer) override {
+            buffer = scratch;
+            return sizeof(scratch);
+        }
+
+        size_t setWrittenBytes(const size_t size) override { return write(scratch, size); }
+
+        int availableForWrite() override { return sizeof(scratch); }
+
+        void flush() override { ; }
+
+        using Print::write;
+
+        volatile uint8_t sink = 0;
+
+    private:
+        uint8_t scratch[128] = {};
+    };
+
+
+    // Keeps results alive, so the compiler cannot remove the benchmarked code
+    volatile uint32_t blackhole = 0;
+
+    const uint8_t text64[] = "The quick brown fox jumps over the lazy dog, again and again. 0123";
+
+    uint8_t data1k[1024];
+
+    NullPrint nullPrint;
+
+    // The slowest single operation, for the benchmarks that time every operation [cycles]
+    uint64_t maxLatency_cycles = 0;
+
+    void recordLatency(const uint64_t cycles) {
+        if (cycles > maxLatency_cycles) maxLatency_cycles = cycles;
+    }
+
+
+    struct Benchmark {
+        const char *name;
+        size_t bytesPerOp;
+
+        void (*run)(uint32_t iterations);
+    };
+
+    void stringBufferWriteRead64(uint32_t iterations) {
+        static StringBuffer<256> buffer;
+        uint8_t out[64];
+        while (iterations--) {
+            buffer.write(text64, 64);
+            blackhole += buffer.read(out, sizeof(out));
+        }
+    }
+
+    void stringBufferByte(uint32_t iterations) {
+        static StringBuffer<256> buffer;
+        while (iterations--) {
+            buffer.write(static_cast<uint8_t>(iterations));
+            blackhole += buffer.read();
+        }
+    }
+
+    void stringBufferFindPos(uint32_t iterations) {
+        static StringBuffer<256> buffer;
+        buffer.clear();
+        buffer.write(text64, 63);
+        buffer.write('\n');
+        while (iterations--) blackhole += buffer.findPos('\n');
+    }
+
+    void ringBufferEnqueueDequeue(uint32_t iterations) {
+        static RingBuffer<uint32_t, 64> ring;
+        uint32_t value = 0;
+        while (iterations--) {
+            ring.enqueue(iterations);
+            ring.dequeue(value);
+            blackhole += value;
+        }
+    }
+
+    void printUnsigned(uint32_t iterations) {
+        while (iterations--) nullPrint.print(static_cast<unsigned long>(iterations | 0x10000000UL));
+    }
+
+    void printFloat(uint32_t iterations) {
+        while (iterations--) nullPrint.print(3.14159 + iterations, 3);
+    }
+
+    void printPrintf(uint32_t iterations) {
+        while (iterations--) nullPrint.printf("%s=%lu (%d%%)", "value", static_cast<unsigned long>(iterations), 42);
+    }
+
+    void streamParseInt(uint32_t iterations) {
+        static StringBuffer<64> buffer;
+        while (iterations--) {
+            buffer.clear();
+            buffer.write("  -123456789,");
+            blackhole += buffer.parseInt();
+        }
+    }
+
+    void streamParseFloat(uint32_t iterations) {
+        static StringBuffer<64> buffer;
+        while (iterations--) {
+            buffer.clear();
+            buffer.write("  -1234.5678,");
+            blackhole += static_cast<uint32_t>(buffer.parseFloat());
+        }
+    }
+
+    void murmurHash64(uint32_t iterations) {
+        while (iterations--) {
+            blackhole += Hash::MurmurHash3::murmur3_32(text64, 64, iterations);
+        }
+    }
+
+    void murmurHash1k(uint32_t iterations) {
+        while (iterations--) blackhole += Hash::MurmurHash3::murmur3_32(data1k, sizeof(data1k), iterations);
+    }
+
+    void base58Encode32(uint32_t iterations) {
+        char b58[64];
+        while (iterations--) {
+            size_t size = sizeof(b58);
+            Hash::Base58::b58enc(b58, &size, data1k, 32);
+            blackhole += size;
+        }
+    }
+
+    void base58Decode32(uint32_t iterations) {
+        char b58[64];
+        size_t b58size = sizeof(b58);
+        Hash::Base58::b58enc(b58, &b58size, data1k, 32);
+        uint8_t bin[32];
+        while (iterations--) {
+            size_t size = sizeof(bin);
+            Hash::Base58::b58tobin(bin, &size, b58, b58size - 1);
+            blackhole += bin[0];
+        }
+    }
+
+    void hexdump256(uint32_t iterations) {
+        const Hexdump dump(data1k, 256);
+        while (iterations--) blackhole += dump.printTo(nullPrint);
+    }
+
+    // The same layout as Hexdump with one printf() per byte, as the formatter replaces it
+    void hexdumpPrintf256(uint32_t iterations) {
+        while (iterations--) {
+            for (size_t line = 0; line < 256; line += 16) {
+                size_t n = nullPrint.printf("%08lx  ", static_cast<unsigned long>(line));
+                for (size_t i = 0; i < 16; i++) n += nullPrint.printf(i == 7 ? "%02x  " : "%02x ", data1k[line + i]);
+                n += nullPrint.print(" |");
+                for (size_t i = 0; i < 16; i++) {
+                    const uint8_t c = data1k[line + i];
+                    n += nullPrint.print(static_cast<char>(c >= 0x20 && c < 0x7f ? c : '.'));
+                }
+                n += nullPrint.println('|');
+                blackhole += n;
+            }
+        }
+    }
+
+    // A telemetry record of JsonWriterBytes bytes as JSON and CborWriterBytes bytes as CBOR
+    constexpr size_t JsonWriterBytes = 112;
+    constexpr size_t CborWriterBytes = 75;
+
+    void jsonWriterRecord(uint32_t iterations) {
+        while (iterations--) {
+            Serialize::JsonWriter json(nullPrint);
+            json.beginObject();
+            json.member("id", "node-7");
+            json.member("uptime", static_cast<unsigned long>(iterations | 0x10000000UL));
+            json.member("temperature", 21.5, 1);
+            json.member("ok", true);
+            json.key("samples").beginArray();
+            for (int i = 0; i < 8; i++) json.value(i * 1000);
+            json.endArray();
+            json.endObject();
+            blackhole += json.getBytesWritten();
+        }
+    }
+
+    void cborWriterRecord(uint32_t iterations) {
+        while (iterations--) {
+            Serialize::CborWriter cbor(nullPrint);
+            cbor.beginMap(5);
+            cbor.key("id").value("node-7");
+            cbor.key("uptime").value(static_cast<unsigned long>(iterations | 0x10000000UL));
+            cbor.key("temperature").value(21.5f);
+            cbor.key("ok").value(true);
+            cbor.key("samples").beginArray(8);
+            for (int i = 0; i < 8; i++) cbor.value(i * 1000);
+            cbor.end();
+            cbor.end();
+            blackhole += cbor.getBytesWritten();
+        }
+    }
+
+    /**
+     * Counts its runs, without std::function.
+     */
+    class CountingTask : public RunEvery {
+    public:
+        explicit CountingTask(const uint32_t interval_ms = 0) : RunEvery(interval_ms, interval_ms) { ; }
+
+    protected:
+        void run() override { blackhole++; }
+    };
+
+    // One pass of a scheduler whose Tasks tasks are all due
+    template<size_t Tasks>
+    void schedulerDispatch(uint32_t iterations) {
+        static Scheduler<Tasks> scheduler;
+        static CountingTask tasks[Tasks];
+        if (scheduler.getTaskCount() == 0) {
+            for (CountingTask &task: tasks) scheduler.add(task);
+        }
+        while (iterations--) scheduler.loop();
+    }
+
+    // One pass of a scheduler of which no task is due
+    void schedulerIdle1000(uint32_t iterations) {
+        static Scheduler<1000> scheduler;
+        static CountingTask tasks[1000];
+        if (scheduler.getTaskCount() == 0) {
+            for (size_t i = 0; i < 1000; i++) {
+                tasks[i].setInterval(3600000 + i);
+                tasks[i].setDelay(3600000 + i);
+                scheduler.add(tasks[i]);
+            }
+        }
+        while (iterations--) scheduler.loop();
+    }
+
+    /**
+     * Empties the transmit buffer of a session, like an owner with a fast interface.
+     */
+    class DrainingOwner : public StreamSession::StreamSessionAware {
+    public:
+        DrainingOwner() : StreamSessionAware(nullptr) { ; }
+
+        void dataReadyTx(StreamSession::StreamSessionInterface *session) override {
+            auto *tx = static_cast<StreamSession::EchoStreamSession *>(session)->getTxBuffer();
+            while (tx->available() > 0) blackhole += tx->read();
+        }
+    };
+
+    template<size_t Sessions>
+    StreamSession::Manager<StreamSession::EchoStreamSession, Sessions> &echoManager() {
+        static StreamSession::Manager<StreamSession::EchoStreamSession, Sessions> manager;
+        static DrainingOwner owner;
+        if (manager.getSessionsInUse() == 0) {
+            for (size_t i = 0; i < Sessions; i++) manager.getNewSession(&owner, i + 1);
+            while (manager.hasReadySessions()) manager.loop();
+        }
+        return manager;
+    }
+
+    // Receives one byte on each of Sessions sessions and loops until all have been answered
+    template<size_t Sessions>
+    void managerEcho(uint32_t iterations) {
+        auto &manager = echoManager<Sessions>();
+        while (iterations--) {
+            for (size_t i = 0; i < Sessions; i++) {
+                static_cast<StreamSession::EchoStreamSession *>(manager.getSessionById(i + 1))
+                    ->getRxBuffer()->write(static_cast<uint8_t>(iterations));
+            }
+            while (manager.hasReadySessions()) manager.loop();
+        }
+    }
+
+    // Receives one byte on the last of 64 sessions and loops until it has been answered
+    void managerOneOf64(uint32_t iterations) {
+        auto &manager = echoManager<64>();
+        auto *session = static_cast<StreamSession::EchoStreamSession *>(manager.getSessionById(64));
+        while (iterations--) {
+            session->getRxBuffer()->write(static_cast<uint8_t>(iterations));
+            while (manager.hasReadySessions()) manager.loop();
+        }
+    }
+
+    // Values spread over all buckets, like measured latencies
+    void latencyHistogramRecord(uint32_t iterations) {
+        static LatencyHistogram<> histogram;
+        while (iterations--) histogram.record(iterations * 2654435761U >> (iterations & 31));
+        blackhole += histogram.getCount();
+    }
+
+    // Timing of a scope with Stopwatch: two cycle counter reads and a record()
+    void stopwatchScope(uint32_t iterations) {
+        static Stopwatch stopwatch;
+        while (iterations--) {
+            const Stopwatch::Scope scope(stopwatch);
+            blackhole++;
+        }
+    }
+
+    // Enter and leave one ProfileZone scope, as PROFILE_ZONE() does
+    void profilerScope(uint32_t iterations) {
+        static ProfileZone zone("bench");
+        while (iterations--) {
+            const ProfileZone::Scope scope(zone);
+            blackhole++;
+        }
+    }
+
+    void nop(void *) { ; }
+
+    // Uncontended post() and drain() of one call
+    void deferredCallQueuePostDrain(uint32_t iterations) {
+        static DeferredCallQueue<64> queue;
+        while (iterations--) {
+            queue.post(nop, nullptr);
+            blackhole += queue.drain();
+        }
+    }
+
+    // Timed post() of this thread, while three threads post and one thread drains. Only max_ns is meaningful, ns/op
+    // includes the start of the threads and the yields on a full queue
+    void deferredCallQueuePostContended(uint32_t iterations) {
+        static DeferredCallQueue<64> queue;
+        std::atomic<bool> stop{false};
+        std::thread consumer([&stop]() {
+            while (!stop) {
+                if (queue.drain() == 0) std::this_thread::yield();
+            }
+        });
+        std::thread producers[3];
+        for (std::thread &producer: producers) {
+            producer = std::thread([&stop]() {
+                while (!stop) {
+                    if (!queue.post(nop, nullptr)) std::this_thread::yield();
+                }
+            });
+        }
+
+        while (iterations--) {
+            const uint64_t start = Timebase::getCycles();
+            const bool posted = queue.post(nop, nullptr);
+            const uint64_t cycles = Timebase::getCycles() - start;
+            if (posted) recordLatency(cycles);
+            else std::this_thread::yield();
+        }
+
+        stop = true;
+        for (std::thread &producer: producers) producer.join();
+        consumer.join();
+        queue.drain();
+    }
+
+    const Benchmark benchmarks[] = {
+        {"StringBuffer/write_read_64", 64, stringBufferWriteRead64},
+#ifdef LIBSMART_ENABLE_BUFFER_STATISTICS
+        {"StringBuffer/write_read_64_stats", 64, stringBufferWriteRead64},
+#endif
+        {"StringBuffer/write_read_byte", 1, stringBufferByte},
+        {"StringBuffer/findPos_64", 64, stringBufferFindPos},
+        {"RingBuffer/enqueue_dequeue", 4, ringBufferEnqueueDequeue},
+        {"Print/print_unsigned", 0, printUnsigned},
+        {"Print/print_float", 0, printFloat},
+        {"Print/printf", 0, printPrintf},
+        {"Hexdump/dump_256", 256, hexdump256},
+        {"Hexdump/printf_256", 256, hexdumpPrintf256},
+        {"JsonWriter/record", JsonWriterBytes, jsonWriterRecord},
+        {"CborWriter/record", CborWriterBytes, cborWriterRecord},
+        {"Stream/parseInt", 0, streamParseInt},
+        {"Stream/parseFloat", 0, streamParseFloat},
+        {"Scheduler/dispatch_10", 0, schedulerDispatch<10>},
+        {"Scheduler/dispatch_100", 0, schedulerDispatch<100>},
+        {"Scheduler/dispatch_1000", 0, schedulerDispatch<1000>},
+        {"Scheduler/idle_1000", 0, schedulerIdle1000},
+        {"Manager/echo_1", 1, managerEcho<1>},
+        {"Manager/echo_8", 8, managerEcho<8>},
+        {"Manager/echo_64", 64, managerEcho<64>},
+        {"Manager/one_of_64", 1, managerOneOf64},
+        {"LatencyHistogram/record", 0, latencyHistogramRecord},
+        {"Stopwatch/scope", 0, stopwatchScope},
+        {"Profiler/scope", 0, profilerScope},
+        {"DeferredCallQueue/post_drain", 0, deferredCallQueuePostDrain},
+        {"DeferredCallQueue/post_contended", 0, deferredCallQueuePostContended},
+        {"MurmurHash3/murmur3_32_64", 64, murmurHash64},
+        {"MurmurHash3/murmur3_32_1k", 1024, murmurHash1k},
+        {"Base58/encode_32", 32, base58Encode32},
+        {"Base58/decode_32", 32, base58Decode32},
+    };
+
+    struct Result {
+        uint32_t iterations;
+        double nsPerOp;
+        uint64_t maxNs;
+    };
+
+    uint64_t measure(const Benchmark &benchmark, const uint32_t iterations) {
+        const uint64_t start = Timebase::getCycles();
+        benchmark.run(iterations);
+        return Timebase::cyclesToNanos(Timebase::getCycles() - start);
+    }
+
+    // The faster of two runs, so a preemption of the process does not spoil the calibration
+    uint64_t measureBest(const Benchmark &benchmark, const uint32_t iterations) {
+        const uint64_t first = measure(benchmark, iterations);
+        const uint64_t second = measure(benchmark, iterations);
+        return first < second ? first : second;
+    }
+
+    Result runBenchmark(const Benchmark &benchmark, const uint64_t target_ns) {
+        // Double the iterations until one run takes a tenth of the target, then scale to the target
+        uint32_t iterations = 1;
+        uint64_t elapsed_ns = measureBest(benchmark, iterations);
+        while (elapsed_ns < target_ns / 10 && iterations < (1U << 30)) {
+            iterations *= 2;
+            elapsed_ns = measureBest(benchmark, iterations);
+        }
+        if (elapsed_ns > 0) {
+            const uint64_t scaled = static_cast<uint64_t>(iterations) * target_ns / elapsed_ns;
+            iterations = scaled < 1 ? 1 : scaled > (1U << 30) ? (1U << 30) : static_cast<uint32_t>(scaled);
+        }
+
+        constexpr size_t Runs = 5;
+        maxLatency_cycles = 0;
+        double nsPerOp[Runs];
+        for (double &run: nsPerOp) run = static_cast<double>(measure(benchmark, iterations)) / iterations;
+        // Median by insertion sort
+        for (size_t i = 1; i < Runs; i++) {
+            for (size_t j = i; j > 0 && nsPerOp[j - 1] > nsPerOp[j]; j--) {
+                const double swap = nsPerOp[j];
+                nsPerOp[j] = nsPerOp[j - 1];
+                nsPerOp[j - 1] = swap;
+            }
+        }
+        return {iterations, nsPerOp[Runs / 2], Timebase::cyclesToNanos(maxLatency_cycles)};
+    }
+}
+
+int main(const int argc, char *argv[]) {
+    bool json = false;
+    uint64_t target_ns = 20000000;
+    const char *filter = nullptr;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--json") == 0) {
+            json = true;
+        } else if (std::strcmp(argv[i], "--quick") == 0) {
+            target_ns = 2000000;
+        } else if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            filter = argv[++i];
+        } else {
+            fprintf(stderr, "Usage: stm32common_bench [--json] [--quick] [--filter TEXT]\n");
+            return 2;
+        }
+    }
+
+#ifdef LIBSMART_HOST_INSTRUMENTED
+    const char *suite = "stm32common_bench_instrumented";
+#else
+    const char *suite = "stm32common_bench";
+#endif
+
+    Timebase::begin();
+    for (size_t i = 0; i < sizeof(data1k); i++) data1k[i] = static_cast<uint8_t>(i * 31 + 7);
+
+    StdoutPrint out;
+    Serialize::JsonWriter writer(out);
+    if (json) {
+        writer.beginObject();
+        writer.member("suite", suite);
+        writer.member("unit", "ns/op");
+        writer.key("results").beginArray();
+    } else {
+        out.println("benchmark                          iterations      ns/op       MB/s");
+    }
+
+    for (const Benchmark &benchmark: benchmarks) {
+        if (filter != nullptr && std::strstr(benchmark.name, filter) == nullptr) continue;
+        const Result result = runBenchmark(benchmark, target_ns);
+        if (json) {
+            writer.beginObject();
+            writer.member("name", benchmark.name);
+            writer.member("iterations", result.iterations);
+            writer.member("ns_per_op", result.nsPerOp, 3);
+            writer.member("bytes_per_op", static_cast<unsigned int>(benchmark.bytesPerOp));
+            if (result.maxNs > 0) writer.member("max_ns", static_cast<unsigned long>(result.maxNs));
+            writer.endObject();
+        } else {
+            const double mbPerSecond = benchmark.bytesPerOp > 0 && result.nsPerOp > 0
+                                           ? benchmark.bytesPerOp * 1000.0 / result.nsPerOp
+                                           : 0.0;
+            out.printf("%-32s %12lu %10.2f %10.1f", benchmark.name, static_cast<unsigned long>(result.iterations),
+                       result.nsPerOp, mbPerSecond);
+            if (result.maxNs > 0) out.printf("   max %lu ns", static_cast<unsigned long>(result.maxNs));
+            out.print("\n");
+        }
+    }
+
+    if (json) {
+        writer.endArray();
+        writer.endObject();
+        out.println();
+    }
+    out.flush();
+    return json && writer.hasError() ? 1 : 0;
+}
@@ -12,7 +12,15 @@
 #include "main.hpp"
 #include "globals.hpp"
 #include "Helper.hpp"
+#include "Idle.hpp"
 #include "RunEvery.hpp"
+#include "Scheduler.hpp"
+
+
+static Stm32Common::RunEvery blinker(200, []() { HAL_GPIO_TogglePin(LED1_GRN_GPIO_Port, LED1_GRN_Pin); });
+static Stm32Common::Scheduler<4> scheduler;
+static Stm32Common::WfiSleepBackend sleepBackend;
+static Stm32Common::Idle idle(sleepBackend);
 
 
 /**
@@ -23,6 +31,9 @@
 void setup() {
     dummyCpp = 0;
     dummyCandCpp = 0;
+
+    scheduler.add(blinker);
+    idle.setScheduler(&scheduler);
 }
 
 
@@ -36,12 +47,10 @@ void loop() {
     dummyCpp++;
     dummyCandCpp++;
 
-    static Stm32Common::RunEvery blinker;
-
-    if(blinker.loop(200)) {
-        HAL_GPIO_TogglePin(LED1_GRN_GPIO_Port, LED1_GRN_Pin);
-    }
+    scheduler.loop();
 
+    // Sleep until the blinker is due
+    idle.loop();
 }
 
 
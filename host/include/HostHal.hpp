@@ -0,0 +1,56 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef LIBSMART_STM32COMMON_HOST_HOSTHAL_HPP
+#define LIBSMART_STM32COMMON_HOST_HOSTHAL_HPP
+
+#include <cstdint>
+
+namespace Stm32Common::Host {
+    /**
+     * @brief Controls the simulated HAL of a host build.
+     *
+     * By default the tick follows std::chrono::steady_clock. With virtual time, the tick stands still until
+     * advanceTime() or HAL_Delay() is called, so time dependent code can be tested step by step. The SysTick counter
+     * is updated together with the tick, so micros() is consistent with millis(). Timebase counts the nanoseconds of
+     * getTimeNanos(), so it follows the virtual time, too.
+     */
+    class HostHal {
+    public:
+        /**
+         * @brief Switches between real time and virtual time. Virtual time starts at the current time.
+         */
+        static void setVirtualTime(bool enabled);
+
+        [[nodiscard]] static bool isVirtualTime();
+
+        /**
+         * @brief Advances the virtual time [us]. Has no effect with real time.
+         */
+        static void advanceTime(uint64_t duration_us);
+
+        /**
+         * @brief Returns the simulated time since start [us].
+         */
+        [[nodiscard]] static uint64_t getTime();
+
+        /**
+         * @brief Returns the simulated time since start [ns]. The virtual time has a resolution of 1 us.
+         */
+        [[nodiscard]] static uint64_t getTimeNanos();
+
+        /**
+         * @brief Sets the unique device ID returned by HAL_GetUIDw0() to HAL_GetUIDw2().
+         */
+        static void setUid(uint32_t w0, uint32_t w1, uint32_t w2);
+
+        /**
+         * @brief Sets the active exception number, isInIsr() returns true while it is not 0.
+         */
+        static void setActiveIrq(uint32_t exceptionNumber);
+    };
+}
+
+#endif
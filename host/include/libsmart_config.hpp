@@ -0,0 +1,18 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "libsmart_config.dist.hpp"
+
+// The C++ runtime of the host reports uncaught exceptions itself
+#undef LIBSMART_OVERWRITE_verbose_terminate_handler
+
+// The instrumented host library compiles the optional counters, so the tests keep them building and working
+#ifdef LIBSMART_HOST_INSTRUMENTED
+#define LIBSMART_ENABLE_RUNEVERY_STATISTICS
+#define LIBSMART_ENABLE_BUFFER_STATISTICS
+#define LIBSMART_ENABLE_SESSION_STATISTICS
+#define LIBSMART_ENABLE_PROFILER
+#define LIBSMART_ENABLE_TRACE
+#endif
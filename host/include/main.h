@@ -0,0 +1,96 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * Stand-in for the main.h of a STM32CubeMX project on a workstation. It declares the subset of the HAL and CMSIS
+ * that the library uses. The registers are plain variables, HostHal.cpp simulates the tick, the SysTick counter
+ * and the unique device ID.
+ */
+
+#ifndef LIBSMART_STM32COMMON_HOST_MAIN_H
+#define LIBSMART_STM32COMMON_HOST_MAIN_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    HAL_OK = 0x00U,
+    HAL_ERROR = 0x01U,
+    HAL_BUSY = 0x02U,
+    HAL_TIMEOUT = 0x03U
+} HAL_StatusTypeDef;
+
+typedef struct {
+    volatile uint32_t CTRL;
+    volatile uint32_t LOAD;
+    volatile uint32_t VAL;
+    volatile uint32_t CALIB;
+} SysTick_Type;
+
+typedef struct {
+    volatile uint32_t CPUID;
+    volatile uint32_t ICSR;
+} SCB_Type;
+
+typedef struct {
+    volatile uint32_t CTRL;
+    volatile uint32_t CYCCNT;
+} DWT_Type;
+
+typedef struct {
+    volatile uint32_t DEMCR;
+} CoreDebug_Type;
+
+extern SysTick_Type Host_SysTick;
+extern SCB_Type Host_SCB;
+extern DWT_Type Host_DWT;
+extern CoreDebug_Type Host_CoreDebug;
+extern uint16_t Host_FlashSize_kB;
+
+#define SysTick (&Host_SysTick)
+#define SCB (&Host_SCB)
+#define DWT (&Host_DWT)
+#define CoreDebug (&Host_CoreDebug)
+
+#define SCB_ICSR_PENDSTSET_Msk (1UL << 26U)
+#define SCB_ICSR_VECTACTIVE_Msk (0x1FFUL)
+#define CoreDebug_DEMCR_TRCENA_Msk (1UL << 24U)
+#define DWT_CTRL_CYCCNTENA_Msk (1UL)
+#define FLASHSIZE_BASE ((uintptr_t) &Host_FlashSize_kB)
+
+#define TICK_INT_PRIORITY 0U
+#define UNUSED(X) (void)X
+
+#define __NOP() do { } while (0)
+#define __DSB() do { } while (0)
+#define __WFI() do { } while (0)
+#define __enable_irq() do { } while (0)
+#define __disable_irq() do { } while (0)
+
+static inline uint32_t __get_PRIMASK(void) { return 0; }
+
+static inline void __set_PRIMASK(uint32_t priMask) { (void) priMask; }
+
+extern uint32_t SystemCoreClock;
+extern uint32_t uwTickFreq;
+
+uint32_t HAL_GetTick(void);
+void HAL_Delay(uint32_t Delay);
+uint32_t HAL_GetUIDw0(void);
+uint32_t HAL_GetUIDw1(void);
+uint32_t HAL_GetUIDw2(void);
+uint32_t HAL_GetREVID(void);
+uint32_t HAL_GetDEVID(void);
+void Error_Handler(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,108 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "HostHal.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+#include <main.h>
+
+using namespace Stm32Common::Host;
+
+SysTick_Type Host_SysTick = {0, 72000 - 1, 72000 - 1, 0};
+SCB_Type Host_SCB = {0x411FC231, 0};
+DWT_Type Host_DWT = {0, 0};
+CoreDebug_Type Host_CoreDebug = {0};
+uint16_t Host_FlashSize_kB = 64;
+
+uint32_t SystemCoreClock = 72000000;
+uint32_t uwTickFreq = 1;
+
+namespace {
+    const auto startTime = std::chrono::steady_clock::now();
+    bool virtualTime = false;
+    uint64_t virtualTime_us = 0;
+    uint32_t uid[3] = {0x00383132, 0x3436470A, 0x0031FF35};
+
+    uint64_t getRealTimeNanos() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - startTime).count();
+    }
+
+    uint64_t getRealTime() {
+        return getRealTimeNanos() / 1000;
+    }
+
+    /**
+     * Updates the SysTick and the cycle counter registers from the simulated time and returns the tick.
+     */
+    uint32_t updateRegisters(const uint64_t now_us) {
+        const uint32_t cyclesPerMicro = SystemCoreClock >= 1000000 ? SystemCoreClock / 1000000 : 1;
+        Host_SysTick.LOAD = cyclesPerMicro * 1000 - 1;
+        Host_SysTick.VAL = Host_SysTick.LOAD - static_cast<uint32_t>(now_us % 1000) * cyclesPerMicro;
+        Host_DWT.CYCCNT = static_cast<uint32_t>(now_us * cyclesPerMicro);
+        return static_cast<uint32_t>(now_us / 1000);
+    }
+}
+
+void HostHal::setVirtualTime(const bool enabled) {
+    if (enabled && !virtualTime) virtualTime_us = getRealTime();
+    virtualTime = enabled;
+}
+
+bool HostHal::isVirtualTime() {
+    return virtualTime;
+}
+
+void HostHal::advanceTime(const uint64_t duration_us) {
+    if (virtualTime) virtualTime_us += duration_us;
+}
+
+uint64_t HostHal::getTime() {
+    return virtualTime ? virtualTime_us : getRealTime();
+}
+
+uint64_t HostHal::getTimeNanos() {
+    return virtualTime ? virtualTime_us * 1000 : getRealTimeNanos();
+}
+
+void HostHal::setUid(const uint32_t w0, const uint32_t w1, const uint32_t w2) {
+    uid[0] = w0;
+    uid[1] = w1;
+    uid[2] = w2;
+}
+
+void HostHal::setActiveIrq(const uint32_t exceptionNumber) {
+    Host_SCB.ICSR = (Host_SCB.ICSR & ~SCB_ICSR_VECTACTIVE_Msk) | (exceptionNumber & SCB_ICSR_VECTACTIVE_Msk);
+}
+
+
+extern "C" {
+uint32_t HAL_GetTick(void) {
+    return updateRegisters(HostHal::getTime());
+}
+
+void HAL_Delay(const uint32_t Delay) {
+    if (virtualTime) {
+        HostHal::advanceTime(static_cast<uint64_t>(Delay) * 1000);
+    } else {
+        std::this_thread::sleep_for(std::chrono::milliseconds(Delay));
+    }
+}
+
+uint32_t HAL_GetUIDw0(void) { return uid[0]; }
+
+uint32_t HAL_GetUIDw1(void) { return uid[1]; }
+
+uint32_t HAL_GetUIDw2(void) { return uid[2]; }
+
+uint32_t HAL_GetREVID(void) { return 0x2000; }
+
+uint32_t HAL_GetDEVID(void) { return 0x410; }
+
+void Error_Handler(void) {
+    std::abort();
+}
+}
@@ -0,0 +1,55 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "Coroutine.hpp"
+
+#ifdef LIBSMART_HAS_COROUTINES
+
+using namespace Stm32Common;
+
+static_assert(LIBSMART_COROUTINE_FRAMES > 0 && LIBSMART_COROUTINE_FRAMES <= 32,
+              "FramePool supports 1 to 32 frames");
+static_assert(LIBSMART_COROUTINE_FRAME_SIZE % alignof(std::max_align_t) == 0,
+              "LIBSMART_COROUTINE_FRAME_SIZE must be a multiple of the maximum alignment");
+
+namespace {
+    alignas(std::max_align_t) uint8_t frames[LIBSMART_COROUTINE_FRAMES][LIBSMART_COROUTINE_FRAME_SIZE];
+    uint32_t usedFrames = 0; // One bit per frame
+    size_t largestFrameSize = 0;
+    uint32_t failCount = 0;
+}
+
+void *FramePool::allocate(const size_t size) noexcept {
+    if (size > largestFrameSize) largestFrameSize = size;
+    if (size <= LIBSMART_COROUTINE_FRAME_SIZE) {
+        for (size_t i = 0; i < LIBSMART_COROUTINE_FRAMES; i++) {
+            if ((usedFrames & (1UL << i)) == 0) {
+                usedFrames |= 1UL << i;
+                return frames[i];
+            }
+        }
+    }
+    failCount++;
+    return nullptr;
+}
+
+void FramePool::deallocate(void *frame) noexcept {
+    const size_t i = (static_cast<uint8_t *>(frame) - frames[0]) / LIBSMART_COROUTINE_FRAME_SIZE;
+    if (i < LIBSMART_COROUTINE_FRAMES) usedFrames &= ~(1UL << i);
+}
+
+size_t FramePool::getFreeFrames() {
+    return LIBSMART_COROUTINE_FRAMES - __builtin_popcount(usedFrames);
+}
+
+size_t FramePool::getLargestFrameSize() {
+    return largestFrameSize;
+}
+
+uint32_t FramePool::getFailCount() {
+    return failCount;
+}
+
+#endif
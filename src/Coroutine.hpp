@@ -0,0 +1,159 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef LIBSMART_STM32COMMON_COROUTINE_HPP
+#define LIBSMART_STM32COMMON_COROUTINE_HPP
+
+#include <libsmart_config.hpp>
+
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L
+#define LIBSMART_HAS_COROUTINES
+
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <main.h>
+
+#ifndef LIBSMART_COROUTINE_FRAME_SIZE
+#define LIBSMART_COROUTINE_FRAME_SIZE 128
+#endif
+
+#ifndef LIBSMART_COROUTINE_FRAMES
+#define LIBSMART_COROUTINE_FRAMES 8
+#endif
+
+namespace Stm32Common {
+    /**
+     * @brief Static pool of LIBSMART_COROUTINE_FRAMES frames of LIBSMART_COROUTINE_FRAME_SIZE bytes each.
+     *
+     * All frames of Task coroutines come from this pool, never from the heap. A coroutine whose frame is larger
+     * than a slot or that finds the pool empty is not started, see Task::isValid(). getLargestFrameSize() tells
+     * how large the slots have to be for the coroutines of the firmware.
+     *
+     * The pool is not protected against interrupts, coroutines must only be created by the main loop or a single
+     * thread.
+     */
+    class FramePool {
+    public:
+        static void *allocate(size_t size) noexcept;
+
+        static void deallocate(void *frame) noexcept;
+
+        [[nodiscard]] static size_t getFreeFrames();
+
+        /**
+         * @brief Returns the largest frame that has been requested, including failed requests [bytes].
+         */
+        [[nodiscard]] static size_t getLargestFrameSize();
+
+        /**
+         * @brief Returns the number of coroutines that could not be started.
+         */
+        [[nodiscard]] static uint32_t getFailCount();
+    };
+
+
+    /**
+     * @brief Return type of a coroutine whose frame comes from the FramePool.
+     *
+     * The coroutine starts suspended and is resumed by its owner, e.g. CoroutineStreamSession. A Task can be
+     * awaited by another coroutine, which then continues when the awaited Task has finished. The Task owns the
+     * frame, destroying the Task destroys the coroutine.
+     *
+     * @code
+     * Stm32Common::Task LoginSession::sendPrompt() {
+     *     co_await txAvailable(2);
+     *     print("> ");
+     * }
+     * @endcode
+     */
+    class Task {
+    public:
+        struct promise_type;
+        using handle_t = std::coroutine_handle<promise_type>;
+
+        struct FinalAwaiter {
+            static bool await_ready() noexcept { return false; }
+
+            static std::coroutine_handle<> await_suspend(const handle_t handle) noexcept {
+                const std::coroutine_handle<> continuation = handle.promise().continuation;
+                return continuation ? continuation : std::noop_coroutine();
+            }
+
+            static void await_resume() noexcept { ; }
+        };
+
+        struct promise_type {
+            std::coroutine_handle<> continuation;
+
+            static void *operator new(const size_t size) noexcept { return FramePool::allocate(size); }
+
+            static void operator delete(void *frame) noexcept { FramePool::deallocate(frame); }
+
+            static Task get_return_object_on_allocation_failure() noexcept { return Task(); }
+
+            Task get_return_object() noexcept { return Task(handle_t::from_promise(*this)); }
+
+            static std::suspend_always initial_suspend() noexcept { return {}; }
+
+            static FinalAwaiter final_suspend() noexcept { return {}; }
+
+            static void return_void() noexcept { ; }
+
+            static void unhandled_exception() { Error_Handler(); }
+        };
+
+        Task() = default;
+
+        Task(Task &&other) noexcept : handle(other.handle) { other.handle = {}; }
+
+        Task &operator=(Task &&other) noexcept {
+            if (this != &other) {
+                if (handle) handle.destroy();
+                handle = other.handle;
+                other.handle = {};
+            }
+            return *this;
+        }
+
+        Task(const Task &) = delete;
+
+        Task &operator=(const Task &) = delete;
+
+        ~Task() { if (handle) handle.destroy(); }
+
+        /**
+         * @brief Returns false if the coroutine could not be started because the FramePool had no fitting frame.
+         */
+        [[nodiscard]] bool isValid() const { return static_cast<bool>(handle); }
+
+        [[nodiscard]] bool isDone() const { return !handle || handle.done(); }
+
+        [[nodiscard]] std::coroutine_handle<> getHandle() const { return handle; }
+
+        // Awaiting a Task starts it and continues the awaiting coroutine when it has finished. A Task that could
+        // not be started is a configuration error of the FramePool.
+        [[nodiscard]] bool await_ready() const noexcept {
+            if (!handle) Error_Handler();
+            return handle.done();
+        }
+
+        std::coroutine_handle<> await_suspend(const std::coroutine_handle<> awaiting) noexcept {
+            handle.promise().continuation = awaiting;
+            return handle;
+        }
+
+        static void await_resume() noexcept { ; }
+
+    private:
+        explicit Task(const handle_t handle) : handle(handle) { ; }
+
+        handle_t handle;
+    };
+}
+
+#endif
+
+#endif
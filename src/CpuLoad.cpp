@@ -0,0 +1,76 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "CpuLoad.hpp"
+#include "Print.hpp"
+
+using namespace Stm32Common;
+
+namespace {
+    size_t printPermille(Print &out, const uint16_t permille) {
+        size_t n = out.print(static_cast<uint32_t>(permille / 10));
+        n += out.print('.');
+        n += out.print(static_cast<uint32_t>(permille % 10));
+        return n + out.print('%');
+    }
+}
+
+void CpuLoad::begin(const uint32_t now_cycles) {
+    setWindow(window_ms);
+    windowStart_cycles = now_cycles;
+    idle_cycles = 0;
+    idle = false;
+    load_permille = 0;
+    clear();
+}
+
+void CpuLoad::setWindow(const uint32_t window_ms) {
+    this->window_ms = window_ms;
+    const uint64_t cycles = Timebase::microsToCycles(static_cast<uint64_t>(window_ms) * 1000U);
+    window_cycles = cycles > UINT32_MAX ? UINT32_MAX : static_cast<uint32_t>(cycles);
+}
+
+void CpuLoad::update(const uint32_t now_cycles) {
+    // An idle time that is still running is split between this window and the next one
+    if (idle) {
+        idle_cycles += now_cycles - idleStart_cycles;
+        idleStart_cycles = now_cycles;
+    }
+
+    const uint32_t elapsed_cycles = now_cycles - windowStart_cycles;
+    if (elapsed_cycles == 0) return;
+    const uint32_t busy_cycles = idle_cycles < elapsed_cycles ? elapsed_cycles - idle_cycles : 0;
+
+    load_permille = static_cast<uint16_t>(static_cast<uint64_t>(busy_cycles) * 1000U / elapsed_cycles);
+    if (load_permille > peak_permille) peak_permille = load_permille;
+    windows++;
+    totalBusy_cycles += busy_cycles;
+    total_cycles += elapsed_cycles;
+
+    windowStart_cycles = now_cycles;
+    idle_cycles = 0;
+}
+
+uint16_t CpuLoad::getAverageLoad_permille() const {
+    if (total_cycles == 0) return 0;
+    return static_cast<uint16_t>(totalBusy_cycles * 1000U / total_cycles);
+}
+
+void CpuLoad::clear() {
+    peak_permille = 0;
+    windows = 0;
+    totalBusy_cycles = 0;
+    total_cycles = 0;
+}
+
+size_t CpuLoad::printTo(Print &printObject) const {
+    size_t n = printObject.print("load ");
+    n += printPermille(printObject, load_permille);
+    n += printObject.print(", average ");
+    n += printPermille(printObject, getAverageLoad_permille());
+    n += printObject.print(", peak ");
+    n += printPermille(printObject, peak_permille);
+    return n;
+}
@@ -0,0 +1,148 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef LIBSMART_STM32COMMON_CPULOAD_HPP
+#define LIBSMART_STM32COMMON_CPULOAD_HPP
+
+#include <libsmart_config.hpp>
+#include <cstdint>
+#include "Printable.hpp"
+#include "Timebase.hpp"
+
+namespace Stm32Common {
+    /**
+     * @brief Measures the CPU load as the share of time spent outside idle.
+     *
+     * The idle time is accumulated in cycles of the Timebase between idleBegin() and idleEnd(), which costs one
+     * cycle counter read and a few instructions each. Idle calls them around the sleep if setCpuLoad() has been
+     * used, an idle spin can call them itself. Interrupts served during the idle time count as idle.
+     *
+     * At the end of every window, the load of the window becomes the current load, the peak load is updated and
+     * the window is added to the average load. The window is closed by loop() in the main loop, or by update()
+     * from a RunEvery object with the interval of the window. A window must be shorter than 2^32 cycles (59 s at
+     * 72 MHz).
+     *
+     * @code
+     * Stm32Common::CpuLoad cpuLoad(1000);
+     * Stm32Common::Idle idle(sleepBackend);
+     *
+     * void setup() {
+     *     Stm32Common::Timebase::begin();
+     *     cpuLoad.begin();
+     *     idle.setCpuLoad(&cpuLoad);
+     * }
+     *
+     * void loop() {
+     *     scheduler.loop();
+     *     cpuLoad.loop();
+     *     idle.loop();
+     * }
+     * @endcode
+     *
+     * Every method has an overload that takes the cycle counter, e.g. to run on a virtual clock in tests.
+     */
+    class CpuLoad : public Printable {
+    public:
+        explicit CpuLoad(const uint32_t window_ms = 1000) : window_ms(window_ms) { ; }
+
+        /**
+         * @brief Starts the first window. Call this after Timebase::begin(), the window length depends on the
+         * cycle counter frequency.
+         */
+        void begin() { begin(Timebase::getCycles32()); }
+
+        void begin(uint32_t now_cycles);
+
+        /**
+         * @brief Sets the window length [ms].
+         */
+        void setWindow(uint32_t window_ms);
+
+        [[nodiscard]] uint32_t getWindow() const { return window_ms; }
+
+        /**
+         * @brief Marks the begin of the idle time.
+         */
+        void idleBegin() { idleBegin(Timebase::getCycles32()); }
+
+        void idleBegin(const uint32_t now_cycles) {
+            idleStart_cycles = now_cycles;
+            idle = true;
+        }
+
+        /**
+         * @brief Marks the end of the idle time.
+         */
+        void idleEnd() { idleEnd(Timebase::getCycles32()); }
+
+        void idleEnd(const uint32_t now_cycles) {
+            if (!idle) return;
+            idle_cycles += now_cycles - idleStart_cycles;
+            idle = false;
+        }
+
+        /**
+         * @brief Closes the window if it has passed.
+         *
+         * @return true if a window has been closed.
+         */
+        bool loop() { return loop(Timebase::getCycles32()); }
+
+        bool loop(const uint32_t now_cycles) {
+            if (now_cycles - windowStart_cycles < window_cycles) return false;
+            update(now_cycles);
+            return true;
+        }
+
+        /**
+         * @brief Closes the window now, regardless of its length.
+         */
+        void update() { update(Timebase::getCycles32()); }
+
+        void update(uint32_t now_cycles);
+
+        /**
+         * @brief Returns the load of the last window [1/1000].
+         */
+        [[nodiscard]] uint16_t getLoad_permille() const { return load_permille; }
+
+        /**
+         * @brief Returns the load of all windows since begin() or clear() [1/1000].
+         */
+        [[nodiscard]] uint16_t getAverageLoad_permille() const;
+
+        /**
+         * @brief Returns the highest load of a window since begin() or clear() [1/1000].
+         */
+        [[nodiscard]] uint16_t getPeakLoad_permille() const { return peak_permille; }
+
+        /**
+         * @brief Returns the number of windows since begin() or clear().
+         */
+        [[nodiscard]] uint32_t getWindowCount() const { return windows; }
+
+        /**
+         * @brief Resets the average and the peak load.
+         */
+        void clear();
+
+        size_t printTo(Print &printObject) const override;
+
+    private:
+        uint32_t window_ms;
+        uint32_t window_cycles = UINT32_MAX;
+        uint32_t windowStart_cycles = 0;
+        uint32_t idleStart_cycles = 0;
+        uint32_t idle_cycles = 0;
+        bool idle = false;
+        uint16_t load_permille = 0;
+        uint16_t peak_permille = 0;
+        uint32_t windows = 0;
+        uint64_t totalBusy_cycles = 0;
+        uint64_t total_cycles = 0;
+    };
+}
+
+#endif
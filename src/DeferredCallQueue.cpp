@@ -0,0 +1,68 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "DeferredCallQueue.hpp"
+#include "Idle.hpp"
+
+using namespace Stm32Common;
+
+DeferredCallQueueBase::DeferredCallQueueBase(Slot *slots, const size_t capacity)
+    : slots(slots), mask(static_cast<uint32_t>(capacity - 1)) {
+    // The sequence of a slot equals the position that may be posted to it next
+    for (uint32_t i = 0; i < capacity; i++) {
+        slots[i].sequence.store(i, std::memory_order_relaxed);
+        slots[i].fn = nullptr;
+        slots[i].context = nullptr;
+    }
+}
+
+bool DeferredCallQueueBase::post(const fn_t fn, void *context) {
+    if (fn == nullptr) return false;
+
+    uint32_t pos = head.load(std::memory_order_relaxed);
+    Slot *slot;
+    for (;;) {
+        slot = &slots[pos & mask];
+        const auto diff = static_cast<int32_t>(slot->sequence.load(std::memory_order_acquire) - pos);
+        if (diff == 0) {
+            if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+        } else if (diff < 0) {
+            // The slot still holds the call of the previous round
+            dropCount.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        } else {
+            pos = head.load(std::memory_order_relaxed);
+        }
+    }
+
+    slot->fn = fn;
+    slot->context = context;
+    slot->sequence.store(pos + 1, std::memory_order_release);
+
+    const uint32_t length = pos + 1 - tail.load(std::memory_order_relaxed);
+    uint32_t high = highWater.load(std::memory_order_relaxed);
+    while (length > high && !highWater.compare_exchange_weak(high, length, std::memory_order_relaxed)) { ; }
+
+    if (Idle *const i = idle) i->wakeUp();
+    return true;
+}
+
+size_t DeferredCallQueueBase::drain(const size_t maxCalls) {
+    size_t n = 0;
+    uint32_t pos = tail.load(std::memory_order_relaxed);
+    while (n < maxCalls) {
+        Slot &slot = slots[pos & mask];
+        if (slot.sequence.load(std::memory_order_acquire) != pos + 1) break;
+        const fn_t fn = slot.fn;
+        void *const context = slot.context;
+
+        // Release the slot before the call, so the call can post again
+        slot.sequence.store(pos + mask + 1, std::memory_order_release);
+        tail.store(++pos, std::memory_order_relaxed);
+        fn(context);
+        n++;
+    }
+    return n;
+}
@@ -0,0 +1,137 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef LIBSMART_STM32COMMON_DEFERREDCALLQUEUE_HPP
+#define LIBSMART_STM32COMMON_DEFERREDCALLQUEUE_HPP
+
+#include <libsmart_config.hpp>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace Stm32Common {
+    class Idle;
+
+    /**
+     * @brief Queue of function calls that are posted by ISRs and executed later by the main loop or a thread.
+     *
+     * This is the size independent part of DeferredCallQueue.
+     *
+     * A call is a plain function pointer and a context pointer, so posting never allocates. post() is lock-free
+     * and can be called from any number of ISRs and threads, also when they preempt each other. drain() must
+     * only be called by a single consumer.
+     *
+     * A post() that is interrupted between reserving and filling its slot delays the calls behind it until the
+     * interrupted post() has finished. drain() stops at such a slot instead of waiting for it.
+     *
+     * @see DeferredCallQueue
+     */
+    class DeferredCallQueueBase {
+    public:
+        using fn_t = void (*)(void *context);
+
+        DeferredCallQueueBase(const DeferredCallQueueBase &) = delete;
+
+        DeferredCallQueueBase &operator=(const DeferredCallQueueBase &) = delete;
+
+        /**
+         * @brief Posts a call. This method can be called from an ISR.
+         *
+         * @param fn The function to call.
+         * @param context The argument of the function.
+         * @return true if the call has been queued, false if the queue is full.
+         */
+        bool post(fn_t fn, void *context = nullptr);
+
+        /**
+         * @brief Executes queued calls in the order they have been posted.
+         *
+         * @param maxCalls The maximum number of calls to execute.
+         * @return The number of executed calls.
+         */
+        size_t drain(size_t maxCalls = SIZE_MAX);
+
+        [[nodiscard]] bool isEmpty() const { return getLength() == 0; }
+
+        /**
+         * @brief Returns the number of queued calls, including calls whose post() has not finished yet.
+         */
+        [[nodiscard]] size_t getLength() const {
+            return head.load(std::memory_order_relaxed) - tail.load(std::memory_order_relaxed);
+        }
+
+        [[nodiscard]] size_t getCapacity() const { return mask + 1; }
+
+        /**
+         * @brief Returns the number of calls that have been rejected because the queue was full.
+         */
+        [[nodiscard]] uint32_t getDropCount() const { return dropCount.load(std::memory_order_relaxed); }
+
+        /**
+         * @brief Returns the highest number of queued calls since the last clearStatistics().
+         */
+        [[nodiscard]] size_t getHighWater() const { return highWater.load(std::memory_order_relaxed); }
+
+        void clearStatistics() {
+            dropCount.store(0, std::memory_order_relaxed);
+            highWater.store(0, std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Sets the Idle whose sleep is ended by post(). nullptr removes the Idle.
+         */
+        void setIdle(Idle *idle) { this->idle = idle; }
+
+    protected:
+        struct Slot {
+            std::atomic<uint32_t> sequence;
+            fn_t fn;
+            void *context;
+        };
+
+        DeferredCallQueueBase(Slot *slots, size_t capacity);
+
+        ~DeferredCallQueueBase() = default;
+
+    private:
+        Slot *slots;
+        uint32_t mask;
+        std::atomic<uint32_t> head{0}; // Position of the next post()
+        std::atomic<uint32_t> tail{0}; // Position of the next call, only written by drain()
+        std::atomic<uint32_t> dropCount{0};
+        std::atomic<uint32_t> highWater{0};
+        Idle *idle = nullptr;
+    };
+
+
+    /**
+     * @brief DeferredCallQueue with room for Slots calls.
+     *
+     * @code
+     * Stm32Common::DeferredCallQueue<16> deferredCalls;
+     *
+     * void HAL_GPIO_EXTI_Callback(uint16_t pin) {
+     *     deferredCalls.post([](void *context) { static_cast<Button *>(context)->onPress(); }, &button);
+     * }
+     *
+     * void loop() {
+     *     deferredCalls.drain();
+     *     idle.loop();
+     * }
+     * @endcode
+     */
+    template<size_t Slots>
+    class DeferredCallQueue final : public DeferredCallQueueBase {
+        static_assert(Slots >= 2 && (Slots & (Slots - 1)) == 0, "DeferredCallQueue needs a power of two slots");
+
+    public:
+        DeferredCallQueue() : DeferredCallQueueBase(slots, Slots) { ; }
+
+    private:
+        Slot slots[Slots];
+    };
+}
+
+#endif
@@ -36,14 +36,34 @@ unsigned long millis() {
  * @brief Get the current micros value.
  *
  * This function returns the number of microseconds since the device was powered on or reset.
+ * The tick counter and the SysTick counter are read until they are consistent, so the value never goes backwards
+ * at a tick rollover. A SysTick interrupt that is pending, because interrupts are masked, is taken into account.
  *
  * @return The current micros value.
  */
-uint64_t micros() {
-    uint64_t micros = HAL_GetTick() * 1000; // Millisekunden in Mikrosekunden umrechnen
-    micros += (SysTick->LOAD - SysTick->VAL) /
-            (SystemCoreClock / 1000000); // Zeit seit dem letzten Millisekunden-Überlauf hinzufügen
-    return micros;
+unsigned long long micros() {
+    // SystemCoreClock only changes when the clock tree is reconfigured, so the division is cached
+    static uint32_t cachedCoreClock = 0;
+    static uint32_t cyclesPerMicro = 1;
+    if (cachedCoreClock != SystemCoreClock) {
+        cachedCoreClock = SystemCoreClock;
+        cyclesPerMicro = SystemCoreClock >= 1000000 ? SystemCoreClock / 1000000 : 1;
+    }
+
+    uint32_t ticks;
+    uint32_t value;
+    bool pending;
+    do {
+        ticks = HAL_GetTick();
+        value = SysTick->VAL;
+        pending = (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) != 0;
+    } while (ticks != HAL_GetTick());
+
+    // The counter has reloaded, but the interrupt has not incremented the tick yet. The tick counts milliseconds
+    // and the interrupt adds uwTickFreq to it.
+    if (pending && value > SysTick->LOAD / 2) ticks += uwTickFreq;
+
+    return ticks * 1000ULL + (SysTick->LOAD - value) / cyclesPerMicro;
 }
 
 
@@ -0,0 +1,172 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <algorithm>
+#include "Hexdump.hpp"
+
+using namespace Stm32Common;
+
+namespace {
+    constexpr char hexDigitsLower[] = "0123456789abcdef";
+    constexpr char hexDigitsUpper[] = "0123456789ABCDEF";
+}
+
+Hexdump::Hexdump(const void *data, size_t size)
+    : Hexdump(data, size, Options()) {
+}
+
+Hexdump::Hexdump(const void *data, size_t size, const Options &options)
+    : data(static_cast<const uint8_t *>(data)),
+      size(data == nullptr ? 0 : size),
+      options(options) {
+    this->options.bytesPerLine = std::clamp<uint8_t>(options.bytesPerLine, 1,
+                                                     LIBSMART_STM32COMMON_HEXDUMP_MAX_BYTES_PER_LINE);
+}
+
+size_t Hexdump::getLineLength() const {
+    return getLineLength(options.bytesPerLine);
+}
+
+size_t Hexdump::getLineLength(const size_t bytesInLine) const {
+    // Width of the hex column: two digits per byte, one separator between bytes, one extra space per group
+    const auto hexWidth = [this](const size_t bytes) -> size_t {
+        if (bytes == 0) return 0;
+        return bytes * 3 - 1 + (options.groupSize > 0 ? (bytes - 1) / options.groupSize : 0);
+    };
+
+    size_t len = options.showOffset ? 10 : 0;
+    if (options.showAscii) {
+        len += hexWidth(options.bytesPerLine) + 3 + bytesInLine + 1;
+    } else {
+        len += hexWidth(bytesInLine);
+    }
+    return len + 2;
+}
+
+size_t Hexdump::formatLine(char *out, const size_t from, const size_t bytesInLine) const {
+    const char *digits = options.upperCase ? hexDigitsUpper : hexDigitsLower;
+    const uint8_t *line = data + from;
+    char *p = out;
+
+    if (options.showOffset) {
+        const uint32_t offset = options.baseOffset + static_cast<uint32_t>(from);
+        for (int shift = 28; shift >= 0; shift -= 4) {
+            *p++ = digits[(offset >> shift) & 0x0f];
+        }
+        *p++ = ' ';
+        *p++ = ' ';
+    }
+
+    const size_t columns = options.showAscii ? options.bytesPerLine : bytesInLine;
+    for (size_t i = 0; i < columns; i++) {
+        if (i > 0) {
+            *p++ = ' ';
+            if (options.groupSize > 0 && i % options.groupSize == 0) *p++ = ' ';
+        }
+        if (i < bytesInLine) {
+            *p++ = digits[line[i] >> 4];
+            *p++ = digits[line[i] & 0x0f];
+        } else {
+            *p++ = ' ';
+            *p++ = ' ';
+        }
+    }
+
+    if (options.showAscii) {
+        *p++ = ' ';
+        *p++ = ' ';
+        *p++ = '|';
+        for (size_t i = 0; i < bytesInLine; i++) {
+            *p++ = line[i] >= 0x20 && line[i] < 0x7f ? static_cast<char>(line[i]) : '.';
+        }
+        *p++ = '|';
+    }
+
+    *p++ = '\r';
+    *p++ = '\n';
+    return p - out;
+}
+
+void Hexdump::advance(size_t characters) {
+    while (characters > 0 && !isDone()) {
+        const size_t bytesInLine = std::min(size - position, static_cast<size_t>(options.bytesPerLine));
+        const size_t rest = getLineLength(bytesInLine) - lineOffset;
+        if (characters < rest) {
+            lineOffset += characters;
+            return;
+        }
+        characters -= rest;
+        position += bytesInLine;
+        lineOffset = 0;
+    }
+}
+
+size_t Hexdump::dump(Print &printObject) {
+    char line[10 + LIBSMART_STM32COMMON_HEXDUMP_MAX_BYTES_PER_LINE * 5 + 8];
+    size_t written = 0;
+
+#ifdef LIBSMART_ENABLE_DIRECT_BUFFER_WRITE
+    uint8_t *buffer;
+    const size_t szBuffer = printObject.getWriteBuffer(buffer);
+    if (buffer == nullptr) return 0;
+    auto *out = reinterpret_cast<char *>(buffer);
+
+    // Format from a copy of the position, the position advances by what the device accepts
+    size_t from = position;
+    size_t offset = lineOffset;
+    while (from < size && written < szBuffer) {
+        const size_t bytesInLine = std::min(size - from, static_cast<size_t>(options.bytesPerLine));
+        const size_t len = getLineLength(bytesInLine);
+        if (offset == 0 && written + len <= szBuffer) {
+            written += formatLine(out + written, from, bytesInLine);
+            from += bytesInLine;
+            continue;
+        }
+        // Whole lines only, unless not even the rest of the first line fits
+        if (written > 0) break;
+        formatLine(line, from, bytesInLine);
+        const size_t n = std::min(len - offset, szBuffer);
+        std::copy_n(line + offset, n, out);
+        written = n;
+        if (offset + n < len) break;
+        offset = 0;
+        from += bytesInLine;
+    }
+    if (written > 0) {
+        written = printObject.setWrittenBytes(written);
+        advance(written);
+    }
+#else
+    while (!isDone()) {
+        const int space = printObject.availableForWrite();
+        if (space <= 0) break;
+        const size_t bytesInLine = std::min(size - position, static_cast<size_t>(options.bytesPerLine));
+        const size_t rest = getLineLength(bytesInLine) - lineOffset;
+        // Whole lines only, unless not even the rest of the first line fits
+        if (rest > static_cast<size_t>(space) && written > 0) break;
+        formatLine(line, position, bytesInLine);
+        const size_t n = std::min(rest, static_cast<size_t>(space));
+        const size_t accepted = printObject.write(line + lineOffset, n);
+        written += accepted;
+        advance(accepted);
+        if (accepted < n) break;
+    }
+#endif
+
+    return written;
+}
+
+size_t Hexdump::printTo(Print &printObject) const {
+    Hexdump hexdump(*this);
+    hexdump.rewind();
+
+    size_t written = 0;
+    while (!hexdump.isDone()) {
+        const size_t n = hexdump.dump(printObject);
+        if (n == 0) break;
+        written += n;
+    }
+    return written;
+}
@@ -0,0 +1,124 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef LIBSMART_STM32COMMON_HEXDUMP_HPP
+#define LIBSMART_STM32COMMON_HEXDUMP_HPP
+
+#include <libsmart_config.hpp>
+#include <cstddef>
+#include <cstdint>
+#include "Print.hpp"
+#include "Printable.hpp"
+
+#define LIBSMART_STM32COMMON_HEXDUMP_MAX_BYTES_PER_LINE 32
+
+namespace Stm32Common {
+    /**
+     * @brief Formats binary data as a classic hexdump and writes it to a Print object.
+     *
+     * Each line looks like this (offset column, hex column with grouping, ASCII column):
+     * @code
+     * 00000000  48 65 6c 6c 6f 2c 20 57  6f 72 6c 64 21 0d 0a 00  |Hello, World!...|
+     * @endcode
+     *
+     * Lines are written whole as long as they fit. When the underlying device runs out of space, dump() returns and
+     * remembers the position, so the next call to dump() resumes with the first line that did not fit. If not even
+     * one line fits, the part that fits is written and the next calls complete the line, so a device smaller than
+     * a line still makes progress.
+     * With LIBSMART_ENABLE_DIRECT_BUFFER_WRITE, all lines that fit are formatted straight into the write buffer of
+     * the device and committed with a single setWrittenBytes().
+     *
+     * @code
+     * Stm32Common::Hexdump dump(rxFrame, rxFrameLength);
+     * while (!dump.isDone()) {
+     *     dump.dump(*session);
+     *     // ... let the session drain its tx buffer
+     * }
+     * @endcode
+     */
+    class Hexdump : public Printable {
+    public:
+        struct Options {
+            /** Value printed in the offset column for the first byte, e.g. the flash address. */
+            uint32_t baseOffset = 0;
+            /** Number of bytes per line, limited to LIBSMART_STM32COMMON_HEXDUMP_MAX_BYTES_PER_LINE. */
+            uint8_t bytesPerLine = 16;
+            /** Insert an additional space after every groupSize bytes. 0 disables grouping. */
+            uint8_t groupSize = 8;
+            /** Print the offset column. */
+            bool showOffset = true;
+            /** Print the ASCII column. */
+            bool showAscii = true;
+            /** Use upper case hex digits. */
+            bool upperCase = false;
+        };
+
+        Hexdump(const void *data, size_t size);
+
+        Hexdump(const void *data, size_t size, const Options &options);
+
+        /**
+         * @brief Writes as many complete lines as fit into the given Print object, or a part of a line if not
+         * even one line fits.
+         *
+         * @param printObject The Print object to write to.
+         * @return The number of bytes written to the Print object.
+         */
+        size_t dump(Print &printObject);
+
+        /**
+         * @brief Writes the complete hexdump from the beginning.
+         *
+         * The resume position of this object is not changed.
+         *
+         * @param printObject The Print object to write to.
+         * @return The number of bytes written to the Print object.
+         */
+        size_t printTo(Print &printObject) const override;
+
+        /**
+         * @brief Checks if all data has been dumped.
+         *
+         * @return True if all lines have been written, false otherwise.
+         */
+        [[nodiscard]] bool isDone() const { return position >= size; }
+
+        /**
+         * @brief Returns the number of data bytes that have been dumped so far.
+         */
+        [[nodiscard]] size_t getPosition() const { return position; }
+
+        /**
+         * @brief Restarts the dump from the first byte.
+         */
+        void rewind() {
+            position = 0;
+            lineOffset = 0;
+        }
+
+        /**
+         * @brief Returns the length of a full line in characters, including the line break.
+         */
+        [[nodiscard]] size_t getLineLength() const;
+
+    private:
+        size_t getLineLength(size_t bytesInLine) const;
+
+        size_t formatLine(char *out, size_t from, size_t bytesInLine) const;
+
+        /**
+         * @brief Advances the position by the given number of characters of output.
+         */
+        void advance(size_t characters);
+
+        const uint8_t *data;
+        size_t size;
+        size_t position = 0;
+        size_t lineOffset = 0; // Characters of the line at position that have been written already
+        Options options;
+    };
+}
+
+#endif
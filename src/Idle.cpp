@@ -0,0 +1,42 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <algorithm>
+#include "Idle.hpp"
+#include "CpuLoad.hpp"
+
+using namespace Stm32Common;
+
+void Idle::setSessionManager(WakeSourceInterface *sessionManager) {
+    if (this->sessionManager != nullptr) this->sessionManager->setIdle(nullptr);
+    this->sessionManager = sessionManager;
+    if (sessionManager != nullptr) sessionManager->setIdle(this);
+}
+
+uint32_t Idle::getSleepTime() {
+    if (wakeUpRequested || (sessionManager != nullptr && sessionManager->hasWork())) return 0;
+    if (scheduler == nullptr) return maxSleep_ms;
+    return std::min(maxSleep_ms, scheduler->getTimeUntilNextDeadline(backend.getTime()));
+}
+
+bool Idle::loop() {
+    // A wake-up that arrived while the main loop was busy means there is work to do
+    if (wakeUpRequested) {
+        wakeUpRequested = false;
+        return false;
+    }
+
+    const uint32_t duration_ms = getSleepTime();
+    if (duration_ms == 0) return false;
+
+    const uint32_t start = backend.getTime();
+    if (cpuLoad != nullptr) cpuLoad->idleBegin();
+    backend.sleep(duration_ms, wakeUpRequested);
+    if (cpuLoad != nullptr) cpuLoad->idleEnd();
+    wakeUpRequested = false;
+    sleepCount++;
+    sleptTime += backend.getTime() - start;
+    return true;
+}
@@ -0,0 +1,112 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef LIBSMART_STM32COMMON_IDLE_HPP
+#define LIBSMART_STM32COMMON_IDLE_HPP
+
+#include <libsmart_config.hpp>
+#include <cstdint>
+#include "SchedulerInterface.hpp"
+#include "SleepBackend.hpp"
+#include "WakeSourceInterface.hpp"
+
+namespace Stm32Common {
+    class CpuLoad;
+
+    /**
+     * @brief Sleeps at the end of the main loop until there is work to do.
+     *
+     * The sleep time is the time until the next deadline of the scheduler, limited by the maximum sleep time.
+     * Idle does not sleep at all if a session of the session manager is ready, and a session that becomes ready
+     * ends the sleep.
+     * An ISR that produces work for the main loop should call wakeUp() to end the sleep early.
+     *
+     * @code
+     * Stm32Common::Scheduler<8> scheduler;
+     * Stm32Common::WfiSleepBackend sleepBackend;
+     * Stm32Common::Idle idle(sleepBackend);
+     *
+     * void setup() {
+     *     idle.setScheduler(&scheduler);
+     *     idle.setSessionManager(&sessionManager);
+     * }
+     *
+     * void loop() {
+     *     scheduler.loop();
+     *     sessionManager.loop();
+     *     idle.loop();
+     * }
+     * @endcode
+     */
+    class Idle {
+    public:
+        explicit Idle(SleepBackendInterface &backend) : backend(backend) { ; }
+
+        /**
+         * @brief Sets the scheduler, whose next deadline ends the sleep. nullptr removes the scheduler.
+         */
+        void setScheduler(SchedulerInterface *scheduler) { this->scheduler = scheduler; }
+
+        /**
+         * @brief Sets the session manager, whose sessions prevent sleeping while they are ready. A session that
+         * becomes ready also ends the sleep. nullptr removes the session manager.
+         *
+         * Any other WakeSourceInterface can be passed, too.
+         */
+        void setSessionManager(WakeSourceInterface *sessionManager);
+
+        /**
+         * @brief Sets the CPU load meter, whose idle time is the time spent in the backend. nullptr removes the
+         * meter.
+         */
+        void setCpuLoad(CpuLoad *cpuLoad) { this->cpuLoad = cpuLoad; }
+
+        /**
+         * @brief Sets the maximum time of a single sleep [ms].
+         *
+         * Use this if the main loop has to poll something that cannot call wakeUp().
+         */
+        void setMaxSleepTime(const uint32_t maxSleep_ms) { this->maxSleep_ms = maxSleep_ms; }
+
+        /**
+         * @brief Ends the current or next sleep. This method can be called from an ISR.
+         */
+        void wakeUp() { wakeUpRequested = true; }
+
+        /**
+         * @brief Returns the time the next call of loop() would sleep [ms]. 0 means there is work to do.
+         */
+        [[nodiscard]] uint32_t getSleepTime();
+
+        /**
+         * @brief Sleeps until the next deadline, a wake-up or the maximum sleep time.
+         *
+         * @return true if the backend has been asked to sleep, false if there was work to do.
+         */
+        bool loop();
+
+        /**
+         * @brief Returns the number of sleeps.
+         */
+        [[nodiscard]] uint32_t getSleepCount() const { return sleepCount; }
+
+        /**
+         * @brief Returns the total time spent in the backend [ms].
+         */
+        [[nodiscard]] uint64_t getSleptTime() const { return sleptTime; }
+
+    private:
+        SleepBackendInterface &backend;
+        SchedulerInterface *scheduler = nullptr;
+        WakeSourceInterface *sessionManager = nullptr;
+        CpuLoad *cpuLoad = nullptr;
+        uint32_t maxSleep_ms = UINT32_MAX;
+        volatile bool wakeUpRequested = false;
+        uint32_t sleepCount = 0;
+        uint64_t sleptTime = 0;
+    };
+}
+
+#endif
@@ -0,0 +1,64 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <cstring>
+#include "LatencyHistogram.hpp"
+#include "PrintColumn.hpp"
+
+using namespace Stm32Common;
+
+void LatencyHistogramBase::clear() {
+    std::memset(counts, 0, bucketCount * sizeof(counts[0]));
+    count = 0;
+    min = UINT32_MAX;
+    max = 0;
+    total = 0;
+}
+
+uint32_t LatencyHistogramBase::getPercentile(const uint32_t numerator, const uint32_t denominator) const {
+    if (count == 0 || denominator == 0) return 0;
+
+    // Rank of the value, rounded up, at least the first value
+    uint64_t rank = (static_cast<uint64_t>(count) * numerator + denominator - 1) / denominator;
+    if (rank == 0) rank = 1;
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < bucketCount; i++) {
+        seen += counts[i];
+        if (seen >= rank) {
+            const uint32_t upper = getUpperBound(i);
+            return upper < max ? upper : max;
+        }
+    }
+    return max;
+}
+
+uint32_t LatencyHistogramBase::getUpperBound(const size_t index) const {
+    if (index < (1UL << subBucketBits)) return index;
+    if (index == bucketCount - 1) return UINT32_MAX;
+    const uint32_t shift = (index >> subBucketBits) - 1;
+    const uint32_t lower = static_cast<uint32_t>((1UL << subBucketBits) + (index & ((1UL << subBucketBits) - 1)))
+                           << shift;
+    return lower + ((1UL << shift) - 1);
+}
+
+size_t LatencyHistogramBase::printTable(Print &printObject, const convert_fn_t convert, const char *unit) const {
+    const uint32_t values[] = {
+        getMin(), getPercentile(50), getPercentile(90), getPercentile(99), getMax(), getMean()
+    };
+    size_t n = printObject.print("     count        min        p50        p90        p99        max       mean");
+    if (unit != nullptr) {
+        n += printObject.print(" [");
+        n += printObject.print(unit);
+        n += printObject.print(']');
+    }
+    n += printObject.println();
+    n += printColumn(printObject, count, 10);
+    for (const uint32_t value: values) {
+        n += printColumn(printObject, convert == nullptr ? value : static_cast<uint32_t>(convert(value)), 11);
+    }
+    n += printObject.println();
+    return n;
+}
@@ -0,0 +1,138 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef LIBSMART_STM32COMMON_LATENCYHISTOGRAM_HPP
+#define LIBSMART_STM32COMMON_LATENCYHISTOGRAM_HPP
+
+#include <libsmart_config.hpp>
+#include <cstddef>
+#include <cstdint>
+#include "Printable.hpp"
+
+namespace Stm32Common {
+    /**
+     * @brief Log-linear histogram of durations with fixed RAM, e.g. in cycles.
+     *
+     * This is the size independent part of LatencyHistogram.
+     *
+     * Values below 2^SubBucketBits are counted exactly. Every power of two above is split into 2^SubBucketBits
+     * buckets of equal width, so the relative error of a percentile is at most 2^-SubBucketBits. Values of
+     * 2^ValueBits and above are counted in the last bucket; min, max and mean are exact for all values.
+     *
+     * record() costs a count leading zeros, two shifts and four updates, no division and no loop.
+     *
+     * @see LatencyHistogram
+     */
+    class LatencyHistogramBase : public Printable {
+    public:
+        using convert_fn_t = uint64_t (*)(uint64_t value);
+
+        LatencyHistogramBase(const LatencyHistogramBase &) = delete;
+
+        LatencyHistogramBase &operator=(const LatencyHistogramBase &) = delete;
+
+        /**
+         * @brief Counts a value. This method is not reentrant, do not record into the same histogram from an ISR
+         * and the main loop.
+         */
+        void record(const uint32_t value) {
+            counts[getIndex(value)]++;
+            count++;
+            total += value;
+            if (value > max) max = value;
+            if (value < min) min = value;
+        }
+
+        void clear();
+
+        [[nodiscard]] uint32_t getCount() const { return count; }
+
+        [[nodiscard]] uint32_t getMin() const { return count == 0 ? 0 : min; }
+
+        [[nodiscard]] uint32_t getMax() const { return max; }
+
+        [[nodiscard]] uint32_t getMean() const { return count == 0 ? 0 : static_cast<uint32_t>(total / count); }
+
+        /**
+         * @brief Returns the value below or at which the given share of the values lies.
+         *
+         * The result is the upper end of the bucket that contains the percentile, limited to getMax().
+         *
+         * @param numerator The share, e.g. 99 for the 99th percentile.
+         * @param denominator The unit of the share, e.g. 1000 for getPercentile(999, 1000).
+         */
+        [[nodiscard]] uint32_t getPercentile(uint32_t numerator, uint32_t denominator = 100) const;
+
+        [[nodiscard]] size_t getBucketCount() const { return bucketCount; }
+
+        /**
+         * @brief Prints count, min, p50, p90, p99, max and mean in the unit of the recorded values.
+         */
+        size_t printTo(Print &printObject) const override { return printTable(printObject, nullptr, nullptr); }
+
+        /**
+         * @brief Prints count, min, p50, p90, p99, max and mean converted to another unit.
+         *
+         * @param printObject The output.
+         * @param convert Converts a recorded value to the printed unit, nullptr prints the recorded values.
+         * @param unit The name of the printed unit, nullptr for none.
+         */
+        size_t printTable(Print &printObject, convert_fn_t convert, const char *unit) const;
+
+    protected:
+        LatencyHistogramBase(uint32_t *counts, const uint8_t subBucketBits, const uint8_t valueBits)
+            : counts(counts), subBucketBits(subBucketBits), valueBits(valueBits),
+              bucketCount((valueBits - subBucketBits + 1U) << subBucketBits) { ; }
+
+        ~LatencyHistogramBase() = default;
+
+    private:
+        [[nodiscard]] size_t getIndex(const uint32_t value) const {
+            if (value < (1UL << subBucketBits)) return value;
+            const uint32_t msb = 31 - __builtin_clz(value);
+            if (msb >= valueBits) return bucketCount - 1;
+            const uint32_t shift = msb - subBucketBits;
+            return ((shift + 1) << subBucketBits) + ((value >> shift) & ((1UL << subBucketBits) - 1));
+        }
+
+        [[nodiscard]] uint32_t getUpperBound(size_t index) const;
+
+        uint32_t *counts;
+        uint8_t subBucketBits;
+        uint8_t valueBits;
+        size_t bucketCount;
+        uint32_t count = 0;
+        uint32_t min = UINT32_MAX;
+        uint32_t max = 0;
+        uint64_t total = 0;
+    };
+
+
+    /**
+     * @brief LatencyHistogram with 2^SubBucketBits buckets per power of two, for values up to 2^ValueBits.
+     *
+     * The default of 3 sub bucket bits and 28 value bits takes 832 bytes for the buckets, has a relative error of
+     * at most 12.5 % and covers 3.7 s in cycles at 72 MHz.
+     *
+     * @code
+     * Stm32Common::LatencyHistogram<> isrLatency;
+     * isrLatency.record(Stm32Common::Timebase::getCycles32() - start);
+     * isrLatency.printTable(log, nullptr, "cycles");
+     * @endcode
+     */
+    template<uint8_t SubBucketBits = 3, uint8_t ValueBits = 28>
+    class LatencyHistogram final : public LatencyHistogramBase {
+        static_assert(SubBucketBits >= 1 && SubBucketBits < ValueBits && ValueBits <= 32,
+                      "LatencyHistogram needs 1 <= SubBucketBits < ValueBits <= 32");
+
+    public:
+        LatencyHistogram() : LatencyHistogramBase(counts, SubBucketBits, ValueBits) { ; }
+
+    private:
+        uint32_t counts[(ValueBits - SubBucketBits + 1U) << SubBucketBits] = {};
+    };
+}
+
+#endif
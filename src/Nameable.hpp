@@ -6,6 +6,8 @@
 #ifndef LIBSMART_STM32COMMON_NAMEABLE_HPP
 #define LIBSMART_STM32COMMON_NAMEABLE_HPP
 
+#include <string_view>
+
 namespace Stm32Common {
     class Nameable {
     public:
@@ -21,6 +23,14 @@ namespace Stm32Common {
             return name == nullptr ? getDefaultName() : name;
         }
 
+        /**
+         * Returns the name as string view, e.g. to compare it without strcmp() or std::string.
+         */
+        [[nodiscard]] std::string_view getNameView() const {
+            const char *n = getName();
+            return n == nullptr ? std::string_view() : std::string_view(n);
+        }
+
         virtual char *getNameNonConst() {
             return const_cast<char *>(getName());
         }
@@ -75,6 +75,21 @@ namespace Stm32Common {
 
         void setOnReadFn(const onReadFn_t &on_read_fn) override { ; }
 #endif
+
+        void setDeferredCallQueue(DeferredCallQueueBase *queue) override { ; }
+
+#ifdef LIBSMART_ENABLE_TRACE
+        void setTraceId(uint8_t id, const char *name) override { ; }
+#endif
+
+#ifdef LIBSMART_ENABLE_BUFFER_STATISTICS
+        [[nodiscard]] const BufferStatistics &getStatistics() const override {
+            static const BufferStatistics statistics;
+            return statistics;
+        }
+
+        void clearStatistics() override { ; }
+#endif
     };
 
     inline NullStringBuffer nullStringBuffer;
@@ -0,0 +1,98 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "PcSampler.hpp"
+#include "Print.hpp"
+#ifdef LIBSMART_PCSAMPLER_TIMER
+#include "MCU/Uid.hpp"
+#endif
+
+using namespace Stm32Common;
+
+PcSamplerBase::PcSamplerBase(uint16_t *counts, const size_t bucketCount) : counts(counts), bucketCount(bucketCount) {
+    ;
+}
+
+void PcSamplerBase::setRange(const uint32_t base, const uint32_t size) {
+    uint8_t shift = 0;
+    while ((static_cast<uint64_t>(bucketCount) << shift) < size) shift++;
+    this->base = base;
+    this->size = size;
+    bucketShift = shift;
+    clear();
+}
+
+void PcSamplerBase::clear() {
+    for (size_t i = 0; i < bucketCount; i++) counts[i] = 0;
+    scaleShift = 0;
+    samples = 0;
+    other = 0;
+}
+
+void PcSamplerBase::halve() {
+    for (size_t i = 0; i < bucketCount; i++) counts[i] >>= 1;
+    scaleShift++;
+}
+
+size_t PcSamplerBase::printTo(Print &printObject) const {
+    size_t n = printObject.printf("pcsampler base=0x%08lx shift=%u scale=%u rate=%lu samples=%lu other=%lu\n",
+                                  static_cast<unsigned long>(base), bucketShift, scaleShift,
+                                  static_cast<unsigned long>(rate_Hz), static_cast<unsigned long>(samples),
+                                  static_cast<unsigned long>(other));
+    for (size_t i = 0; i < bucketCount; i++) {
+        if (counts[i] == 0) continue;
+        n += printObject.printf("%08lx %u\n", static_cast<unsigned long>(base + (i << bucketShift)), counts[i]);
+    }
+    return n + printObject.println("end");
+}
+
+
+#ifdef LIBSMART_PCSAMPLER_TIMER
+PcSamplerBase *PcSamplerBase::active = nullptr;
+
+bool PcSamplerBase::begin(TIM_TypeDef *timer, const IRQn_Type irq, const uint32_t timerClock_Hz,
+                          const uint32_t rate_Hz) {
+    if (active != nullptr || rate_Hz == 0) return false;
+    const uint32_t ticks = timerClock_Hz / rate_Hz;
+    const uint32_t prescaler = ticks > 0 ? (ticks - 1) / 0x10000 : 0;
+    const uint32_t reload = ticks / (prescaler + 1);
+    if (prescaler > 0xFFFF || reload < 2) return false;
+
+    setRange(FLASH_BASE, MCU::Uid::getFlashSize());
+    this->timer = timer;
+    this->irq = irq;
+    this->rate_Hz = timerClock_Hz / ((prescaler + 1) * reload);
+    active = this;
+
+    timer->CR1 = 0;
+    timer->PSC = prescaler;
+    timer->ARR = reload - 1;
+    timer->CNT = 0;
+    timer->EGR = TIM_EGR_UG;
+    timer->SR = 0;
+    timer->DIER = TIM_DIER_UIE;
+    HAL_NVIC_SetPriority(irq, 0, 0);
+    HAL_NVIC_EnableIRQ(irq);
+    timer->CR1 = TIM_CR1_CEN;
+    return true;
+}
+
+void PcSamplerBase::end() {
+    if (active != this) return;
+    timer->CR1 = 0;
+    timer->DIER = 0;
+    HAL_NVIC_DisableIRQ(irq);
+    timer->SR = 0;
+    active = nullptr;
+}
+
+extern "C" void Stm32Common_PcSampler_sample(const uint32_t *frame) {
+    PcSamplerBase *sampler = PcSamplerBase::active;
+    if (sampler == nullptr) return;
+    sampler->timer->SR = ~TIM_SR_UIF;
+    // The exception frame holds r0-r3, r12, lr, pc and xPSR
+    sampler->record(frame[6]);
+}
+#endif
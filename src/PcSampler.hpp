@@ -0,0 +1,175 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef LIBSMART_STM32COMMON_PCSAMPLER_HPP
+#define LIBSMART_STM32COMMON_PCSAMPLER_HPP
+
+#include <libsmart_config.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <main.h>
+#include "Printable.hpp"
+
+#if !defined(LIBSMART_HOST_BUILD) && defined(TIM_SR_UIF)
+#define LIBSMART_PCSAMPLER_TIMER
+
+/**
+ * @brief Defines the interrupt handler of the sampling timer.
+ *
+ * The handler passes the exception stack frame of the interrupted code to the PcSampler. The frame is on the
+ * process stack if the interrupted code used it, e.g. a ThreadX thread, otherwise on the main stack. Disable the
+ * generation of the handler in CubeMX.
+ *
+ * @code
+ * LIBSMART_PC_SAMPLER_IRQ_HANDLER(TIM4_IRQHandler)
+ * @endcode
+ */
+#define LIBSMART_PC_SAMPLER_IRQ_HANDLER(handler) \
+    extern "C" __attribute__((naked)) void handler() { \
+        __asm volatile("tst lr, #4\n" \
+                       "ite eq\n" \
+                       "mrseq r0, msp\n" \
+                       "mrsne r0, psp\n" \
+                       "b Stm32Common_PcSampler_sample\n"); \
+    }
+
+extern "C" void Stm32Common_PcSampler_sample(const uint32_t *frame);
+#endif
+
+namespace Stm32Common {
+    /**
+     * @brief Statistical profiler that counts the program counter of the interrupted code in a histogram.
+     *
+     * A timer interrupt with the highest priority takes the samples, so interrupt handlers are sampled, too. The
+     * flash is divided into getBucketCount() buckets of 2^getBucketShift() bytes. A bucket that would overflow
+     * halves all buckets, getScaleShift() tells how often this has happened.
+     *
+     * printTo() dumps the histogram as text, over any Print, e.g. a USB CDC session or an ITM logger. The host tool
+     * tools/pcprofile symbolizes the dump against the ELF file into a flat profile:
+     * @code
+     * pcsampler base=0x08000000 shift=6 scale=0 rate=1000 samples=5230 other=0
+     * 08000140 12
+     * 08001a80 4711
+     * end
+     * @endcode
+     *
+     * Usage with TIM4, whose clock has been enabled by CubeMX:
+     * @code
+     * Stm32Common::PcSampler<1024> pcSampler;
+     * LIBSMART_PC_SAMPLER_IRQ_HANDLER(TIM4_IRQHandler)
+     *
+     * pcSampler.begin(TIM4, TIM4_IRQn, 72000000, 1000);
+     * // ...
+     * pcSampler.end();
+     * shell.print(pcSampler);
+     * @endcode
+     */
+    class PcSamplerBase : public Printable {
+    public:
+        /**
+         * @brief Sets the sampled address range and clears the histogram. The bucket size is the smallest power
+         * of two for which the buckets cover the range.
+         */
+        void setRange(uint32_t base, uint32_t size);
+
+        /**
+         * @brief Counts a sample. This method is called from the timer interrupt.
+         */
+        void record(uint32_t pc) {
+            samples++;
+            const uint32_t offset = pc - base;
+            const uint32_t bucket = offset >> bucketShift;
+            if (offset >= size || bucket >= bucketCount) {
+                other++;
+                return;
+            }
+            if (counts[bucket] == UINT16_MAX) halve();
+            counts[bucket]++;
+        }
+
+        void clear();
+
+#ifdef LIBSMART_PCSAMPLER_TIMER
+        /**
+         * @brief Samples the whole flash with the given timer. The timer clock must have been enabled.
+         *
+         * @param timer The timer, its update interrupt takes the samples.
+         * @param irq The update interrupt of the timer, it gets the highest priority.
+         * @param timerClock_Hz The clock of the timer.
+         * @param rate_Hz The number of samples per second.
+         * @return false if another sampler is running or the rate is out of range.
+         */
+        bool begin(TIM_TypeDef *timer, IRQn_Type irq, uint32_t timerClock_Hz, uint32_t rate_Hz);
+
+        /**
+         * @brief Stops the timer. The histogram is kept.
+         */
+        void end();
+#endif
+
+        [[nodiscard]] uint32_t getBase() const { return base; }
+
+        [[nodiscard]] uint8_t getBucketShift() const { return bucketShift; }
+
+        [[nodiscard]] size_t getBucketCount() const { return bucketCount; }
+
+        /**
+         * @brief Returns the samples of a bucket, divided by 2^getScaleShift().
+         */
+        [[nodiscard]] uint16_t getCount(const size_t bucket) const { return counts[bucket]; }
+
+        [[nodiscard]] uint8_t getScaleShift() const { return scaleShift; }
+
+        [[nodiscard]] uint32_t getSamples() const { return samples; }
+
+        /**
+         * @brief Returns the samples outside the range, e.g. code running from RAM.
+         */
+        [[nodiscard]] uint32_t getOther() const { return other; }
+
+        size_t printTo(Print &printObject) const override;
+
+    protected:
+        PcSamplerBase(uint16_t *counts, size_t bucketCount);
+
+    private:
+        void halve();
+
+        uint16_t *const counts;
+        const size_t bucketCount;
+        uint32_t base = 0;
+        uint32_t size = 0;
+        uint8_t bucketShift = 0;
+        uint8_t scaleShift = 0;
+        uint32_t rate_Hz = 0;
+        volatile uint32_t samples = 0;
+        volatile uint32_t other = 0;
+
+#ifdef LIBSMART_PCSAMPLER_TIMER
+        friend void ::Stm32Common_PcSampler_sample(const uint32_t *frame);
+
+        static PcSamplerBase *active;
+        TIM_TypeDef *timer = nullptr;
+        IRQn_Type irq{};
+#endif
+    };
+
+
+    /**
+     * @brief PcSampler with a histogram of Buckets buckets, which take two bytes each.
+     */
+    template<size_t Buckets>
+    class PcSampler final : public PcSamplerBase {
+        static_assert(Buckets > 0, "PcSampler needs at least one bucket");
+
+    public:
+        PcSampler() : PcSamplerBase(buckets, Buckets) { ; }
+
+    private:
+        uint16_t buckets[Buckets] = {};
+    };
+}
+
+#endif
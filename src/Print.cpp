@@ -18,6 +18,18 @@
 #include <cstdio>
 #include <cstdlib>
 #include "Print.hpp"
+#include "Hexdump.hpp"
+#include "PrintTransaction.hpp"
+#include "Profiler.hpp"
+
+#if PRINTF_INCLUDE_CONFIG_H
+#include "printf/printf_config.h"
+#endif
+
+// Floating point numbers are only printed with printf(), if the printf profile supports %f
+#if defined(LIBSMART_ENABLE_PRINTF) && (!defined(PRINTF_SUPPORT_DECIMAL_SPECIFIERS) || PRINTF_SUPPORT_DECIMAL_SPECIFIERS)
+#define LIBSMART_PRINT_FLOAT_WITH_PRINTF
+#endif
 
 using namespace Stm32Common;
 
@@ -26,9 +38,15 @@ using namespace Stm32Common;
 size_t Print::printNumber(unsigned long n, uint8_t base) {
     switch (base) {
         case BIN: {
+            // printf() has no binary conversion
             char buf[8 * sizeof(long) + 1];
-            utoa(n, buf, 2);
-            write(buf);
+            char *str = &buf[sizeof(buf) - 1];
+            *str = '\0';
+            do {
+                *--str = static_cast<char>('0' + (n & 1));
+                n >>= 1;
+            } while (n);
+            return write(str);
         }
         case OCT:
             return printf("%o", n);
@@ -39,12 +57,7 @@ size_t Print::printNumber(unsigned long n, uint8_t base) {
     }
 }
 
-size_t Print::printFloat(double number, uint8_t digits) {
-    return printf("%.*lf", digits, number);
-}
-
 #else
-#include "math.h"
 size_t Print::printNumber(unsigned long n, uint8_t base)
 {
     char buf[8 * sizeof(long) + 1]; // Assumes 8-bit chars plus zero byte.
@@ -64,7 +77,16 @@ size_t Print::printNumber(unsigned long n, uint8_t base)
 
     return write(str);
 }
+#endif
 
+#ifdef LIBSMART_PRINT_FLOAT_WITH_PRINTF
+
+size_t Print::printFloat(double number, uint8_t digits) {
+    return printf("%.*lf", digits, number);
+}
+
+#else
+#include "math.h"
 size_t Print::printFloat(double number, uint8_t digits)
 {
     size_t n = 0;
@@ -118,6 +140,7 @@ size_t Print::write(const uint8_t *inputBytes, size_t size) {
     auto szTxBuffer = getWriteBuffer(txBuffer);
     if (size > szTxBuffer) {
         size = szTxBuffer;
+        abortTransaction();
     }
     memcpy(txBuffer, inputBytes, size);
     return setWrittenBytes(size);
@@ -128,18 +151,25 @@ size_t Print::write(const uint8_t *buffer, size_t size) {
     size_t n = 0;
     while (size--) {
         if (write(*buffer++)) n++;
-        else break;
+        else {
+            abortTransaction();
+            break;
+        }
     }
     return n;
 }
 #endif //LIBSMART_ENABLE_DIRECT_BUFFER_WRITE
 
-#ifdef LIBSMART_ENABLE_PRINTF
+#ifdef LIBSMART_ENABLE_STD_STRING
 size_t Print::print(const std::string &prnt_string) {
     return write(prnt_string.c_str(), prnt_string.size());
 }
 #endif
 
+size_t Print::print(const std::string_view prnt_string_view) {
+    return write(prnt_string_view.data(), prnt_string_view.size());
+}
+
 size_t Print::print(const char *prnt_cstring) {
     return write(prnt_cstring);
 }
@@ -188,10 +218,17 @@ size_t Print::print(const Printable &prnt_object) {
     return prnt_object.printTo(*this);
 }
 
+size_t Print::hexdump(const void *data, size_t size, uint32_t baseOffset) {
+    Hexdump::Options options;
+    options.baseOffset = baseOffset;
+    return print(Hexdump(data, size, options));
+}
+
 
 #ifdef LIBSMART_ENABLE_PRINTF
 
 size_t Print::printf(const char *format, ...) {
+    PROFILE_ZONE("printf");
     va_list args;
     va_start(args, format);
     auto ret = vprintf(format, args);
@@ -207,7 +244,11 @@ size_t Print::vprintf(const char *format, va_list args) {
     auto szBuffer = getWriteBuffer(buffer);
     int len = ::vsnprintf(reinterpret_cast<char *>(buffer), szBuffer, format, args);
     if (len < 0) return 0;
-    return setWrittenBytes(len < szBuffer ? len : sizeof buffer - 1);
+    if (static_cast<size_t>(len) >= szBuffer) {
+        abortTransaction();
+        return setWrittenBytes(szBuffer > 0 ? szBuffer - 1 : 0);
+    }
+    return setWrittenBytes(len);
 }
 
 #else
@@ -216,72 +257,90 @@ size_t Print::vprintf(const char *format, va_list args) {
     auto szBuffer = sizeof buffer;
     int len = ::vsnprintf(reinterpret_cast<char *>(buffer), szBuffer, format, args);
     if (len < 0) return 0;
+    if (static_cast<size_t>(len) >= szBuffer) abortTransaction();
     auto bytesToWrite = len < szBuffer ? len : sizeof buffer - 1;
     return write(buffer, bytesToWrite);
 }
 #endif
 #endif
 
-#ifdef LIBSMART_ENABLE_PRINTF
+#ifdef LIBSMART_ENABLE_STD_STRING
 size_t Print::println(const std::string &prnt_string) {
+    PrintTransaction transaction(*this);
     size_t n = print(prnt_string);
     n += println();
-    return n;
+    return transaction.end() ? n : 0;
 }
 #endif
 
+size_t Print::println(const std::string_view prnt_string_view) {
+    PrintTransaction transaction(*this);
+    size_t n = print(prnt_string_view);
+    n += println();
+    return transaction.end() ? n : 0;
+}
+
 size_t Print::println(const char *prnt_cstring) {
+    PrintTransaction transaction(*this);
     size_t n = print(prnt_cstring);
     n += println();
-    return n;
+    return transaction.end() ? n : 0;
 }
 
 size_t Print::println(char prnt_char) {
+    PrintTransaction transaction(*this);
     size_t n = print(prnt_char);
     n += println();
-    return n;
+    return transaction.end() ? n : 0;
 }
 
 size_t Print::println(unsigned char prnt_unsigned_char, int base) {
+    PrintTransaction transaction(*this);
     size_t n = print(prnt_unsigned_char, base);
     n += println();
-    return n;
+    return transaction.end() ? n : 0;
 }
 
 size_t Print::println(int prnt_int, int base) {
+    PrintTransaction transaction(*this);
     size_t n = print(prnt_int, base);
     n += println();
-    return n;
+    return transaction.end() ? n : 0;
 }
 
 size_t Print::println(unsigned int prnt_unsigned_int, int base) {
+    PrintTransaction transaction(*this);
     size_t n = print(prnt_unsigned_int, base);
     n += println();
-    return n;
+    return transaction.end() ? n : 0;
 }
 
 size_t Print::println(long prnt_long, int base) {
+    PrintTransaction transaction(*this);
     size_t n = print(prnt_long, base);
     n += println();
-    return n;
+    return transaction.end() ? n : 0;
 }
 
 size_t Print::println(unsigned long prnt_unsigned_long, int base) {
+    PrintTransaction transaction(*this);
     size_t n = print(prnt_unsigned_long, base);
     n += println();
-    return n;
+    return transaction.end() ? n : 0;
 }
 
 size_t Print::println(double prnt_double, int digits) {
+    PrintTransaction transaction(*this);
     size_t n = print(prnt_double, digits);
     n += println();
-    return n;
+    return transaction.end() ? n : 0;
 }
 
 size_t Print::println(const Printable &prnt_object) {
+    PrintTransaction transaction(*this);
     size_t n = print(prnt_object);
     n += println();
-    return n;
+    return transaction.end() ? n : 0;
 }
 
 size_t Print::println() { return write("\r\n"); }
@@ -24,6 +24,7 @@
 #include <cstdint>
 #include <cstring>
 #include <cstdarg>
+#include <string_view>
 #include "Printable.hpp"
 
 #define DEC 10
@@ -203,6 +204,41 @@ namespace Stm32Common {
          */
         virtual int availableForWrite() = 0;
 
+        /**
+         * @brief Starts a print transaction.
+         *
+         * All writes between beginTransaction() and endTransaction() are reserved in the underlying device and
+         * committed as one block, with a single write notification, when the outermost transaction ends.
+         * Transactions may be nested; only the outermost endTransaction() commits.
+         *
+         * The default implementation does nothing, so devices without a buffer write through immediately.
+         *
+         * @note This function is an extension to the class Print in arduino.
+         * @see PrintTransaction
+         */
+        virtual void beginTransaction() { ; }
+
+        /**
+         * @brief Ends a print transaction.
+         *
+         * Commits the reserved bytes when the outermost transaction ends. If a write inside the transaction did not
+         * fit into the underlying device, all bytes of the transaction are rolled back instead.
+         *
+         * @return True if the transaction was committed, false if it was rolled back.
+         * @note This function is an extension to the class Print in arduino.
+         */
+        virtual bool endTransaction() { return true; }
+
+        /**
+         * @brief Marks the current print transaction to be rolled back when it ends.
+         *
+         * Called by the write functions when the message does not fit into the underlying device.
+         * Outside of a transaction, this function does nothing.
+         *
+         * @note This function is an extension to the class Print in arduino.
+         */
+        virtual void abortTransaction() { ; }
+
 
         //        size_t print(const __FlashStringHelper *);
         //        size_t print(const String &);
@@ -218,6 +254,15 @@ namespace Stm32Common {
 
 #endif
 
+        /**
+         * @brief Prints a string view to the underlying device.
+         *
+         * @param prnt_string_view The string to be printed. It does not need to be null-terminated.
+         * @return The number of bytes written to the underlying device.
+         * @note This function is an extension to the class Print in arduino.
+         */
+        size_t print(std::string_view prnt_string_view);
+
         /**
          * @brief Writes a null-terminated string to the underlying device.
          *
@@ -298,6 +343,21 @@ namespace Stm32Common {
          */
         size_t print(const Printable &prnt_object);
 
+        /**
+         * @brief Prints a hexdump of the given data, with offset and ASCII column.
+         *
+         * Prints as much as fits into the underlying device. Use the class Hexdump directly to change the layout or
+         * to resume a dump that did not fit.
+         *
+         * @param data Pointer to the data to dump.
+         * @param size The number of bytes to dump.
+         * @param baseOffset The value printed in the offset column for the first byte.
+         * @return The number of bytes written to the underlying device.
+         * @note This function is an extension to the class Print in arduino.
+         * @see Hexdump
+         */
+        size_t hexdump(const void *data, size_t size, uint32_t baseOffset = 0);
+
 #ifdef LIBSMART_ENABLE_PRINTF
 
         /**
@@ -345,6 +405,15 @@ namespace Stm32Common {
 
 #endif
 
+        /**
+         * @brief Prints a string view followed by a new line.
+         *
+         * @param prnt_string_view The string to be printed. It does not need to be null-terminated.
+         * @return The number of characters printed, including the new line character.
+         * @note This function is an extension to the class Print in arduino.
+         */
+        size_t println(std::string_view prnt_string_view);
+
         /**
          * @brief Prints the specified string followed by a newline character.
          *
@@ -0,0 +1,23 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "PrintColumn.hpp"
+
+size_t Stm32Common::printColumn(Print &out, const uint32_t value, const size_t width) {
+    size_t digits = 1;
+    for (uint32_t v = value; v >= 10; v /= 10) digits++;
+    size_t n = 0;
+    for (size_t i = digits; i < width; i++) n += out.print(' ');
+    return n + out.print(value);
+}
+
+size_t Stm32Common::printTextColumn(Print &out, const char *text, const size_t width) {
+    if (text == nullptr) text = "";
+    size_t length = 0;
+    while (text[length] != '\0' && length < width) length++;
+    size_t n = out.write(text, length);
+    for (size_t pad = length; pad < width; pad++) n += out.print(' ');
+    return n;
+}
@@ -0,0 +1,32 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef LIBSMART_STM32COMMON_PRINTCOLUMN_HPP
+#define LIBSMART_STM32COMMON_PRINTCOLUMN_HPP
+
+#include <libsmart_config.hpp>
+#include <cstddef>
+#include <cstdint>
+#include "Print.hpp"
+
+namespace Stm32Common {
+    /**
+     * @brief Prints a number right-aligned in a column of the given width, as in the tables of the reports.
+     * A number wider than the column is printed completely.
+     *
+     * @return The number of bytes written.
+     */
+    size_t printColumn(Print &out, uint32_t value, size_t width);
+
+    /**
+     * @brief Prints a text left-aligned in a column of the given width. A longer text is cut at the width,
+     * nullptr prints an empty column.
+     *
+     * @return The number of bytes written.
+     */
+    size_t printTextColumn(Print &out, const char *text, size_t width);
+}
+
+#endif
@@ -0,0 +1,76 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef LIBSMART_STM32COMMON_PRINTTRANSACTION_HPP
+#define LIBSMART_STM32COMMON_PRINTTRANSACTION_HPP
+
+#include <libsmart_config.hpp>
+#include "Print.hpp"
+
+namespace Stm32Common {
+    /**
+     * @brief RAII guard that coalesces several print calls into one transaction.
+     *
+     * The constructor starts a transaction on the given Print object and the destructor ends it. All bytes written
+     * in between are committed at once and the underlying buffer fires its write notification only once. If the whole
+     * message does not fit, nothing is committed.
+     *
+     * @code
+     * {
+     *     Stm32Common::PrintTransaction transaction(*session);
+     *     session->print("temperature = ");
+     *     session->print(temperature, 1);
+     *     session->println("C");
+     * } // one commit, one notification
+     * @endcode
+     */
+    class PrintTransaction {
+    public:
+        explicit PrintTransaction(Print &print) : print(print) {
+            print.beginTransaction();
+        }
+
+        ~PrintTransaction() {
+            end();
+        }
+
+        PrintTransaction(const PrintTransaction &) = delete;
+
+        PrintTransaction &operator=(const PrintTransaction &) = delete;
+
+        /**
+         * @brief Ends the transaction before the guard goes out of scope.
+         *
+         * Calling end() more than once returns the result of the first call.
+         *
+         * @return True if the transaction was committed, false if it was rolled back.
+         */
+        bool end() {
+            if (open) {
+                open = false;
+                committed = print.endTransaction();
+            }
+            return committed;
+        }
+
+        /**
+         * @brief Discards everything written within this transaction and ends it. A later end() returns false.
+         */
+        void abort() {
+            if (open) {
+                open = false;
+                print.abortTransaction();
+                committed = print.endTransaction();
+            }
+        }
+
+    private:
+        Print &print;
+        bool open = true;
+        bool committed = false;
+    };
+}
+
+#endif
@@ -0,0 +1,98 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "Runner.hpp"
+#include "../PrintColumn.hpp"
+
+using namespace Stm32Common::Process;
+
+bool RunnerBase::add(ProcessInterface &process, const char *name, const uint8_t priority,
+                     const uint32_t budget_cycles) {
+    if (count >= capacity) return false;
+    entries[count] = {&process, name, budget_cycles, priority, {}};
+
+    // Stable insertion into the priority order
+    size_t pos = count;
+    while (pos > 0 && entries[order[pos - 1]].priority < priority) {
+        order[pos] = order[pos - 1];
+        pos--;
+    }
+    order[pos] = static_cast<uint8_t>(count);
+    count++;
+    return true;
+}
+
+void RunnerBase::clearStatistics() {
+    for (size_t i = 0; i < count; i++) entries[i].statistics = {};
+    passOverruns = 0;
+}
+
+void RunnerBase::setup() {
+    for (size_t i = 0; i < count; i++) entries[i].process->setup();
+}
+
+void RunnerBase::loop() {
+    if (count == 0) return;
+    const uint32_t passStart = clock();
+
+    for (size_t n = 0; n < count; n++) {
+        if (passBudget_cycles != 0 && n > 0 && clock() - passStart > passBudget_cycles) {
+            passOverruns++;
+            return;
+        }
+        if (policy == Policy::PRIORITY) {
+            runEntry(entries[order[n]]);
+        } else {
+            runEntry(entries[next]);
+            next = next + 1 < count ? next + 1 : 0;
+        }
+    }
+}
+
+void RunnerBase::end() {
+    for (size_t i = count; i > 0; i--) entries[i - 1].process->end();
+}
+
+void RunnerBase::errorHandler() {
+    for (size_t i = 0; i < count; i++) entries[i].process->errorHandler();
+}
+
+void RunnerBase::runEntry(Entry &entry) {
+    const uint32_t start = clock();
+    entry.process->loop();
+    const uint32_t duration = clock() - start;
+
+    Statistics &statistics = entry.statistics;
+    statistics.runs++;
+    statistics.lastCycles = duration;
+    statistics.totalCycles += duration;
+    if (duration > statistics.maxCycles) statistics.maxCycles = duration;
+    if (entry.budget_cycles != 0 && duration > entry.budget_cycles) {
+        statistics.overruns++;
+        entry.process->errorHandler();
+    }
+}
+
+size_t RunnerBase::printTo(Print &printObject) const {
+    size_t n = printObject.println("process          prio       runs   overruns       last        max       mean");
+    for (size_t i = 0; i < count; i++) {
+        const Entry &entry = entries[i];
+        const char *name = entry.name == nullptr ? "-" : entry.name;
+        n += printTextColumn(printObject, name, 16);
+        n += printColumn(printObject, entry.priority, 5);
+        n += printColumn(printObject, entry.statistics.runs, 11);
+        n += printColumn(printObject, entry.statistics.overruns, 11);
+        n += printColumn(printObject, entry.statistics.lastCycles, 11);
+        n += printColumn(printObject, entry.statistics.maxCycles, 11);
+        n += printColumn(printObject, entry.statistics.getMeanCycles(), 11);
+        n += printObject.println();
+    }
+    if (passOverruns != 0) {
+        n += printObject.print("pass budget exceeded ");
+        n += printObject.print(passOverruns);
+        n += printObject.println(" times");
+    }
+    return n;
+}
@@ -0,0 +1,170 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef LIBSMART_STM32COMMON_PROCESS_RUNNER_HPP
+#define LIBSMART_STM32COMMON_PROCESS_RUNNER_HPP
+
+#include <libsmart_config.hpp>
+#include <cstddef>
+#include <cstdint>
+#include "ProcessInterface.hpp"
+#include "../Printable.hpp"
+#include "../Timebase.hpp"
+
+namespace Stm32Common::Process {
+    /**
+     * @brief Runs a fixed set of processes and measures the time each loop() takes.
+     *
+     * This is the size independent part of Runner.
+     *
+     * setup() calls setup() of all processes in the order they have been added, end() calls end() in reverse
+     * order. loop() calls loop() of the processes either in the order they have been added (ROUND_ROBIN) or
+     * from the highest to the lowest priority (PRIORITY).
+     *
+     * Every loop() of a process is measured with the clock, by default Timebase::getCycles32(). A process that
+     * takes longer than its budget gets its errorHandler() called. With a pass budget, loop() stops calling
+     * processes once the pass took longer than the budget. In ROUND_ROBIN mode the next pass continues with the
+     * process that has been left out, in PRIORITY mode it starts again with the highest priority.
+     *
+     * The Runner itself is a process, so runners can be nested. printTo() prints a table with the statistics.
+     *
+     * @see Runner
+     */
+    class RunnerBase : public ProcessInterface, public Printable {
+    public:
+        using clock_fn_t = uint32_t (*)();
+
+        enum class Policy : uint8_t {
+            ROUND_ROBIN,
+            PRIORITY
+        };
+
+        struct Statistics {
+            uint32_t runs = 0;
+            uint32_t overruns = 0;
+            uint32_t lastCycles = 0;
+            uint32_t maxCycles = 0;
+            uint64_t totalCycles = 0;
+
+            [[nodiscard]] uint32_t getMeanCycles() const {
+                return runs == 0 ? 0 : static_cast<uint32_t>(totalCycles / runs);
+            }
+        };
+
+        RunnerBase(const RunnerBase &) = delete;
+
+        RunnerBase &operator=(const RunnerBase &) = delete;
+
+        /**
+         * @brief Adds a process.
+         *
+         * @param process The process to run.
+         * @param name The name in the statistics table. The string is not copied.
+         * @param priority Higher priorities run first in PRIORITY mode.
+         * @param budget_cycles The maximum duration of one loop() of the process, 0 for no limit [clock cycles].
+         * @return true if the process has been added, false if the runner is full.
+         */
+        bool add(ProcessInterface &process, const char *name = nullptr, uint8_t priority = 0,
+                 uint32_t budget_cycles = 0);
+
+        void setPolicy(const Policy policy) { this->policy = policy; }
+
+        /**
+         * @brief Limits the duration of one loop() of the runner, 0 for no limit [clock cycles].
+         */
+        void setPassBudget(const uint32_t budget_cycles) { passBudget_cycles = budget_cycles; }
+
+        /**
+         * @brief Replaces the clock, e.g. with a synthetic clock for tests.
+         */
+        void setClock(const clock_fn_t clock) { this->clock = clock; }
+
+        [[nodiscard]] size_t getProcessCount() const { return count; }
+
+        /**
+         * @brief Returns the statistics of the process at the given position, in the order of adding.
+         */
+        [[nodiscard]] const Statistics &getStatistics(size_t index) const { return entries[index].statistics; }
+
+        /**
+         * @brief Returns the number of passes that have been ended early by the pass budget.
+         */
+        [[nodiscard]] uint32_t getPassOverruns() const { return passOverruns; }
+
+        void clearStatistics();
+
+        void setup() override;
+
+        void loop() override;
+
+        void end() override;
+
+        /**
+         * @brief Calls errorHandler() of all processes.
+         */
+        void errorHandler() override;
+
+        size_t printTo(Print &printObject) const override;
+
+    protected:
+        struct Entry {
+            ProcessInterface *process;
+            const char *name;
+            uint32_t budget_cycles;
+            uint8_t priority;
+            Statistics statistics;
+        };
+
+        RunnerBase(Entry *entries, uint8_t *order, const size_t capacity)
+            : entries(entries), order(order), capacity(capacity) { ; }
+
+        ~RunnerBase() override = default;
+
+    private:
+        void runEntry(Entry &entry);
+
+        Entry *entries;
+        uint8_t *order; // Indices of the entries, sorted by priority
+        size_t capacity;
+        size_t count = 0;
+        size_t next = 0; // Round-robin position of the next pass
+        uint32_t passBudget_cycles = 0;
+        uint32_t passOverruns = 0;
+        clock_fn_t clock = Timebase::getCycles32;
+        Policy policy = Policy::ROUND_ROBIN;
+    };
+
+
+    /**
+     * @brief Runner with room for MaxProcesses processes.
+     *
+     * @code
+     * Stm32Common::Process::Runner<4> runner;
+     *
+     * void setup() {
+     *     runner.add(sessionManager, "sessions", 1, Stm32Common::Timebase::microsToCycles(500));
+     *     runner.add(shell, "shell");
+     *     runner.setup();
+     * }
+     *
+     * void loop() {
+     *     runner.loop();
+     * }
+     * @endcode
+     */
+    template<size_t MaxProcesses>
+    class Runner final : public RunnerBase {
+        static_assert(MaxProcesses > 0 && MaxProcesses <= UINT8_MAX, "Runner supports 1 to 255 processes");
+
+    public:
+        Runner() : RunnerBase(entries, order, MaxProcesses) { ; }
+
+    private:
+        Entry entries[MaxProcesses] = {};
+        uint8_t order[MaxProcesses] = {};
+    };
+}
+
+#endif
@@ -0,0 +1,93 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <cstring>
+#include "Profiler.hpp"
+#include "PrintColumn.hpp"
+
+using namespace Stm32Common;
+
+namespace {
+    // Orders zones by total time, zones with the same total by address, so the order is strict
+    bool isBefore(const ProfileZone *a, const ProfileZone *b) {
+        if (a->getTotalCycles() != b->getTotalCycles()) return a->getTotalCycles() > b->getTotalCycles();
+        return a > b;
+    }
+}
+
+ProfileZone::ProfileZone(const char *name) : Nameable(name) {
+    Profiler::getInstance().add(this);
+}
+
+ProfileZone::~ProfileZone() {
+    Profiler::getInstance().remove(this);
+}
+
+size_t Profiler::getZoneCount() const {
+    size_t count = 0;
+    for (const ProfileZone *zone = first; zone != nullptr; zone = zone->next) count++;
+    return count;
+}
+
+ProfileZone *Profiler::findZone(const char *name) const {
+    for (ProfileZone *zone = first; zone != nullptr; zone = zone->next) {
+        if (std::strcmp(zone->getName(), name) == 0) return zone;
+    }
+    return nullptr;
+}
+
+void Profiler::clear() {
+    for (ProfileZone *zone = first; zone != nullptr; zone = zone->next) zone->clear();
+    startCycles = Timebase::getCycles();
+}
+
+size_t Profiler::printTo(Print &printObject) const {
+    const uint64_t elapsed = Timebase::getCycles() - startCycles;
+    size_t n = printObject.println(
+        "zone                  calls   total_us    self_us     min_ns    mean_ns     max_ns  share_%");
+
+    // Selects the zones in order instead of sorting the list, printing must not allocate or reorder the zones
+    const ProfileZone *previous = nullptr;
+    for (size_t printed = getZoneCount(); printed > 0; printed--) {
+        const ProfileZone *next = nullptr;
+        for (const ProfileZone *zone = first; zone != nullptr; zone = zone->next) {
+            if (previous != nullptr && !isBefore(previous, zone)) continue;
+            if (next == nullptr || isBefore(zone, next)) next = zone;
+        }
+        if (next == nullptr) break;
+        previous = next;
+
+        const char *name = next->getName();
+        n += printTextColumn(printObject, name, 20);
+        n += printColumn(printObject, next->getCalls(), 7);
+        n += printColumn(printObject, static_cast<uint32_t>(Timebase::cyclesToMicros(next->getTotalCycles())), 11);
+        n += printColumn(printObject, static_cast<uint32_t>(Timebase::cyclesToMicros(next->getSelfCycles())), 11);
+        n += printColumn(printObject, static_cast<uint32_t>(Timebase::cyclesToNanos(next->getMinCycles())), 11);
+        n += printColumn(printObject, static_cast<uint32_t>(Timebase::cyclesToNanos(next->getMeanCycles())), 11);
+        n += printColumn(printObject, static_cast<uint32_t>(Timebase::cyclesToNanos(next->getMaxCycles())), 11);
+        n += printColumn(printObject, elapsed == 0 ? 0 : static_cast<uint32_t>(next->getTotalCycles() * 100 / elapsed),
+                         9);
+        n += printObject.println();
+    }
+    return n;
+}
+
+void Profiler::add(ProfileZone *zone) {
+    zone->traceId = nextTraceId++;
+    zone->next = first;
+    first = zone;
+#ifdef LIBSMART_ENABLE_TRACE
+    Tracer::name(Trace::EventType::ZONE_BEGIN, zone->traceId, zone->getName());
+#endif
+}
+
+void Profiler::remove(const ProfileZone *zone) {
+    for (ProfileZone **link = &first; *link != nullptr; link = &(*link)->next) {
+        if (*link == zone) {
+            *link = zone->next;
+            return;
+        }
+    }
+}
@@ -0,0 +1,208 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef LIBSMART_STM32COMMON_PROFILER_HPP
+#define LIBSMART_STM32COMMON_PROFILER_HPP
+
+#include <libsmart_config.hpp>
+#include <cstddef>
+#include <cstdint>
+#include "Nameable.hpp"
+#include "Printable.hpp"
+#include "Singleton.hpp"
+#include "Timebase.hpp"
+#ifdef LIBSMART_ENABLE_TRACE
+#include "Trace.hpp"
+#endif
+
+#define LIBSMART_PROFILE_CONCAT_(a, b) a##b
+#define LIBSMART_PROFILE_CONCAT(a, b) LIBSMART_PROFILE_CONCAT_(a, b)
+
+#ifdef LIBSMART_ENABLE_PROFILER
+/**
+ * @brief Measures the rest of the enclosing block as the zone with the given name.
+ *
+ * The zone is a function local static, it is registered with the Profiler when the block is entered the first time.
+ * Without LIBSMART_ENABLE_PROFILER the macro expands to nothing.
+ */
+#define PROFILE_ZONE(name) \
+    static Stm32Common::ProfileZone LIBSMART_PROFILE_CONCAT(libsmartProfileZone, __LINE__)(name); \
+    const Stm32Common::ProfileZone::Scope LIBSMART_PROFILE_CONCAT(libsmartProfileScope, __LINE__)( \
+        LIBSMART_PROFILE_CONCAT(libsmartProfileZone, __LINE__))
+#else
+#define PROFILE_ZONE(name) static_cast<void>(0)
+#endif
+
+namespace Stm32Common {
+    /**
+     * @brief Number of calls and their total, shortest and longest duration of a named code region [cycles].
+     *
+     * A zone registers itself with the Profiler on construction and stays registered for its lifetime. Usually
+     * zones are created with PROFILE_ZONE() and live until the end of the program.
+     *
+     * The total, min and max durations are inclusive: they contain the scopes that are nested into the scope of the
+     * zone. The self time is exclusive, it leaves out the time of the nested scopes.
+     *
+     * Recording is not protected against interrupts, a zone must only be entered from one context. A scope of an
+     * ISR that interrupts a scope counts as nested into it.
+     */
+    class ProfileZone : public Nameable {
+    public:
+        /**
+         * @brief Measures from its construction to its destruction.
+         */
+        class Scope {
+        public:
+            explicit Scope(ProfileZone &zone) : zone(zone), parent(current), startCycles(Timebase::getCycles32()) {
+                current = this;
+#ifdef LIBSMART_ENABLE_TRACE
+                Tracer::zoneBegin(zone.traceId);
+#endif
+            }
+
+            ~Scope() {
+                const uint32_t cycles = Timebase::getCycles32() - startCycles;
+                zone.record(cycles, cycles - childCycles);
+                if (parent != nullptr) parent->childCycles += cycles;
+                current = parent;
+#ifdef LIBSMART_ENABLE_TRACE
+                Tracer::zoneEnd(zone.traceId);
+#endif
+            }
+
+            Scope(const Scope &) = delete;
+
+            Scope &operator=(const Scope &) = delete;
+
+        private:
+            // The innermost active scope
+            static inline Scope *current = nullptr;
+
+            ProfileZone &zone;
+            Scope *const parent;
+            const uint32_t startCycles;
+            uint32_t childCycles = 0; // Time of the nested scopes
+        };
+
+        explicit ProfileZone(const char *name);
+
+        ~ProfileZone() override;
+
+        ProfileZone(const ProfileZone &) = delete;
+
+        ProfileZone &operator=(const ProfileZone &) = delete;
+
+        /**
+         * @brief Counts a call that took cycles, of which selfCycles have not been spent in nested scopes.
+         */
+        void record(const uint32_t cycles, const uint32_t selfCycles) {
+            calls++;
+            totalCycles += cycles;
+            this->selfCycles += selfCycles;
+            if (cycles < minCycles) minCycles = cycles;
+            if (cycles > maxCycles) maxCycles = cycles;
+        }
+
+        void record(const uint32_t cycles) { record(cycles, cycles); }
+
+        void clear() {
+            calls = 0;
+            totalCycles = 0;
+            selfCycles = 0;
+            minCycles = UINT32_MAX;
+            maxCycles = 0;
+        }
+
+        [[nodiscard]] uint32_t getCalls() const { return calls; }
+
+        [[nodiscard]] uint64_t getTotalCycles() const { return totalCycles; }
+
+        /**
+         * @brief Returns the total time without the time of the nested scopes.
+         */
+        [[nodiscard]] uint64_t getSelfCycles() const { return selfCycles; }
+
+        [[nodiscard]] uint32_t getMinCycles() const { return calls == 0 ? 0 : minCycles; }
+
+        [[nodiscard]] uint32_t getMaxCycles() const { return maxCycles; }
+
+        [[nodiscard]] uint32_t getMeanCycles() const {
+            return calls == 0 ? 0 : static_cast<uint32_t>(totalCycles / calls);
+        }
+
+        [[nodiscard]] ProfileZone *getNext() const { return next; }
+
+        /**
+         * @brief Returns the id of the zone in the trace stream, zones are numbered in the order of registration.
+         */
+        [[nodiscard]] uint8_t getTraceId() const { return traceId; }
+
+    private:
+        friend class Profiler;
+
+        ProfileZone *next = nullptr;
+        uint8_t traceId = 0;
+        uint32_t calls = 0;
+        uint32_t minCycles = UINT32_MAX;
+        uint32_t maxCycles = 0;
+        uint64_t totalCycles = 0;
+        uint64_t selfCycles = 0;
+    };
+
+
+    /**
+     * @brief Registry of all ProfileZone objects.
+     *
+     * printTo() prints one line per zone, sorted by total time: calls, the total and the self time in microseconds,
+     * min, mean and max in nanoseconds and the share of the time since the last clear(). Nested zones are contained
+     * in the total time of the enclosing zone, so the shares may add up to more than 100 %. The self times do not
+     * overlap.
+     *
+     * @code
+     * void loop() {
+     *     PROFILE_ZONE("loop");
+     *     {
+     *         PROFILE_ZONE("sessions");
+     *         sessionManager.loop();
+     *     }
+     *     scheduler.loop();
+     * }
+     *
+     * Stm32Common::Profiler::getInstance().printTo(log);
+     * @endcode
+     */
+    class Profiler : public Printable, public Singleton<Profiler> {
+        friend class Singleton<Profiler>;
+
+    public:
+        [[nodiscard]] ProfileZone *getFirstZone() const { return first; }
+
+        [[nodiscard]] size_t getZoneCount() const;
+
+        [[nodiscard]] ProfileZone *findZone(const char *name) const;
+
+        /**
+         * @brief Clears the statistics of all zones and restarts the time base of the shares.
+         */
+        void clear();
+
+        size_t printTo(Print &printObject) const override;
+
+    private:
+        friend class ProfileZone;
+
+        Profiler() : startCycles(Timebase::getCycles()) { ; }
+
+        void add(ProfileZone *zone);
+
+        void remove(const ProfileZone *zone);
+
+        ProfileZone *first = nullptr;
+        uint64_t startCycles;
+        uint8_t nextTraceId = 0;
+    };
+}
+
+#endif
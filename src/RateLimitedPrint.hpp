@@ -0,0 +1,82 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef LIBSMART_STM32COMMON_RATELIMITEDPRINT_HPP
+#define LIBSMART_STM32COMMON_RATELIMITEDPRINT_HPP
+
+#include <libsmart_config.hpp>
+#include "Print.hpp"
+#include "TokenBucket.hpp"
+
+namespace Stm32Common {
+    /**
+     * @brief Print that forwards to another Print as far as a TokenBucket allows.
+     *
+     * Writes beyond the limit are cut short and return the number of bytes that have been forwarded, like a
+     * full buffer does. availableForWrite() reports the smaller of the free space of the target and the
+     * available tokens, so callers that check it first never lose bytes.
+     *
+     * @code
+     * Stm32Common::TokenBucket debugLimit(1000, 128);
+     * Stm32Common::RateLimitedPrint debugOut(uart, debugLimit);
+     * debugOut.println("state changed");
+     * @endcode
+     */
+    class RateLimitedPrint : public Print {
+    public:
+        RateLimitedPrint(Print &target, TokenBucket &bucket) : target(target), bucket(bucket) { ; }
+
+#ifdef LIBSMART_ENABLE_DIRECT_BUFFER_WRITE
+        size_t getWriteBuffer(uint8_t *&buffer) override {
+            const size_t size = target.getWriteBuffer(buffer);
+            const size_t available = bucket.getAvailable();
+            return size < available ? size : available;
+        }
+
+        size_t setWrittenBytes(const size_t size) override {
+            const size_t written = target.setWrittenBytes(size);
+            bucket.consume(written);
+            return written;
+        }
+#endif
+
+        size_t write(const uint8_t data) override {
+            if (bucket.getAvailable() == 0) return 0;
+            const size_t written = target.write(data);
+            bucket.consume(written);
+            return written;
+        }
+
+        size_t write(const uint8_t *inputBytes, const size_t size) override {
+            const size_t available = bucket.getAvailable();
+            const size_t written = target.write(inputBytes, size < available ? size : available);
+            bucket.consume(written);
+            return written;
+        }
+
+        using Print::write;
+
+        int availableForWrite() override {
+            const int size = target.availableForWrite();
+            if (size <= 0) return size;
+            const size_t available = bucket.getAvailable();
+            return static_cast<size_t>(size) < available ? size : static_cast<int>(available);
+        }
+
+        void flush() override { target.flush(); }
+
+        void beginTransaction() override { target.beginTransaction(); }
+
+        bool endTransaction() override { return target.endTransaction(); }
+
+        void abortTransaction() override { target.abortTransaction(); }
+
+    private:
+        Print &target;
+        TokenBucket &bucket;
+    };
+}
+
+#endif
@@ -18,26 +18,113 @@
 #endif
 
 #include "Helper.hpp"
+#include "RunEveryTimer.hpp"
+#include "SchedulerInterface.hpp"
+#include "Timebase.hpp"
 
 namespace Stm32Common {
-    class RunEvery {
+    /**
+     * @brief The time source of RunEvery: millis().
+     */
+    struct MillisTimeSource {
+        static uint32_t now() { return millis(); }
+
+        /**
+         * @brief The times of RunEvery, under the member names derived classes of RunEvery use.
+         */
+        class State {
+        protected:
+            /**
+             * @brief The time of the last run, or the start of the delay before the first one [ms].
+             */
+            uint32_t _last_last_run_ms = millis();
+
+            /**
+             * @brief The time from the construction to the first run [ms].
+             */
+            uint32_t _delay_ms = {};
+
+            /**
+             * @brief The time between two runs [ms].
+             */
+            uint32_t _interval_ms = {};
+
+            static constexpr uint32_t State::*LastRun = &State::_last_last_run_ms;
+            static constexpr uint32_t State::*Delay = &State::_delay_ms;
+            static constexpr uint32_t State::*Interval = &State::_interval_ms;
+        };
+    };
+
+
+    class RunEvery : public RunEveryTimer<MillisTimeSource> {
+        template<size_t MaxTasks>
+        friend class Scheduler;
+
     public:
+#ifdef LIBSMART_ENABLE_RUNEVERY_STATISTICS
+        /**
+         * @brief Counters about the punctuality of the runs. Jitter is the time from the due time to the start
+         * of the run. A deadline miss is a run that ended later than the deadline after its due time. The
+         * execution time of the runs is measured in cycles of the Timebase.
+         */
+        struct TimingStatistics {
+            uint32_t runs = 0;
+            uint32_t lateRuns = 0;
+            uint32_t skippedPeriods = 0;
+            uint32_t deadlineMisses = 0;
+            uint32_t maxJitter_ms = 0;
+            uint64_t totalJitter_ms = 0;
+            uint32_t lastExecution_cycles = 0;
+            uint32_t maxExecution_cycles = 0;
+
+            [[nodiscard]] uint32_t getMeanJitter() const {
+                return runs == 0 ? 0 : static_cast<uint32_t>(totalJitter_ms / runs);
+            }
+        };
+#endif
+
         RunEvery() = default;
 
-        virtual ~RunEvery() = default;
+        /**
+         * @brief Copies the settings and the state. The copy is not registered with a scheduler.
+         */
+        RunEvery(const RunEvery &) = default;
+
+        /**
+         * @brief Copies the settings and the state. This object stays registered with its scheduler and is
+         * reordered there.
+         */
+        RunEvery &operator=(const RunEvery &other) {
+            if (this == &other) return *this;
+#ifdef LIBSMART_ENABLE_STD_FUNCTION
+            _fn = other._fn;
+#endif
+            RunEveryTimer::operator=(other);
+            _deadline_ms = other._deadline_ms;
+            _timing = other._timing;
+            _priority = other._priority;
+#ifdef LIBSMART_ENABLE_RUNEVERY_STATISTICS
+            _statistics = other._statistics;
+            _name = other._name;
+            _run_due_ms = other._run_due_ms;
+            _run_start_cycles = other._run_start_cycles;
+#endif
+            notifyScheduler();
+            return *this;
+        }
+
+        virtual ~RunEvery() {
+            if (_link.scheduler != nullptr) _link.scheduler->remove(*this);
+        }
 
         explicit RunEvery(const uint32_t interval_and_delay_ms)
-            : _delay_ms(interval_and_delay_ms),
-              _interval_ms(interval_and_delay_ms) { ; }
+            : RunEveryTimer(interval_and_delay_ms, interval_and_delay_ms) { ; }
 
         RunEvery(const uint32_t interval_ms, const uint32_t delay_ms)
-            : _delay_ms(delay_ms),
-              _interval_ms(interval_ms) { ; }
+            : RunEveryTimer(interval_ms, delay_ms) { ; }
 
         RunEvery(const uint32_t interval_ms, const uint32_t delay_ms, const uint32_t run_count_max)
-            : _run_count_max(run_count_max),
-              _delay_ms(delay_ms),
-              _interval_ms(interval_ms) { ; }
+            : RunEveryTimer(interval_ms, delay_ms, run_count_max) { ; }
 
 #ifdef LIBSMART_ENABLE_STD_FUNCTION
         using fn_t = std::function<void()>;
@@ -45,20 +132,16 @@ namespace Stm32Common {
         explicit RunEvery(const fn_t &fn) : RunEvery(0, fn) { ; }
 
         RunEvery(const uint32_t interval_and_delay_ms, fn_t fn)
-            : _fn(std::move(fn)),
-              _delay_ms(interval_and_delay_ms),
-              _interval_ms(interval_and_delay_ms) { ; }
+            : RunEveryTimer(interval_and_delay_ms, interval_and_delay_ms),
+              _fn(std::move(fn)) { ; }
 
         RunEvery(const uint32_t interval_ms, const uint32_t delay_ms, fn_t fn)
-            : _fn(std::move(fn)),
-              _delay_ms(delay_ms),
-              _interval_ms(interval_ms) { ; }
+            : RunEveryTimer(interval_ms, delay_ms),
+              _fn(std::move(fn)) { ; }
 
         RunEvery(const uint32_t interval_ms, const uint32_t delay_ms, const uint32_t run_count_max, fn_t fn)
-            : _fn(std::move(fn)),
-              _run_count_max(run_count_max),
-              _delay_ms(delay_ms),
-              _interval_ms(interval_ms) { ; }
+            : RunEveryTimer(interval_ms, delay_ms, run_count_max),
+              _fn(std::move(fn)) { ; }
 
         /**
          * @brief Set the function to be executed by the RunEvery object.
@@ -84,8 +167,9 @@ namespace Stm32Common {
          */
         virtual bool loop(const fn_t &loop_fn) {
             if (isSet()) {
+                beginRun(millis());
                 loop_fn();
-                reset();
+                endRun(millis());
                 return true;
             }
             return false;
@@ -121,7 +205,10 @@ namespace Stm32Common {
          *
          * @return void
          */
-        virtual void setInterval(const uint32_t interval_ms) { _interval_ms = interval_ms; }
+        virtual void setInterval(const uint32_t interval_ms) {
+            _interval_ms = interval_ms;
+            notifyScheduler();
+        }
 
 
         /**
@@ -134,7 +221,10 @@ namespace Stm32Common {
          *
          * @return void
          */
-        virtual void setDelay(const uint32_t delay_ms) { _delay_ms = delay_ms; }
+        virtual void setDelay(const uint32_t delay_ms) {
+            _delay_ms = delay_ms;
+            notifyScheduler();
+        }
 
 
         /**
@@ -147,7 +237,10 @@ namespace Stm32Common {
          *
          * @return void
          */
-        virtual void setRunCountMax(const uint32_t run_count_max) { _run_count_max = run_count_max; }
+        virtual void setRunCountMax(const uint32_t run_count_max) {
+            _run_count_max = run_count_max;
+            notifyScheduler();
+        }
 
 
         /**
@@ -168,8 +261,8 @@ namespace Stm32Common {
          * @return void
          */
         virtual void reset() {
-            _run_count++;
-            _last_last_run_ms = millis();
+            restartPeriod();
+            notifyScheduler();
         }
 
         /**
@@ -190,10 +283,62 @@ namespace Stm32Common {
          * @return The result of the evaluation as a boolean. Returns true if the object is set, false otherwise.
          */
         [[nodiscard]] virtual bool isSet() const {
-            return (_run_count_max == 0 || _run_count < _run_count_max) &&
-                   (_run_count == 0 ? elapsed() >= _delay_ms : elapsed() >= _interval_ms);
+            return !isFinished() && elapsed() >= getPeriod();
+        }
+
+        /**
+         * @brief Set how the next run time follows from the last one.
+         *
+         * @param timing The timing mode, RELATIVE by default.
+         */
+        void setTiming(const Timing timing) {
+            _timing = timing;
+            notifyScheduler();
+        }
+
+        /**
+         * @brief Set the priority. Of the objects that are due in the same Scheduler pass, higher priorities run
+         * first. The default is 0.
+         */
+        void setPriority(const uint8_t priority) {
+            _priority = priority;
+            notifyScheduler();
         }
 
+        [[nodiscard]] uint8_t getPriority() const { return _priority; }
+
+        /**
+         * @brief Set the deadline relative to the due time of a run.
+         *
+         * A run that ends later than deadline_ms after it became due counts as a deadline miss in the timing
+         * statistics.
+         *
+         * @param deadline_ms The deadline [ms], 0 for no deadline.
+         */
+        void setDeadline(const uint32_t deadline_ms) { _deadline_ms = deadline_ms; }
+
+        [[nodiscard]] uint32_t getDeadline() const { return _deadline_ms; }
+
+#ifdef LIBSMART_ENABLE_RUNEVERY_STATISTICS
+        [[nodiscard]] const TimingStatistics &getTimingStatistics() const { return _statistics; }
+
+        void resetTimingStatistics() { _statistics = {}; }
+
+        /**
+         * @brief Set the name that is shown in the statistics table of the Scheduler. The string is not copied.
+         */
+        void setName(const char *name) { _name = name; }
+
+        [[nodiscard]] const char *getName() const { return _name; }
+#endif
+
+        /**
+         * @brief Check if the RunEvery object is registered with a scheduler.
+         *
+         * @return true if a scheduler dispatches this object, false otherwise.
+         */
+        [[nodiscard]] bool isScheduled() const { return _link.scheduler != nullptr; }
+
         /**
          * @brief Executes the stored loop function at the defined interval.
          *
@@ -205,10 +350,9 @@ namespace Stm32Common {
          */
         virtual bool loop() {
             if (isSet()) {
-#ifdef LIBSMART_ENABLE_STD_FUNCTION
-                _fn();
-#endif
-                reset();
+                beginRun(millis());
+                run();
+                endRun(millis());
                 return true;
             }
             return false;
@@ -231,29 +375,104 @@ namespace Stm32Common {
 
     protected:
         /**
-         * @brief Represents the timestamp of the last execution of a particular function or task.
+         * @brief Executes the work of the RunEvery object.
+         *
+         * This method is called by loop() and by the Scheduler when the object is due. It calls the stored function.
+         * Derived classes may override it to do their work without std::function.
          */
-        uint32_t _last_last_run_ms = millis();
+        virtual void run() {
+#ifdef LIBSMART_ENABLE_STD_FUNCTION
+            _fn();
+#endif
+        }
 
         /**
-         * @brief Number of times the function has been executed.
+         * @brief Prepares a run that starts at the given time.
+         *
+         * Advances the phase, see RunEveryTimer::startPeriod(), and records the punctuality of the run.
+         *
+         * @param now_ms The start time of the run [ms].
          */
-        uint32_t _run_count = {};
+        void beginRun(const uint32_t now_ms) {
+#ifdef LIBSMART_ENABLE_RUNEVERY_STATISTICS
+            const RunStart start = startPeriod(now_ms);
+            _statistics.runs++;
+            if (start.lateness > 0) _statistics.lateRuns++;
+            if (_timing != Timing::RELATIVE && _timing != Timing::CATCH_UP) _statistics.skippedPeriods += start.missed;
+            if (start.lateness > _statistics.maxJitter_ms) _statistics.maxJitter_ms = start.lateness;
+            _statistics.totalJitter_ms += start.lateness;
+            _run_due_ms = start.due;
+            _run_start_cycles = Timebase::getCycles32();
+#else
+            startPeriod(now_ms);
+#endif
+        }
 
         /**
-         * @brief Maximum number of times the function can be run.
+         * @brief Finishes a run that has been started with beginRun().
+         *
+         * In the RELATIVE mode, the next interval starts now.
+         *
+         * @param now_ms The end time of the run [ms].
          */
-        uint32_t _run_count_max = {};
+        void endRun(const uint32_t now_ms) {
+            recordRunEnd(now_ms);
+            if (_timing == Timing::RELATIVE) {
+                reset();
+            } else {
+                notifyScheduler();
+            }
+        }
 
         /**
-         * @brief Represents the delay in milliseconds for the RunOnce utility class.
+         * @brief Records the execution time and a deadline miss of the run that has been started with beginRun().
+         *
+         * @param now_ms The end time of the run [ms].
          */
-        uint32_t _delay_ms = {};
+        void recordRunEnd(const uint32_t now_ms) {
+#ifdef LIBSMART_ENABLE_RUNEVERY_STATISTICS
+            const uint32_t cycles = Timebase::getCycles32() - _run_start_cycles;
+            _statistics.lastExecution_cycles = cycles;
+            if (cycles > _statistics.maxExecution_cycles) _statistics.maxExecution_cycles = cycles;
+            if (_deadline_ms != 0 && static_cast<int32_t>(now_ms - _run_due_ms) > static_cast<int32_t>(_deadline_ms)) {
+                _statistics.deadlineMisses++;
+            }
+#else
+            LIBSMART_UNUSED(now_ms);
+#endif
+        }
+
+        void notifyScheduler() {
+            if (_link.scheduler != nullptr) _link.scheduler->update(*this);
+        }
+
+        /**
+         * @brief Membership of the RunEvery object in a scheduler. Copies of a RunEvery object are not registered.
+         */
+        struct SchedulerLink {
+            SchedulerInterface *scheduler = nullptr;
+            size_t index = SIZE_MAX;
+
+            SchedulerLink() = default;
+
+            SchedulerLink(const SchedulerLink &) { ; }
+
+            SchedulerLink &operator=(const SchedulerLink &) { return *this; }
+        } _link;
 
         /**
-         * @brief The interval in milliseconds.
+         * @brief The deadline relative to the due time of a run, 0 for no deadline.
          */
-        uint32_t _interval_ms = {};
+        uint32_t _deadline_ms = {};
+
+        uint8_t _priority = {};
+
+#ifdef LIBSMART_ENABLE_RUNEVERY_STATISTICS
+        TimingStatistics _statistics = {};
+        const char *_name = {};
+        uint32_t _run_due_ms = {};
+        uint32_t _run_start_cycles = {};
+#endif
     };
 }
 #endif
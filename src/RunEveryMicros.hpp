@@ -0,0 +1,174 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef LIBSMART_STM32COMMON_RUNEVERYMICROS_HPP
+#define LIBSMART_STM32COMMON_RUNEVERYMICROS_HPP
+
+#include <libsmart_config.hpp>
+#include <cstdint>
+
+#ifdef LIBSMART_ENABLE_STD_FUNCTION
+
+#include <functional>
+#include <utility>
+
+#endif
+
+#include "RunEveryTimer.hpp"
+#include "Timebase.hpp"
+
+namespace Stm32Common {
+    /**
+     * @brief The time source of RunEveryMicros: Timebase::getMicros32().
+     */
+    struct MicrosTimeSource {
+        static uint32_t now() { return Timebase::getMicros32(); }
+
+        /**
+         * @brief The times of RunEveryMicros.
+         */
+        class State {
+        protected:
+            uint32_t _last_run_us = Timebase::getMicros32();
+            uint32_t _delay_us = {};
+            uint32_t _interval_us = {};
+
+            static constexpr uint32_t State::*LastRun = &State::_last_run_us;
+            static constexpr uint32_t State::*Delay = &State::_delay_us;
+            static constexpr uint32_t State::*Interval = &State::_interval_us;
+        };
+    };
+
+
+    /**
+     * @brief Like RunEvery, but with microsecond resolution from the Timebase.
+     *
+     * Timebase::begin() has to be called before the first use. Intervals and delays have to be shorter than
+     * 2^31 us (35 minutes). RunEveryMicros objects are polled with loop(), they are not dispatched by a Scheduler.
+     *
+     * @code
+     * Stm32Common::RunEveryMicros sample(250, []() { adc.trigger(); });
+     * sample.setTiming(Stm32Common::RunEveryMicros::Timing::CATCH_UP);
+     *
+     * void loop() {
+     *     sample.loop();
+     * }
+     * @endcode
+     */
+    class RunEveryMicros : public RunEveryTimer<MicrosTimeSource> {
+    public:
+        RunEveryMicros() = default;
+
+        virtual ~RunEveryMicros() = default;
+
+        explicit RunEveryMicros(const uint32_t interval_and_delay_us)
+            : RunEveryTimer(interval_and_delay_us, interval_and_delay_us) { ; }
+
+        RunEveryMicros(const uint32_t interval_us, const uint32_t delay_us)
+            : RunEveryTimer(interval_us, delay_us) { ; }
+
+        RunEveryMicros(const uint32_t interval_us, const uint32_t delay_us, const uint32_t run_count_max)
+            : RunEveryTimer(interval_us, delay_us, run_count_max) { ; }
+
+#ifdef LIBSMART_ENABLE_STD_FUNCTION
+        using fn_t = std::function<void()>;
+
+        RunEveryMicros(const uint32_t interval_and_delay_us, fn_t fn)
+            : RunEveryTimer(interval_and_delay_us, interval_and_delay_us),
+              _fn(std::move(fn)) { ; }
+
+        RunEveryMicros(const uint32_t interval_us, const uint32_t delay_us, fn_t fn)
+            : RunEveryTimer(interval_us, delay_us),
+              _fn(std::move(fn)) { ; }
+
+        /**
+         * @brief Set the function to be executed at the interval.
+         */
+        virtual void setFunction(fn_t fn) { this->_fn = std::move(fn); }
+
+        /**
+         * @brief Executes the given function if the interval has elapsed.
+         *
+         * @return true if the function has been executed, false otherwise.
+         */
+        virtual bool loop(const fn_t &loop_fn) {
+            if (isSet()) {
+                startPeriod(Timebase::getMicros32());
+                loop_fn();
+                endRun();
+                return true;
+            }
+            return false;
+        }
+
+    private:
+        fn_t _fn = []() { ; };
+#endif
+
+    public:
+        virtual void setInterval(const uint32_t interval_us) { _interval_us = interval_us; }
+
+        virtual void setDelay(const uint32_t delay_us) { _delay_us = delay_us; }
+
+        virtual void setRunCountMax(const uint32_t run_count_max) { _run_count_max = run_count_max; }
+
+        /**
+         * @brief Set how the next run time follows from the last one.
+         *
+         * @see RunTiming
+         */
+        void setTiming(const Timing timing) { _timing = timing; }
+
+        explicit operator bool() const { return isSet(); }
+
+        /**
+         * @brief Restarts the interval at the current time.
+         */
+        virtual void reset() { restartPeriod(); }
+
+        /**
+         * @brief Get the elapsed time since the last run [us].
+         */
+        [[nodiscard]] virtual uint32_t elapsed() const { return Timebase::getMicros32() - _last_run_us; }
+
+        [[nodiscard]] virtual bool isSet() const { return !isFinished() && elapsed() >= getPeriod(); }
+
+        /**
+         * @brief Executes the stored function if the interval has elapsed.
+         *
+         * @return true if the function has been executed, false otherwise.
+         */
+        virtual bool loop() {
+            if (isSet()) {
+                startPeriod(Timebase::getMicros32());
+                run();
+                endRun();
+                return true;
+            }
+            return false;
+        }
+
+        virtual bool loop(const uint32_t interval_us) {
+            setInterval(interval_us);
+            return loop();
+        }
+
+    protected:
+        /**
+         * @brief Executes the work of the object. Derived classes may override it to work without std::function.
+         */
+        virtual void run() {
+#ifdef LIBSMART_ENABLE_STD_FUNCTION
+            _fn();
+#endif
+        }
+
+        void endRun() {
+            if (_timing == Timing::RELATIVE) reset();
+        }
+    };
+}
+
+#endif
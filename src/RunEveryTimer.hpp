@@ -0,0 +1,192 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef LIBSMART_STM32COMMON_RUNEVERYTIMER_HPP
+#define LIBSMART_STM32COMMON_RUNEVERYTIMER_HPP
+
+#include <libsmart_config.hpp>
+#include <cstdint>
+
+namespace Stm32Common {
+    /**
+     * @brief Defines how the next run time follows from the last one.
+     */
+    enum class RunTiming : uint8_t {
+        /**
+         * The interval starts when the last run ends. Late runs delay all following runs. This is the default.
+         */
+        RELATIVE,
+
+        /**
+         * Phase-locked: the deadline advances by exactly one interval per run. Missed periods are run back to back
+         * until the object has caught up.
+         */
+        CATCH_UP,
+
+        /**
+         * Phase-locked: a late run executes once and the missed periods are dropped. The next run is on the next
+         * period boundary after the late run.
+         */
+        SKIP,
+
+        /**
+         * Phase-locked: like SKIP, but the run stands for all missed periods. getPeriodsInRun() tells the function
+         * how many periods it has to process, e.g. to integrate over the real time step.
+         */
+        COALESCE
+    };
+
+
+    /**
+     * @brief Interval, delay and phase of RunEvery and RunEveryMicros.
+     *
+     * The unit of all times is the unit of the time source. TimeSource::now() returns the current time as a
+     * wrapping 32 bit counter. Intervals and delays have to be shorter than 2^31 units.
+     *
+     * The last run time, the delay and the interval are members of TimeSource::State, so every derived class keeps
+     * its own member names for them, with their unit in the name. State names them with the member pointers
+     * LastRun, Delay and Interval.
+     *
+     * @tparam TimeSource A type with a static uint32_t now() method and a State base class.
+     */
+    template<typename TimeSource>
+    class RunEveryTimer : public TimeSource::State {
+        using State = typename TimeSource::State;
+
+    public:
+        using Timing = RunTiming;
+
+        RunEveryTimer() = default;
+
+        RunEveryTimer(const uint32_t interval, const uint32_t delay, const uint32_t run_count_max = 0)
+            : _run_count_max(run_count_max) {
+            delayTime() = delay;
+            intervalTime() = interval;
+        }
+
+        /**
+         * @brief Check if the maximum number of runs has been reached.
+         *
+         * @return true if the function will not be executed anymore, false otherwise.
+         */
+        [[nodiscard]] bool isFinished() const { return _run_count_max != 0 && _run_count >= _run_count_max; }
+
+        /**
+         * @brief Get the time source value at which the function is due.
+         */
+        [[nodiscard]] uint32_t getNextRunTime() const { return lastRunTime() + getPeriod(); }
+
+        /**
+         * @brief Get the interval between two runs.
+         */
+        [[nodiscard]] uint32_t getInterval() const { return intervalTime(); }
+
+        [[nodiscard]] Timing getTiming() const { return _timing; }
+
+        /**
+         * @brief Get the number of periods the current run stands for.
+         *
+         * This is 1, unless the timing mode is COALESCE and periods have been missed.
+         */
+        [[nodiscard]] uint32_t getPeriodsInRun() const { return _periods_in_run; }
+
+    protected:
+        /**
+         * @brief Describes the start of a run, as returned by startPeriod().
+         */
+        struct RunStart {
+            /** The time the run was due */
+            uint32_t due;
+
+            /** The time from the due time to the start of the run */
+            uint32_t lateness;
+
+            /** The number of whole periods that have been missed */
+            uint32_t missed;
+        };
+
+        /**
+         * @brief Advances the phase for a run that starts at the given time.
+         *
+         * In the phase-locked modes, the deadline moves to the next period boundary, so the run time of the function
+         * does not delay the following runs. The first run after the delay defines the phase, so it never misses
+         * periods and a late start does not cause a second run right after it. In the RELATIVE mode, the phase is
+         * left to finishPeriod().
+         *
+         * @param now The start time of the run.
+         */
+        RunStart startPeriod(const uint32_t now) {
+            const uint32_t due = getNextRunTime();
+            const uint32_t lateness = static_cast<int32_t>(now - due) > 0 ? now - due : 0;
+            const bool first = _run_count == 0;
+            const uint32_t interval = intervalTime();
+            const uint32_t missed = !first && interval > 0 ? lateness / interval : 0;
+
+            _periods_in_run = 1;
+            if (_timing != Timing::RELATIVE) {
+                lastRunTime() = first ? now : due;
+                _run_count++;
+                if (_timing != Timing::CATCH_UP && missed > 0) {
+                    lastRunTime() += missed * interval;
+                    if (_timing == Timing::COALESCE) _periods_in_run += missed;
+                }
+            }
+            return {due, lateness, missed};
+        }
+
+        /**
+         * @brief Counts a run and starts the next interval now.
+         */
+        void restartPeriod() {
+            _run_count++;
+            lastRunTime() = TimeSource::now();
+        }
+
+        /**
+         * @brief Get the time between the last and the next execution.
+         */
+        [[nodiscard]] uint32_t getPeriod() const { return _run_count == 0 ? delayTime() : intervalTime(); }
+
+        /**
+         * @brief The time of the last run, or the start of the delay before the first one.
+         */
+        uint32_t &lastRunTime() { return this->*State::LastRun; }
+
+        [[nodiscard]] uint32_t lastRunTime() const { return this->*State::LastRun; }
+
+        /**
+         * @brief The time from the construction to the first run.
+         */
+        uint32_t &delayTime() { return this->*State::Delay; }
+
+        [[nodiscard]] uint32_t delayTime() const { return this->*State::Delay; }
+
+        /**
+         * @brief The time between two runs.
+         */
+        uint32_t &intervalTime() { return this->*State::Interval; }
+
+        [[nodiscard]] uint32_t intervalTime() const { return this->*State::Interval; }
+
+        /**
+         * @brief Number of times the function has been executed.
+         */
+        uint32_t _run_count = {};
+
+        /**
+         * @brief Maximum number of times the function can be run, 0 for no limit.
+         */
+        uint32_t _run_count_max = {};
+
+        /**
+         * @brief Number of periods the current run stands for.
+         */
+        uint32_t _periods_in_run = 1;
+
+        Timing _timing = Timing::RELATIVE;
+    };
+}
+
+#endif
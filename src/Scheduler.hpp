@@ -0,0 +1,209 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef LIBSMART_STM32COMMON_SCHEDULER_HPP
+#define LIBSMART_STM32COMMON_SCHEDULER_HPP
+
+#include <libsmart_config.hpp>
+#include <cstddef>
+#include <cstdint>
+#include "Helper.hpp"
+#include "Profiler.hpp"
+#include "RunEvery.hpp"
+#include "SchedulerInterface.hpp"
+
+namespace Stm32Common {
+    /**
+     * @brief Dispatches up to MaxTasks RunEvery objects from a min-heap ordered by their next run time.
+     *
+     * Instead of calling loop() on every RunEvery object, the objects are registered once and the main loop only
+     * calls Scheduler::loop(). If no task is due, this costs one millis() call and one comparison. Due tasks are
+     * dispatched by priority (RunEvery::setPriority()), and tasks of the same priority in the order of their
+     * deadlines. Tasks are not preempted, so a long running task still delays all others; the deadline statistics
+     * of the tasks (RunEvery::setDeadline()) show when this happens.
+     *
+     * @code
+     * Stm32Common::RunEvery blink(500, []() { HAL_GPIO_TogglePin(LED_GPIO_Port, LED_Pin); });
+     * Stm32Common::RunOnce hello(1000, []() { session->println("Hello"); });
+     * Stm32Common::Scheduler<8> scheduler;
+     *
+     * void setup() {
+     *     scheduler.add(blink);
+     *     scheduler.add(hello);
+     * }
+     *
+     * void loop() {
+     *     scheduler.loop();
+     * }
+     * @endcode
+     *
+     * Registered objects keep their API: changing the interval, delay, run count, priority or timing, assigning
+     * another RunEvery or calling reset() reorders them automatically. Objects which reached their maximum run count
+     * are removed from the scheduler. A due object is dispatched with RunEvery::loop(), so overrides of loop(),
+     * isSet(), run() and reset() behave as without the scheduler. If isSet() holds a due object back, it is polled
+     * again a millisecond later.
+     *
+     * Deadlines are compared relative to each other, so they survive the millis() overflow as long as all
+     * intervals are shorter than 2^31 ms.
+     */
+    template<size_t MaxTasks>
+    class Scheduler : public SchedulerInterface {
+        static_assert(MaxTasks > 0, "Scheduler needs room for at least one task");
+
+    public:
+        Scheduler() = default;
+
+        Scheduler(const Scheduler &) = delete;
+
+        Scheduler &operator=(const Scheduler &) = delete;
+
+        ~Scheduler() override {
+            while (count > 0) remove(*heap[count - 1].task);
+        }
+
+        bool add(RunEvery &task) override {
+            if (task._link.scheduler == this) return true;
+            if (task.isFinished() || count >= MaxTasks) return false;
+            if (task._link.scheduler != nullptr) task._link.scheduler->remove(task);
+            task._link.scheduler = this;
+            task._link.index = count;
+            // A task that is added during a pass runs in the next pass at the earliest
+            heap[count].pass = pass;
+            heap[count++].task = &task;
+            update(task);
+            return true;
+        }
+
+        void remove(RunEvery &task) override {
+            if (task._link.scheduler != this) return;
+            const size_t index = task._link.index;
+            task._link.scheduler = nullptr;
+            task._link.index = NotQueued;
+            if (index != --count) {
+                place(index, heap[count]);
+                siftDown(siftUp(index));
+            }
+        }
+
+        void update(RunEvery &task) override {
+            if (task._link.scheduler != this) return;
+            if (task.isFinished()) {
+                remove(task);
+                return;
+            }
+            const size_t index = task._link.index;
+            heap[index].deadline = task.getNextRunTime();
+            heap[index].priority = task._priority;
+            siftDown(siftUp(index));
+        }
+
+        void loop() override {
+            if (count > 0) loop(millis());
+        }
+
+        void loop(const uint32_t now_ms) override {
+            // Every task runs at most once per pass, even if its interval is 0
+            pass++;
+            while (count > 0 && !isBefore(now_ms, heap[0].deadline)) {
+                const size_t index = selectDue(now_ms, 0);
+                if (index == NotQueued) return;
+                heap[index].pass = pass;
+                dispatch(*heap[index].task, now_ms);
+            }
+        }
+
+        [[nodiscard]] size_t getTaskCount() const override { return count; }
+
+        [[nodiscard]] uint32_t getNextDeadline() const override { return count > 0 ? heap[0].deadline : 0; }
+
+        [[nodiscard]] RunEvery *getTask(const size_t index) const override {
+            return index < count ? heap[index].task : nullptr;
+        }
+
+        [[nodiscard]] static constexpr size_t getMaxTasks() { return MaxTasks; }
+
+    private:
+        static constexpr size_t NotQueued = SIZE_MAX;
+
+        struct Entry {
+            uint32_t deadline;
+            uint8_t priority;
+            uint8_t pass; // The last pass in which the task has been dispatched
+            RunEvery *task;
+        };
+
+        static bool isBefore(const uint32_t a, const uint32_t b) { return static_cast<int32_t>(a - b) < 0; }
+
+        /**
+         * @brief Returns the index of the due task with the highest priority in the subtree at index, of the tasks
+         * that have not run in the current pass. NotQueued if there is none.
+         *
+         * Due tasks form a connected subtree at the root of the heap, so the search stops at the first task that
+         * is not due.
+         */
+        size_t selectDue(const uint32_t now_ms, const size_t index) const {
+            size_t best = heap[index].pass != pass ? index : NotQueued;
+            for (size_t child = 2 * index + 1; child <= 2 * index + 2 && child < count; child++) {
+                if (isBefore(now_ms, heap[child].deadline)) continue;
+                const size_t candidate = selectDue(now_ms, child);
+                if (candidate == NotQueued) continue;
+                if (best == NotQueued
+                    || heap[candidate].priority > heap[best].priority
+                    || (heap[candidate].priority == heap[best].priority
+                        && isBefore(heap[candidate].deadline, heap[best].deadline))) {
+                    best = candidate;
+                }
+            }
+            return best;
+        }
+
+        void dispatch(RunEvery &task, const uint32_t now_ms) {
+            PROFILE_ZONE("RunEvery");
+            // loop() reorders the task through its setters or reset(), or removes it when it is finished
+            if (task.loop()) return;
+            // A derived class holds the task back, poll it again in the next millisecond
+            const size_t index = task._link.index;
+            heap[index].deadline = now_ms + 1;
+            siftDown(index);
+        }
+
+        void place(const size_t index, const Entry &entry) {
+            heap[index] = entry;
+            entry.task->_link.index = index;
+        }
+
+        size_t siftUp(size_t index) {
+            const Entry entry = heap[index];
+            while (index > 0) {
+                const size_t parent = (index - 1) / 2;
+                if (!isBefore(entry.deadline, heap[parent].deadline)) break;
+                place(index, heap[parent]);
+                index = parent;
+            }
+            place(index, entry);
+            return index;
+        }
+
+        size_t siftDown(size_t index) {
+            const Entry entry = heap[index];
+            while (true) {
+                size_t child = 2 * index + 1;
+                if (child >= count) break;
+                if (child + 1 < count && isBefore(heap[child + 1].deadline, heap[child].deadline)) child++;
+                if (!isBefore(heap[child].deadline, entry.deadline)) break;
+                place(index, heap[child]);
+                index = child;
+            }
+            place(index, entry);
+            return index;
+        }
+
+        Entry heap[MaxTasks] = {};
+        size_t count = 0;
+        uint8_t pass = 0;
+    };
+}
+
+#endif
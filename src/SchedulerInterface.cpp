@@ -0,0 +1,42 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "SchedulerInterface.hpp"
+#include "PrintColumn.hpp"
+#include "RunEvery.hpp"
+#include "Timebase.hpp"
+
+using namespace Stm32Common;
+
+size_t SchedulerInterface::printTo(Print &printObject) const {
+#ifdef LIBSMART_ENABLE_RUNEVERY_STATISTICS
+    size_t n = printObject.println(
+        "task             prio   interval       runs       late     misses  maxjitter    wcet_us");
+#else
+    size_t n = printObject.println("task             prio   interval");
+#endif
+    for (size_t i = 0; i < getTaskCount(); i++) {
+        const RunEvery *task = getTask(i);
+#ifdef LIBSMART_ENABLE_RUNEVERY_STATISTICS
+        const char *name = task->getName() == nullptr ? "-" : task->getName();
+#else
+        const char *name = "-";
+#endif
+        n += printTextColumn(printObject, name, 16);
+        n += printColumn(printObject, task->getPriority(), 5);
+        n += printColumn(printObject, task->getInterval(), 11);
+#ifdef LIBSMART_ENABLE_RUNEVERY_STATISTICS
+        const RunEvery::TimingStatistics &statistics = task->getTimingStatistics();
+        n += printColumn(printObject, statistics.runs, 11);
+        n += printColumn(printObject, statistics.lateRuns, 11);
+        n += printColumn(printObject, statistics.deadlineMisses, 11);
+        n += printColumn(printObject, statistics.maxJitter_ms, 11);
+        n += printColumn(printObject, static_cast<uint32_t>(Timebase::cyclesToMicros(statistics.maxExecution_cycles)),
+                         11);
+#endif
+        n += printObject.println();
+    }
+    return n;
+}
@@ -0,0 +1,99 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef LIBSMART_STM32COMMON_SCHEDULERINTERFACE_HPP
+#define LIBSMART_STM32COMMON_SCHEDULERINTERFACE_HPP
+
+#include <libsmart_config.hpp>
+#include <cstddef>
+#include <cstdint>
+#include "Printable.hpp"
+
+namespace Stm32Common {
+    class RunEvery;
+
+    /**
+     * @brief Dispatches RunEvery objects in the order of their deadlines.
+     *
+     * printTo() prints a table with the priority, interval and timing statistics of all tasks.
+     *
+     * @see Scheduler
+     */
+    class SchedulerInterface : public Printable {
+    public:
+        virtual ~SchedulerInterface() = default;
+
+        /**
+         * @brief Registers a task with the scheduler.
+         *
+         * A task that is registered with another scheduler is moved to this one. A task is removed automatically
+         * when it reaches its maximum run count or is destroyed.
+         *
+         * @param task The task to register.
+         * @return true if the task has been registered, false if the scheduler is full or the task is finished.
+         */
+        virtual bool add(RunEvery &task) = 0;
+
+        /**
+         * @brief Unregisters a task. Unregistered tasks are ignored.
+         */
+        virtual void remove(RunEvery &task) = 0;
+
+        /**
+         * @brief Reorders a task after its interval, delay, run count or last run time has changed.
+         *
+         * RunEvery calls this automatically from its setters, its copy assignment and from reset().
+         */
+        virtual void update(RunEvery &task) = 0;
+
+        /**
+         * @brief Runs all tasks which are due at the current millis() value.
+         */
+        virtual void loop() = 0;
+
+        /**
+         * @brief Runs all tasks which are due at the given time.
+         *
+         * @param now_ms The current time [ms], a millis() value that has just been read. The tasks still check
+         * with RunEvery::isSet() whether they are due.
+         */
+        virtual void loop(uint32_t now_ms) = 0;
+
+        /**
+         * @brief Returns the number of registered tasks.
+         */
+        [[nodiscard]] virtual size_t getTaskCount() const = 0;
+
+        /**
+         * @brief Returns the earliest deadline of all registered tasks.
+         *
+         * The result is only meaningful if getTaskCount() is not 0.
+         */
+        [[nodiscard]] virtual uint32_t getNextDeadline() const = 0;
+
+        /**
+         * @brief Returns the task at the given position, 0 to getTaskCount() - 1. The order changes with every
+         * dispatch.
+         */
+        [[nodiscard]] virtual RunEvery *getTask(size_t index) const = 0;
+
+        /**
+         * @brief Returns the time until the earliest deadline.
+         *
+         * @param now_ms The current time [ms].
+         * @return The time until the next task is due [ms], 0 if a task is due already or UINT32_MAX if no task
+         * is registered.
+         */
+        [[nodiscard]] uint32_t getTimeUntilNextDeadline(const uint32_t now_ms) const {
+            if (getTaskCount() == 0) return UINT32_MAX;
+            const auto remaining = static_cast<int32_t>(getNextDeadline() - now_ms);
+            return remaining > 0 ? static_cast<uint32_t>(remaining) : 0;
+        }
+
+        size_t printTo(Print &printObject) const override;
+    };
+}
+
+#endif
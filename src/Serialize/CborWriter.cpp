@@ -0,0 +1,225 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <cstring>
+#include "CborWriter.hpp"
+
+using namespace Stm32Common::Serialize;
+
+void CborWriter::reset() {
+    bytesWritten = 0;
+    depth = 0;
+    rootWritten = false;
+    error = false;
+}
+
+void CborWriter::write(const void *data, const size_t length) {
+    if (error || length == 0) return;
+    const size_t written = out.write(static_cast<const uint8_t *>(data), length);
+    bytesWritten += written;
+    if (written != length) error = true;
+}
+
+void CborWriter::writeHead(const MajorType type, const uint64_t argument) {
+    uint8_t head[9];
+    size_t length;
+    const auto initial = static_cast<uint8_t>(type << 5);
+
+    if (argument < 24) {
+        head[0] = initial | static_cast<uint8_t>(argument);
+        length = 1;
+    } else if (argument <= UINT8_MAX) {
+        head[0] = initial | 24;
+        length = 2;
+    } else if (argument <= UINT16_MAX) {
+        head[0] = initial | 25;
+        length = 3;
+    } else if (argument <= UINT32_MAX) {
+        head[0] = initial | 26;
+        length = 5;
+    } else {
+        head[0] = initial | 27;
+        length = 9;
+    }
+
+    // Argument in network byte order
+    for (size_t i = length - 1, shift = 0; i > 0; i--, shift += 8) {
+        head[i] = static_cast<uint8_t>(argument >> shift);
+    }
+    write(head, length);
+}
+
+bool CborWriter::beforeItem() {
+    if (error) return false;
+    if (depth == 0) {
+        if (rootWritten) {
+            error = true;
+            return false;
+        }
+        rootWritten = true;
+        return true;
+    }
+    uint32_t &left = remaining[depth - 1];
+    if (left == IndefiniteMap) {
+        left = IndefiniteMapValue;
+    } else if (left == IndefiniteMapValue) {
+        left = IndefiniteMap;
+    } else if (left != Indefinite) {
+        if (left == 0) {
+            error = true;
+            return false;
+        }
+        left--;
+    }
+    return true;
+}
+
+CborWriter &CborWriter::begin(const MajorType type, const uint32_t items) {
+    if (depth >= MaxDepth) {
+        error = true;
+        return *this;
+    }
+    if (!beforeItem()) return *this;
+
+    if (items == Indefinite) {
+        const uint8_t head = static_cast<uint8_t>(type << 5) | 31;
+        write(&head, 1);
+    } else {
+        writeHead(type, items);
+    }
+
+    // A map holds a key and a value per pair
+    if (items == Indefinite) {
+        remaining[depth++] = type == MAP ? IndefiniteMap : Indefinite;
+    } else {
+        remaining[depth++] = type == ARRAY ? items : items * 2;
+    }
+    return *this;
+}
+
+CborWriter &CborWriter::beginArray() {
+    return begin(ARRAY, Indefinite);
+}
+
+CborWriter &CborWriter::beginArray(const size_t items) {
+    // Larger counts are the Indefinite states of the nesting stack
+    if (items > MaxItems) {
+        error = true;
+        return *this;
+    }
+    return begin(ARRAY, static_cast<uint32_t>(items));
+}
+
+CborWriter &CborWriter::beginMap() {
+    return begin(MAP, Indefinite);
+}
+
+CborWriter &CborWriter::beginMap(const size_t pairs) {
+    // The stack counts keys and values
+    if (pairs > MaxItems / 2) {
+        error = true;
+        return *this;
+    }
+    return begin(MAP, static_cast<uint32_t>(pairs));
+}
+
+CborWriter &CborWriter::end() {
+    if (error) return *this;
+    if (depth == 0) {
+        error = true;
+        return *this;
+    }
+    const uint32_t left = remaining[--depth];
+    if (left == Indefinite || left == IndefiniteMap) {
+        constexpr uint8_t breakCode = 0xff;
+        write(&breakCode, 1);
+    } else if (left != 0) {
+        // Also a key without a value in an indefinite map
+        error = true;
+    }
+    return *this;
+}
+
+CborWriter &CborWriter::value(const char *value) {
+    if (value == nullptr) return nullValue();
+    return this->value(value, strlen(value));
+}
+
+CborWriter &CborWriter::value(const char *value, const size_t length) {
+    if (!beforeItem()) return *this;
+    writeHead(TEXT_STRING, length);
+    write(value, length);
+    return *this;
+}
+
+CborWriter &CborWriter::bytes(const void *data, const size_t length) {
+    if (!beforeItem()) return *this;
+    writeHead(BYTE_STRING, length);
+    write(data, length);
+    return *this;
+}
+
+CborWriter &CborWriter::value(const bool value) {
+    if (beforeItem()) writeHead(SIMPLE, value ? 21 : 20);
+    return *this;
+}
+
+CborWriter &CborWriter::nullValue() {
+    if (beforeItem()) writeHead(SIMPLE, 22);
+    return *this;
+}
+
+CborWriter &CborWriter::writeUnsigned(const unsigned long long value) {
+    if (beforeItem()) writeHead(UNSIGNED_INT, value);
+    return *this;
+}
+
+CborWriter &CborWriter::writeSigned(const long long value) {
+    if (!beforeItem()) return *this;
+    if (value < 0) {
+        // Negative integers are encoded as -1 - n
+        writeHead(NEGATIVE_INT, static_cast<uint64_t>(-(value + 1)));
+    } else {
+        writeHead(UNSIGNED_INT, static_cast<uint64_t>(value));
+    }
+    return *this;
+}
+
+CborWriter &CborWriter::value(const float value) {
+    if (!beforeItem()) return *this;
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof bits);
+    const uint8_t item[5] = {
+        0xfa,
+        static_cast<uint8_t>(bits >> 24), static_cast<uint8_t>(bits >> 16),
+        static_cast<uint8_t>(bits >> 8), static_cast<uint8_t>(bits)
+    };
+    write(item, sizeof item);
+    return *this;
+}
+
+CborWriter &CborWriter::value(const double value) {
+    const auto single = static_cast<float>(value);
+    if (static_cast<double>(single) == value || value != value) {
+        return this->value(single);
+    }
+
+    if (!beforeItem()) return *this;
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof bits);
+    uint8_t item[9];
+    item[0] = 0xfb;
+    for (size_t i = 8, shift = 0; i > 0; i--, shift += 8) {
+        item[i] = static_cast<uint8_t>(bits >> shift);
+    }
+    write(item, sizeof item);
+    return *this;
+}
+
+CborWriter &CborWriter::tag(const uint64_t tag) {
+    // A tag and its content form one item, so the tag itself is not counted
+    if (!error) writeHead(TAG, tag);
+    return *this;
+}
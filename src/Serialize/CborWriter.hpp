@@ -0,0 +1,157 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef LIBSMART_STM32COMMON_SERIALIZE_CBORWRITER_HPP
+#define LIBSMART_STM32COMMON_SERIALIZE_CBORWRITER_HPP
+
+#include <libsmart_config.hpp>
+#include <cstddef>
+#include <cstdint>
+#include "Print.hpp"
+
+namespace Stm32Common::Serialize {
+    /**
+     * @brief Streaming CBOR (RFC 8949) encoder that writes directly to a Print object.
+     *
+     * Arrays and maps are written with a definite length if the number of items is passed to beginArray() or
+     * beginMap(), and with an indefinite length otherwise. Nesting is tracked on a fixed stack of MaxDepth levels.
+     * For definite containers, end() verifies that the announced number of items has been written, for indefinite
+     * maps that every key got a value.
+     *
+     * @code
+     * Stm32Common::Serialize::CborWriter cbor(*session);
+     * cbor.beginMap(2);
+     * cbor.key("uptime").value(millis());
+     * cbor.key("temperature").value(21.5f);
+     * cbor.end();
+     * @endcode
+     *
+     * Errors are sticky and can be checked with hasError(). After an error, no more output is produced.
+     */
+    class CborWriter {
+    public:
+        static constexpr uint8_t MaxDepth = 16;
+
+        /**
+         * @brief The largest number of items of a definite container, a map holds MaxItems / 2 pairs. Larger counts
+         * set the error flag.
+         */
+        static constexpr uint32_t MaxItems = UINT32_MAX - 3;
+
+        explicit CborWriter(Print &out) : out(out) { ; }
+
+        /**
+         * @brief Starts an array with an indefinite number of items.
+         */
+        CborWriter &beginArray();
+
+        /**
+         * @brief Starts an array with a definite number of items.
+         */
+        CborWriter &beginArray(size_t items);
+
+        /**
+         * @brief Starts a map with an indefinite number of key/value pairs.
+         */
+        CborWriter &beginMap();
+
+        /**
+         * @brief Starts a map with a definite number of key/value pairs.
+         */
+        CborWriter &beginMap(size_t pairs);
+
+        /**
+         * @brief Ends the innermost array or map.
+         */
+        CborWriter &end();
+
+        /**
+         * @brief Writes a text string as map key. This is the same as value(key).
+         */
+        CborWriter &key(const char *key) { return value(key); }
+
+        CborWriter &value(const char *value);
+
+        CborWriter &value(const char *value, size_t length);
+
+        /**
+         * @brief Writes a byte string.
+         */
+        CborWriter &bytes(const void *data, size_t length);
+
+        CborWriter &value(bool value);
+
+        CborWriter &value(int value) { return writeSigned(value); }
+
+        CborWriter &value(long value) { return writeSigned(value); }
+
+        CborWriter &value(long long value) { return writeSigned(value); }
+
+        CborWriter &value(unsigned int value) { return writeUnsigned(value); }
+
+        CborWriter &value(unsigned long value) { return writeUnsigned(value); }
+
+        CborWriter &value(unsigned long long value) { return writeUnsigned(value); }
+
+        CborWriter &value(float value);
+
+        /**
+         * @brief Writes a double. It is written as single precision float if that is lossless.
+         */
+        CborWriter &value(double value);
+
+        CborWriter &nullValue();
+
+        /**
+         * @brief Writes a semantic tag for the following item.
+         */
+        CborWriter &tag(uint64_t tag);
+
+        [[nodiscard]] bool isComplete() const { return !error && depth == 0 && rootWritten; }
+
+        [[nodiscard]] bool hasError() const { return error; }
+
+        [[nodiscard]] size_t getBytesWritten() const { return bytesWritten; }
+
+        void reset();
+
+    private:
+        static constexpr uint32_t Indefinite = UINT32_MAX; // Indefinite array
+        static constexpr uint32_t IndefiniteMap = UINT32_MAX - 1; // Indefinite map, next item is a key
+        static constexpr uint32_t IndefiniteMapValue = UINT32_MAX - 2; // Indefinite map, next item is a value
+
+        enum MajorType : uint8_t {
+            UNSIGNED_INT = 0,
+            NEGATIVE_INT = 1,
+            BYTE_STRING = 2,
+            TEXT_STRING = 3,
+            ARRAY = 4,
+            MAP = 5,
+            TAG = 6,
+            SIMPLE = 7
+        };
+
+        CborWriter &writeSigned(long long value);
+
+        CborWriter &writeUnsigned(unsigned long long value);
+
+        CborWriter &begin(MajorType type, uint32_t items);
+
+        bool beforeItem();
+
+        void writeHead(MajorType type, uint64_t argument);
+
+        void write(const void *data, size_t length);
+
+        Print &out;
+        size_t bytesWritten = 0;
+        uint32_t remaining[MaxDepth] = {}; // Items left in a definite container, or one of the Indefinite states
+        uint8_t depth = 0;
+        bool rootWritten = false;
+        bool error = false;
+    };
+}
+
+#endif
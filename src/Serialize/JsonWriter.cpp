@@ -0,0 +1,274 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <cmath>
+#include <cstring>
+#include "JsonWriter.hpp"
+
+using namespace Stm32Common::Serialize;
+
+namespace {
+    constexpr char hexDigits[] = "0123456789abcdef";
+
+    bool needsEscape(const uint8_t c) {
+        return c < 0x20 || c == '"' || c == '\\';
+    }
+
+    char *formatUnsigned(char *out, uint32_t value) {
+        char digits[10];
+        size_t count = 0;
+        do {
+            digits[count++] = static_cast<char>('0' + value % 10);
+            value /= 10;
+        } while (value);
+        while (count > 0) *out++ = digits[--count];
+        return out;
+    }
+}
+
+void JsonWriter::reset() {
+    bytesWritten = 0;
+    arrayMask = 0;
+    nonEmptyMask = 0;
+    depth = 0;
+    expectingValue = false;
+    rootWritten = false;
+    error = false;
+}
+
+void JsonWriter::write(const char *str, const size_t length) {
+    if (error || length == 0) return;
+    const size_t written = out.write(str, length);
+    bytesWritten += written;
+    if (written != length) error = true;
+}
+
+void JsonWriter::writeString(const char *str, const size_t length) {
+    write('"');
+    size_t runStart = 0;
+    for (size_t i = 0; i < length; i++) {
+        const auto c = static_cast<uint8_t>(str[i]);
+        if (!needsEscape(c)) continue;
+
+        // Write the run of characters that need no escaping in one go
+        write(str + runStart, i - runStart);
+        runStart = i + 1;
+
+        char escape[6] = {'\\', 0, 0, 0, 0, 0};
+        size_t escapeLength = 2;
+        switch (c) {
+            case '"': escape[1] = '"';
+                break;
+            case '\\': escape[1] = '\\';
+                break;
+            case '\b': escape[1] = 'b';
+                break;
+            case '\f': escape[1] = 'f';
+                break;
+            case '\n': escape[1] = 'n';
+                break;
+            case '\r': escape[1] = 'r';
+                break;
+            case '\t': escape[1] = 't';
+                break;
+            default:
+                escape[1] = 'u';
+                escape[2] = '0';
+                escape[3] = '0';
+                escape[4] = hexDigits[c >> 4];
+                escape[5] = hexDigits[c & 0x0f];
+                escapeLength = 6;
+        }
+        write(escape, escapeLength);
+    }
+    write(str + runStart, length - runStart);
+    write('"');
+}
+
+bool JsonWriter::beforeValue() {
+    if (error) return false;
+    if (depth == 0) {
+        if (rootWritten) {
+            error = true;
+            return false;
+        }
+        rootWritten = true;
+        return true;
+    }
+
+    const uint32_t levelBit = 1UL << (depth - 1);
+    if (isInArray()) {
+        if (nonEmptyMask & levelBit) write(',');
+        nonEmptyMask |= levelBit;
+        return !error;
+    }
+
+    // Inside an object, every value needs a key
+    if (!expectingValue) {
+        error = true;
+        return false;
+    }
+    expectingValue = false;
+    return !error;
+}
+
+JsonWriter &JsonWriter::begin(const bool isArray, const char bracket) {
+    if (depth >= MaxDepth) {
+        error = true;
+        return *this;
+    }
+    if (!beforeValue()) return *this;
+    depth++;
+    const uint32_t levelBit = 1UL << (depth - 1);
+    if (isArray) arrayMask |= levelBit;
+    else arrayMask &= ~levelBit;
+    nonEmptyMask &= ~levelBit;
+    write(bracket);
+    return *this;
+}
+
+JsonWriter &JsonWriter::end(const bool isArray, const char bracket) {
+    if (error) return *this;
+    if (depth == 0 || isInArray() != isArray || expectingValue) {
+        error = true;
+        return *this;
+    }
+    depth--;
+    write(bracket);
+    return *this;
+}
+
+JsonWriter &JsonWriter::beginObject() {
+    return begin(false, '{');
+}
+
+JsonWriter &JsonWriter::endObject() {
+    return end(false, '}');
+}
+
+JsonWriter &JsonWriter::beginArray() {
+    return begin(true, '[');
+}
+
+JsonWriter &JsonWriter::endArray() {
+    return end(true, ']');
+}
+
+JsonWriter &JsonWriter::key(const char *key) {
+    if (error) return *this;
+    if (key == nullptr || depth == 0 || isInArray() || expectingValue) {
+        error = true;
+        return *this;
+    }
+    const uint32_t levelBit = 1UL << (depth - 1);
+    if (nonEmptyMask & levelBit) write(',');
+    nonEmptyMask |= levelBit;
+    writeString(key, strlen(key));
+    write(':');
+    expectingValue = true;
+    return *this;
+}
+
+JsonWriter &JsonWriter::value(const char *value) {
+    if (value == nullptr) return nullValue();
+    return this->value(value, strlen(value));
+}
+
+JsonWriter &JsonWriter::value(const char *value, const size_t length) {
+    if (beforeValue()) writeString(value, length);
+    return *this;
+}
+
+JsonWriter &JsonWriter::value(const bool value) {
+    if (beforeValue()) {
+        if (value) write("true", 4);
+        else write("false", 5);
+    }
+    return *this;
+}
+
+JsonWriter &JsonWriter::writeUnsigned(unsigned long long value) {
+    if (!beforeValue()) return *this;
+    char buf[20];
+    char *p = buf + sizeof buf;
+    do {
+        *--p = static_cast<char>('0' + value % 10);
+        value /= 10;
+    } while (value);
+    write(p, buf + sizeof buf - p);
+    return *this;
+}
+
+JsonWriter &JsonWriter::writeSigned(const long long value) {
+    if (!beforeValue()) return *this;
+    char buf[21];
+    char *p = buf + sizeof buf;
+    unsigned long long magnitude = value < 0
+                                       ? 0ULL - static_cast<unsigned long long>(value)
+                                       : static_cast<unsigned long long>(value);
+    do {
+        *--p = static_cast<char>('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude);
+    if (value < 0) *--p = '-';
+    write(p, buf + sizeof buf - p);
+    return *this;
+}
+
+JsonWriter &JsonWriter::value(const double value, uint8_t digits) {
+    if (!std::isfinite(value)) return nullValue();
+    if (!beforeValue()) return *this;
+
+    // Print::print(double) writes "ovf" or nothing for large numbers, depending on the printf profile, so the
+    // number is formatted here. From 1e9 on, the mantissa is written with an exponent.
+    if (digits > 9) digits = 9;
+    char buf[32];
+    char *p = buf;
+    double magnitude = value;
+    if (magnitude < 0) {
+        *p++ = '-';
+        magnitude = -magnitude;
+    }
+    int exponent = 0;
+    if (magnitude >= 1e9) {
+        exponent = static_cast<int>(std::floor(std::log10(magnitude)));
+        magnitude /= std::pow(10.0, exponent);
+    }
+    double rounding = 0.5;
+    for (uint8_t i = 0; i < digits; i++) rounding /= 10.0;
+    magnitude += rounding;
+    if (exponent > 0 && magnitude >= 10.0) {
+        magnitude /= 10.0;
+        exponent++;
+    }
+
+    const auto integer = static_cast<uint32_t>(magnitude);
+    double fraction = magnitude - integer;
+    p = formatUnsigned(p, integer);
+    if (digits > 0) *p++ = '.';
+    while (digits-- > 0) {
+        fraction *= 10.0;
+        const auto digit = static_cast<uint8_t>(fraction);
+        *p++ = static_cast<char>('0' + digit);
+        fraction -= digit;
+    }
+    if (exponent > 0) {
+        *p++ = 'e';
+        p = formatUnsigned(p, static_cast<uint32_t>(exponent));
+    }
+    write(buf, p - buf);
+    return *this;
+}
+
+JsonWriter &JsonWriter::nullValue() {
+    if (beforeValue()) write("null", 4);
+    return *this;
+}
+
+JsonWriter &JsonWriter::rawValue(const char *json) {
+    if (json == nullptr) return nullValue();
+    if (beforeValue()) write(json, strlen(json));
+    return *this;
+}
@@ -0,0 +1,143 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef LIBSMART_STM32COMMON_SERIALIZE_JSONWRITER_HPP
+#define LIBSMART_STM32COMMON_SERIALIZE_JSONWRITER_HPP
+
+#include <libsmart_config.hpp>
+#include <cstddef>
+#include <cstdint>
+#include "Print.hpp"
+
+namespace Stm32Common::Serialize {
+    /**
+     * @brief Streaming JSON writer that writes directly to a Print object.
+     *
+     * The writer does not allocate memory and does not build an intermediate string. Nesting is tracked on a fixed
+     * stack of MaxDepth levels. Separators are inserted automatically.
+     *
+     * @code
+     * Stm32Common::Serialize::JsonWriter json(*session);
+     * json.beginObject();
+     * json.member("uptime", millis());
+     * json.member("temperature", 21.5, 1);
+     * json.key("channels").beginArray();
+     * json.value(1).value(2).value(3);
+     * json.endArray();
+     * json.endObject();
+     * // {"uptime":123456,"temperature":21.5,"channels":[1,2,3]}
+     * @endcode
+     *
+     * Errors (wrong nesting, missing key, too deep, write failure) are sticky and can be checked with hasError().
+     * After an error, no more output is produced.
+     */
+    class JsonWriter {
+    public:
+        static constexpr uint8_t MaxDepth = 32;
+
+        explicit JsonWriter(Print &out) : out(out) { ; }
+
+        JsonWriter &beginObject();
+
+        JsonWriter &endObject();
+
+        JsonWriter &beginArray();
+
+        JsonWriter &endArray();
+
+        /**
+         * @brief Writes the key of the next object member.
+         *
+         * @param key The null-terminated key. It is escaped as needed.
+         */
+        JsonWriter &key(const char *key);
+
+        JsonWriter &value(const char *value);
+
+        JsonWriter &value(const char *value, size_t length);
+
+        JsonWriter &value(bool value);
+
+        JsonWriter &value(int value) { return writeSigned(value); }
+
+        JsonWriter &value(long value) { return writeSigned(value); }
+
+        JsonWriter &value(long long value) { return writeSigned(value); }
+
+        JsonWriter &value(unsigned int value) { return writeUnsigned(value); }
+
+        JsonWriter &value(unsigned long value) { return writeUnsigned(value); }
+
+        JsonWriter &value(unsigned long long value) { return writeUnsigned(value); }
+
+        /**
+         * @brief Writes a floating point value with a fixed number of decimals, at most 9.
+         *
+         * Values from 1e9 on are written with an exponent, e.g. 1.50e12. NaN and infinity are not valid JSON and are
+         * written as null. The output does not depend on the printf profile.
+         */
+        JsonWriter &value(double value, uint8_t digits = 2);
+
+        JsonWriter &nullValue();
+
+        /**
+         * @brief Writes a value that is already valid JSON, without escaping.
+         */
+        JsonWriter &rawValue(const char *json);
+
+        template<typename T>
+        JsonWriter &member(const char *name, T memberValue) {
+            return key(name).value(memberValue);
+        }
+
+        JsonWriter &member(const char *name, double memberValue, uint8_t digits) {
+            return key(name).value(memberValue, digits);
+        }
+
+        /**
+         * @brief Checks if a complete JSON value has been written and all containers are closed.
+         */
+        [[nodiscard]] bool isComplete() const { return !error && depth == 0 && rootWritten; }
+
+        [[nodiscard]] bool hasError() const { return error; }
+
+        [[nodiscard]] size_t getBytesWritten() const { return bytesWritten; }
+
+        /**
+         * @brief Resets the writer, so a new document can be written to the same Print object.
+         */
+        void reset();
+
+    private:
+        JsonWriter &writeSigned(long long value);
+
+        JsonWriter &writeUnsigned(unsigned long long value);
+
+        JsonWriter &begin(bool isArray, char bracket);
+
+        JsonWriter &end(bool isArray, char bracket);
+
+        bool beforeValue();
+
+        void writeString(const char *str, size_t length);
+
+        void write(const char *str, size_t length);
+
+        void write(char c) { write(&c, 1); }
+
+        [[nodiscard]] bool isInArray() const { return (arrayMask >> (depth - 1)) & 1U; }
+
+        Print &out;
+        size_t bytesWritten = 0;
+        uint32_t arrayMask = 0; // bit n set: level n+1 is an array
+        uint32_t nonEmptyMask = 0; // bit n set: level n+1 already holds an element
+        uint8_t depth = 0;
+        bool expectingValue = false;
+        bool rootWritten = false;
+        bool error = false;
+    };
+}
+
+#endif
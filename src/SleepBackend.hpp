@@ -0,0 +1,87 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef LIBSMART_STM32COMMON_SLEEPBACKEND_HPP
+#define LIBSMART_STM32COMMON_SLEEPBACKEND_HPP
+
+#include <libsmart_config.hpp>
+#include <cstdint>
+#include "Helper.hpp"
+
+namespace Stm32Common {
+    /**
+     * @brief Puts the core to sleep for Idle.
+     *
+     * @see Idle
+     */
+    class SleepBackendInterface {
+    public:
+        virtual ~SleepBackendInterface() = default;
+
+        /**
+         * @brief Returns the time base used for deadlines [ms].
+         */
+        [[nodiscard]] virtual uint32_t getTime() { return millis(); }
+
+        /**
+         * @brief Sleeps until the given time has passed or until a wake-up has been requested.
+         *
+         * @param duration_ms The maximum time to sleep [ms].
+         * @param wakeUpRequested Set by Idle::wakeUp(), possibly from an ISR.
+         */
+        virtual void sleep(uint32_t duration_ms, const volatile bool &wakeUpRequested) = 0;
+    };
+
+
+    /**
+     * @brief Sleeps with WFI. The core stops until the next interrupt, peripherals and DMA keep running.
+     *
+     * The SysTick interrupt wakes the core every tick, so the sleep is repeated until the duration has passed or a
+     * wake-up has been requested. The wake-up flag is checked with interrupts masked, so a wake-up from an ISR
+     * cannot get lost between the check and WFI. WFI still returns on a pending interrupt while PRIMASK is set.
+     */
+    class WfiSleepBackend : public SleepBackendInterface {
+    public:
+        void sleep(const uint32_t duration_ms, const volatile bool &wakeUpRequested) override {
+            const uint32_t start = millis();
+            while (!wakeUpRequested && millis() - start < duration_ms) {
+                __disable_irq();
+                if (!wakeUpRequested) {
+                    __DSB();
+                    __WFI();
+                }
+                __enable_irq();
+            }
+        }
+    };
+
+
+    /**
+     * @brief Stand-in for hosts and tests. Sleeping calls HAL_Delay() instead of stopping the core.
+     *
+     * With the virtual time of the HostHal, HAL_Delay() advances the virtual time, so millis(), RunEvery and the
+     * Scheduler see the time that has been slept. A wake-up that has been requested before the sleep ends it at
+     * once, a wake-up during the sleep is not simulated.
+     */
+    class VirtualSleepBackend : public SleepBackendInterface {
+    public:
+        void sleep(const uint32_t duration_ms, const volatile bool &wakeUpRequested) override {
+            if (wakeUpRequested) return;
+            HAL_Delay(duration_ms);
+            sleepCount++;
+            sleptTime += duration_ms;
+        }
+
+        [[nodiscard]] uint32_t getSleepCount() const { return sleepCount; }
+
+        [[nodiscard]] uint64_t getSleptTime() const { return sleptTime; }
+
+    private:
+        uint32_t sleepCount = 0;
+        uint64_t sleptTime = 0;
+    };
+}
+
+#endif
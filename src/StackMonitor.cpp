@@ -0,0 +1,96 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "StackMonitor.hpp"
+#include "PrintColumn.hpp"
+#ifndef LIBSMART_HOST_BUILD
+#include <main.h>
+
+// Symbols of the STM32CubeIDE linker scripts
+extern "C" uint32_t _estack;
+extern "C" uint32_t _Min_Stack_Size;
+#endif
+
+using namespace Stm32Common;
+
+void StackRegion::paint(uint32_t *end) {
+    if (end == nullptr || end > top) end = top;
+    for (uint32_t *word = bottom; word < end; word++) *word = pattern;
+    highWater = end;
+}
+
+size_t StackRegion::update() {
+    // Words below the high-water mark have been unused at the last scan, only they have to be checked again
+    uint32_t *word = bottom;
+    while (word < highWater && *word == pattern) word++;
+    highWater = word;
+    return getUsed();
+}
+
+
+#ifndef LIBSMART_HOST_BUILD
+bool StackMonitorBase::addMainStack() {
+    auto *top = &_estack;
+    auto *bottom = reinterpret_cast<uint32_t *>(
+        reinterpret_cast<uintptr_t>(&_estack) - reinterpret_cast<uintptr_t>(&_Min_Stack_Size));
+    StackRegion *region = add("main", bottom, top);
+    if (region == nullptr) return false;
+
+    // Paint in this frame, keeping a margin for the frames of the functions called while painting
+    auto *end = reinterpret_cast<uint32_t *>(__get_MSP()) - 64;
+    if (end < bottom) end = bottom;
+    region->paint(end);
+    return true;
+}
+#endif
+
+#ifdef LIBSMART_USE_THREADX
+bool StackMonitorBase::addThread(TX_THREAD *thread) {
+    const auto start = reinterpret_cast<uintptr_t>(thread->tx_thread_stack_start);
+    const auto end = reinterpret_cast<uintptr_t>(thread->tx_thread_stack_end) + 1;
+    auto *bottom = reinterpret_cast<uint32_t *>((start + sizeof(uint32_t) - 1) & ~(sizeof(uint32_t) - 1));
+    auto *top = reinterpret_cast<uint32_t *>(end & ~(sizeof(uint32_t) - 1));
+    return add(thread->tx_thread_name, bottom, top) != nullptr;
+}
+#endif
+
+bool StackMonitorBase::addStack(const char *name, uint32_t *bottom, uint32_t *top, uint32_t *end) {
+    StackRegion *region = add(name, bottom, top);
+    if (region == nullptr) return false;
+    region->paint(end);
+    return true;
+}
+
+StackRegion *StackMonitorBase::add(const char *name, uint32_t *bottom, uint32_t *top) {
+    if (count >= capacity) return nullptr;
+    regions[count] = StackRegion(name, bottom, top);
+    return &regions[count++];
+}
+
+bool StackMonitorBase::update() {
+    bool overflowed = false;
+    for (size_t i = 0; i < count; i++) {
+        regions[i].update();
+        overflowed |= regions[i].isOverflowed();
+    }
+    return overflowed;
+}
+
+size_t StackMonitorBase::printTo(Print &printObject) const {
+    size_t n = printObject.println("stack            size     used     free  used_%");
+    for (size_t i = 0; i < count; i++) {
+        const StackRegion &region = regions[i];
+        const auto size = static_cast<uint32_t>(region.getSize());
+        const auto used = static_cast<uint32_t>(region.getUsed());
+        n += printTextColumn(printObject, region.getName(), 12);
+        n += printColumn(printObject, size, 9);
+        n += printColumn(printObject, used, 9);
+        n += printColumn(printObject, static_cast<uint32_t>(region.getFree()), 9);
+        n += printColumn(printObject, size > 0 ? static_cast<uint32_t>(100ULL * used / size) : 0, 8);
+        if (region.isOverflowed()) n += printObject.print(" OVERFLOW");
+        n += printObject.println();
+    }
+    return n;
+}
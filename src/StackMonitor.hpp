@@ -0,0 +1,160 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef LIBSMART_STM32COMMON_STACKMONITOR_HPP
+#define LIBSMART_STM32COMMON_STACKMONITOR_HPP
+
+#include <libsmart_config.hpp>
+#include <cstddef>
+#include <cstdint>
+#include "Nameable.hpp"
+#include "Printable.hpp"
+
+#ifdef LIBSMART_USE_THREADX
+#include "tx_api.h"
+#endif
+
+namespace Stm32Common {
+    /**
+     * @brief A stack that grows downwards from top to bottom and has been painted with a pattern.
+     *
+     * update() scans the painted words from the bottom upwards until the first word that has been overwritten.
+     * The high-water mark only moves downwards, so a scan costs one read per word that has never been used. A
+     * changed bottom word means that the stack has overflowed into the memory below it.
+     */
+    class StackRegion : public Nameable {
+    public:
+        /**
+         * @brief The pattern of unused words. ThreadX fills thread stacks with the same pattern (TX_STACK_FILL).
+         */
+        static constexpr uint32_t pattern = 0xEFEFEFEF;
+
+        StackRegion() = default;
+
+        StackRegion(const char *name, uint32_t *bottom, uint32_t *top)
+            : Nameable(name), bottom(bottom), top(top), highWater(top) { ; }
+
+        /**
+         * @brief Paints the words from the bottom up to end, which must not be above the top. The words above end
+         * count as used.
+         */
+        void paint(uint32_t *end);
+
+        /**
+         * @brief Scans the stack for the high-water mark.
+         *
+         * @return The largest number of bytes that has been used so far.
+         */
+        size_t update();
+
+        [[nodiscard]] size_t getSize() const { return (top - bottom) * sizeof(uint32_t); }
+
+        /**
+         * @brief Returns the largest number of bytes that has been used up to the last update().
+         */
+        [[nodiscard]] size_t getUsed() const { return (top - highWater) * sizeof(uint32_t); }
+
+        [[nodiscard]] size_t getFree() const { return getSize() - getUsed(); }
+
+        /**
+         * @brief Returns true if the bottom word has been overwritten at the last update().
+         */
+        [[nodiscard]] bool isOverflowed() const { return highWater == bottom && bottom != top; }
+
+    private:
+        uint32_t *bottom = nullptr;
+        uint32_t *top = nullptr;
+        uint32_t *highWater = nullptr; // Lowest word that has been found overwritten
+    };
+
+
+    /**
+     * @brief Paints stacks and reports their high-water marks.
+     *
+     * This is the size independent part of StackMonitor. update() is intended to be called from a low priority
+     * RunEvery, e.g. once per second, the table of printTo() shows size, used and free bytes of every stack.
+     *
+     * @code
+     * static Stm32Common::StackMonitor<4> stackMonitor;
+     *
+     * int main() {
+     *     stackMonitor.addMainStack();
+     *     // ...
+     * }
+     *
+     * Stm32Common::RunEvery stackCheck(1000, []() { stackMonitor.update(); });
+     * @endcode
+     */
+    class StackMonitorBase : public Printable {
+    public:
+#ifndef LIBSMART_HOST_BUILD
+        /**
+         * @brief Paints the main stack, from the bottom of the reserved stack up to the current stack pointer.
+         *
+         * Uses the symbols _estack and _Min_Stack_Size of the STM32CubeIDE linker scripts. Call this early in
+         * main(), the words above the stack pointer are counted as used.
+         *
+         * @return false if no more stacks can be added.
+         */
+        bool addMainStack();
+#endif
+
+#ifdef LIBSMART_USE_THREADX
+        /**
+         * @brief Adds the stack of a ThreadX thread. tx_thread_create() has painted the stack already, unless
+         * TX_DISABLE_STACK_FILLING is defined.
+         *
+         * @return false if no more stacks can be added.
+         */
+        bool addThread(TX_THREAD *thread);
+#endif
+
+        /**
+         * @brief Adds a stack that is painted now up to the given end, e.g. the stack of a coroutine or of a task
+         * that does not run yet. end == nullptr paints the whole stack.
+         *
+         * @return false if no more stacks can be added.
+         */
+        bool addStack(const char *name, uint32_t *bottom, uint32_t *top, uint32_t *end = nullptr);
+
+        /**
+         * @brief Scans all stacks for their high-water marks.
+         *
+         * @return true if a stack has overflowed.
+         */
+        bool update();
+
+        [[nodiscard]] size_t getStackCount() const { return count; }
+
+        [[nodiscard]] const StackRegion &getStack(const size_t index) const { return regions[index]; }
+
+        size_t printTo(Print &printObject) const override;
+
+    protected:
+        StackMonitorBase(StackRegion *regions, const size_t capacity) : regions(regions), capacity(capacity) { ; }
+
+    private:
+        StackRegion *add(const char *name, uint32_t *bottom, uint32_t *top);
+
+        StackRegion *const regions;
+        const size_t capacity;
+        size_t count = 0;
+    };
+
+
+    /**
+     * @brief StackMonitor for up to MaxStacks stacks.
+     */
+    template<size_t MaxStacks>
+    class StackMonitor : public StackMonitorBase {
+    public:
+        StackMonitor() : StackMonitorBase(stacks, MaxStacks) { ; }
+
+    private:
+        StackRegion stacks[MaxStacks];
+    };
+}
+
+#endif
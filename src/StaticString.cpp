@@ -0,0 +1,106 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include "StaticString.hpp"
+#include "Print.hpp"
+#include "Hash/MurmurHash3.hpp"
+
+using namespace Stm32Common;
+
+void StaticStringBase::clear() {
+    len = 0;
+    buffer[0] = '\0';
+    truncated = false;
+}
+
+void StaticStringBase::truncate(const size_t newLength) {
+    if (newLength >= len) return;
+    len = newLength;
+    buffer[len] = '\0';
+}
+
+StaticStringBase &StaticStringBase::append(const char c) {
+    return append(&c, 1);
+}
+
+StaticStringBase &StaticStringBase::append(const char *str) {
+    if (str == nullptr) return *this;
+    return append(str, strlen(str));
+}
+
+StaticStringBase &StaticStringBase::append(const char *str, size_t length) {
+    if (str == nullptr || length == 0) return *this;
+    if (length > getRemainingSpace()) {
+        length = getRemainingSpace();
+        truncated = true;
+    }
+    memmove(buffer + len, str, length);
+    len += length;
+    buffer[len] = '\0';
+    return *this;
+}
+
+StaticStringBase &StaticStringBase::append(unsigned long value, int base) {
+    if (base < 2 || base > 16) base = 10;
+    char digits[8 * sizeof(unsigned long)];
+    char *p = digits + sizeof digits;
+    do {
+        const auto digit = static_cast<char>(value % base);
+        *--p = digit < 10 ? '0' + digit : 'A' + digit - 10;
+        value /= base;
+    } while (value);
+    return append(p, digits + sizeof digits - p);
+}
+
+StaticStringBase &StaticStringBase::append(const long value, const int base) {
+    if (value < 0 && (base == 10 || base < 2 || base > 16)) {
+        append('-');
+        return append(0UL - static_cast<unsigned long>(value), 10);
+    }
+    return append(static_cast<unsigned long>(value), base);
+}
+
+size_t StaticStringBase::vappendFormat(const char *format, va_list args) {
+    const int written = vsnprintf(buffer + len, getRemainingSpace() + 1, format, args);
+    if (written < 0) {
+        buffer[len] = '\0';
+        return 0;
+    }
+    auto appended = static_cast<size_t>(written);
+    if (appended > getRemainingSpace()) {
+        appended = getRemainingSpace();
+        truncated = true;
+    }
+    len += appended;
+    return appended;
+}
+
+size_t StaticStringBase::appendFormat(const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    const auto ret = vappendFormat(format, args);
+    va_end(args);
+    return ret;
+}
+
+size_t StaticStringBase::format(const char *format, ...) {
+    clear();
+    va_list args;
+    va_start(args, format);
+    vappendFormat(format, args);
+    va_end(args);
+    return len;
+}
+
+uint32_t StaticStringBase::hash(const uint32_t seed) const {
+    return Hash::MurmurHash3::murmur3_32(reinterpret_cast<const uint8_t *>(buffer), len, seed);
+}
+
+size_t StaticStringBase::printTo(Print &printObject) const {
+    return printObject.write(buffer, len);
+}
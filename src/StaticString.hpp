@@ -0,0 +1,203 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef LIBSMART_STM32COMMON_STATICSTRING_HPP
+#define LIBSMART_STM32COMMON_STATICSTRING_HPP
+
+#include <libsmart_config.hpp>
+#include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include "Printable.hpp"
+
+namespace Stm32Common {
+    /**
+     * @brief Fixed-capacity, null-terminated string that never allocates.
+     *
+     * This is the size independent part of StaticString. Functions that accept strings of any capacity take a
+     * reference to StaticStringBase.
+     *
+     * Appending more characters than fit stores as many as possible and marks the string as truncated.
+     *
+     * @see StaticString
+     */
+    class StaticStringBase : public Printable {
+    public:
+        StaticStringBase(const StaticStringBase &) = delete;
+
+        StaticStringBase &operator=(const StaticStringBase &) = delete;
+
+        /**
+         * @brief Returns the null-terminated content.
+         */
+        [[nodiscard]] const char *c_str() const { return buffer; }
+
+        [[nodiscard]] size_t length() const { return len; }
+
+        /**
+         * @brief Returns the maximum number of characters, excluding the terminating null.
+         */
+        [[nodiscard]] size_t capacity() const { return cap; }
+
+        [[nodiscard]] size_t getRemainingSpace() const { return cap - len; }
+
+        [[nodiscard]] bool isEmpty() const { return len == 0; }
+
+        [[nodiscard]] bool isFull() const { return len == cap; }
+
+        /**
+         * @brief Checks if characters have been dropped, because they did not fit.
+         */
+        [[nodiscard]] bool isTruncated() const { return truncated; }
+
+        [[nodiscard]] std::string_view view() const { return {buffer, len}; }
+
+        operator std::string_view() const { return view(); }
+
+        char operator[](size_t pos) const { return pos < len ? buffer[pos] : '\0'; }
+
+        /**
+         * @brief Removes all characters and clears the truncated flag.
+         */
+        void clear();
+
+        /**
+         * @brief Shortens the string to the given length.
+         */
+        void truncate(size_t newLength);
+
+        StaticStringBase &append(char c);
+
+        StaticStringBase &append(const char *str);
+
+        StaticStringBase &append(const char *str, size_t length);
+
+        StaticStringBase &append(std::string_view str) { return append(str.data(), str.size()); }
+
+        StaticStringBase &append(long value, int base = 10);
+
+        StaticStringBase &append(unsigned long value, int base = 10);
+
+        StaticStringBase &append(int value, int base = 10) { return append(static_cast<long>(value), base); }
+
+        StaticStringBase &append(unsigned int value, int base = 10) {
+            return append(static_cast<unsigned long>(value), base);
+        }
+
+        StaticStringBase &operator+=(char c) { return append(c); }
+
+        StaticStringBase &operator+=(const char *str) { return append(str); }
+
+        StaticStringBase &operator+=(std::string_view str) { return append(str); }
+
+        StaticStringBase &assign(std::string_view str) {
+            clear();
+            return append(str);
+        }
+
+        StaticStringBase &operator=(std::string_view str) { return assign(str); }
+
+        StaticStringBase &operator=(const char *str) { return assign(str == nullptr ? "" : str); }
+
+        /**
+         * @brief Appends formatted output, like snprintf().
+         *
+         * @return The number of characters appended.
+         */
+        size_t appendFormat(const char *format, ...);
+
+        size_t vappendFormat(const char *format, va_list args);
+
+        /**
+         * @brief Replaces the content with formatted output, like snprintf().
+         *
+         * @return The length of the string.
+         */
+        size_t format(const char *format, ...);
+
+        /**
+         * @brief Compares the string lexicographically, like std::string_view::compare().
+         */
+        [[nodiscard]] int compare(std::string_view other) const { return view().compare(other); }
+
+        [[nodiscard]] bool equals(std::string_view other) const { return view() == other; }
+
+        [[nodiscard]] bool startsWith(std::string_view prefix) const {
+            return view().substr(0, prefix.size()) == prefix;
+        }
+
+        [[nodiscard]] bool endsWith(std::string_view suffix) const {
+            return len >= suffix.size() && view().substr(len - suffix.size()) == suffix;
+        }
+
+        bool operator==(std::string_view other) const { return equals(other); }
+
+        bool operator!=(std::string_view other) const { return !equals(other); }
+
+        bool operator<(std::string_view other) const { return compare(other) < 0; }
+
+        /**
+         * @brief Returns the MurmurHash3 of the content.
+         *
+         * @param seed The seed of the hash function.
+         */
+        [[nodiscard]] uint32_t hash(uint32_t seed = 0) const;
+
+        /**
+         * @brief Writes the content to the given Print object.
+         */
+        size_t printTo(Print &printObject) const override;
+
+    protected:
+        StaticStringBase(char *buffer, const size_t capacity) : buffer(buffer), cap(capacity) {
+            buffer[0] = '\0';
+        }
+
+        ~StaticStringBase() = default;
+
+    private:
+        char *buffer;
+        size_t cap;
+        size_t len = 0;
+        bool truncated = false;
+    };
+
+
+    /**
+     * @brief Fixed-capacity string with room for Capacity characters plus the terminating null.
+     *
+     * @code
+     * Stm32Common::StaticString<64> reply;
+     * reply.append("OK ").append(value).append('\n');
+     * session->print(reply);
+     * @endcode
+     */
+    template<size_t Capacity>
+    class StaticString final : public StaticStringBase {
+        static_assert(Capacity > 0, "StaticString needs a capacity of at least one character");
+
+    public:
+        StaticString() : StaticStringBase(storage, Capacity) { ; }
+
+        StaticString(std::string_view str) : StaticString() { append(str); }
+
+        StaticString(const char *str) : StaticString() { if (str != nullptr) append(str); }
+
+        StaticString(const StaticString &other) : StaticString() { append(other.view()); }
+
+        StaticString &operator=(const StaticString &other) {
+            if (this != &other) assign(other.view());
+            return *this;
+        }
+
+        using StaticStringBase::operator=;
+
+    private:
+        char storage[Capacity + 1] = {};
+    };
+}
+
+#endif
@@ -8,52 +8,107 @@
 
 #include <libsmart_config.hpp>
 #include <cstdint>
-#include <functional>
 #include "Helper.hpp"
+#include "LatencyHistogram.hpp"
+#include "Print.hpp"
+#include "Timebase.hpp"
+
+#ifdef LIBSMART_ENABLE_STD_FUNCTION
+#include <functional>
+#endif
 
 
 namespace Stm32Common {
+    /**
+     * @brief Measures durations in cycles of the Timebase and keeps their distribution in a LatencyHistogram.
+     *
+     * printResult() prints count, min, p50, p90, p99, max and mean in nanoseconds. Durations must be shorter than
+     * 2^28 cycles (3.7 s at 72 MHz) to be sorted into the histogram; longer ones still count for max and mean.
+     *
+     * @code
+     * static Stm32Common::Stopwatch sessionLoop;
+     *
+     * {
+     *     Stm32Common::Stopwatch::Scope scope(sessionLoop);
+     *     sessionManager.loop();
+     * }
+     * sessionLoop.measure([]() { shell.loop(); });
+     * @endcode
+     */
     class Stopwatch {
     public:
 #ifdef LIBSMART_ENABLE_STD_FUNCTION
         using fn_t = std::function<void()>;
+#endif
+
+        /**
+         * @brief Measures from its construction to its destruction.
+         */
+        class Scope {
+        public:
+            explicit Scope(Stopwatch &stopwatch) : stopwatch(stopwatch), startCycles(Timebase::getCycles32()) { ; }
+
+            ~Scope() { stopwatch.record(Timebase::getCycles32() - startCycles); }
+
+            Scope(const Scope &) = delete;
 
-        void measure(const fn_t &measured_fn) {
-            lastStartMicros = micros();
+            Scope &operator=(const Scope &) = delete;
 
+        private:
+            Stopwatch &stopwatch;
+            uint32_t startCycles;
+        };
+
+        void start() { startCycles = Timebase::getCycles32(); }
+
+        /**
+         * @brief Ends the measurement that has been started with start().
+         *
+         * @return The measured duration [cycles].
+         */
+        uint32_t stop() {
+            const uint32_t cycles = Timebase::getCycles32() - startCycles;
+            record(cycles);
+            return cycles;
+        }
+
+        /**
+         * @brief Measures the duration of the given function. The function is called directly, without
+         * std::function.
+         */
+        template<typename Fn>
+        void measure(Fn &&measured_fn) {
+            const Scope scope(*this);
             measured_fn();
+        }
 
-            lastDurationMicros = micros() - lastStartMicros;
-            longestDurationMicros = std::max(longestDurationMicros, lastDurationMicros);
-            shortestDurationMicros = std::min(shortestDurationMicros, lastDurationMicros);
-            rollingAverageDurationMicros = rollingAverageDurationMicros == 0
-                                               ? lastDurationMicros
-                                               : (rollingAverageDurationMicros + lastDurationMicros) / 2;
+        /**
+         * @brief Adds a duration that has been measured elsewhere [cycles].
+         */
+        void record(const uint32_t cycles) {
+            lastCycles = cycles;
+            histogram.record(cycles);
         }
 
-#endif
+        void clear() {
+            lastCycles = 0;
+            histogram.clear();
+        }
+
+        [[nodiscard]] uint32_t getLastCycles() const { return lastCycles; }
+
+        [[nodiscard]] const LatencyHistogramBase &getHistogram() const { return histogram; }
 
-        void printResult(Stm32Common::Print *printable) {
-            printable->print("lastDurationMicros           = ");
-            printable->print((uint32_t) lastDurationMicros);
-            printable->println("us");
-            printable->print("longestDurationMicros        = ");
-            printable->print((uint32_t) longestDurationMicros);
-            printable->println("us");
-            printable->print("shortestDurationMicros       = ");
-            printable->print((uint32_t) shortestDurationMicros);
-            printable->println("us");
-            printable->print("rollingAverageDurationMicros = ");
-            printable->print((uint32_t) rollingAverageDurationMicros);
-            printable->println("us");
+        void printResult(Print *printable) const {
+            histogram.printTable(*printable, [](const uint64_t cycles) -> uint64_t {
+                return Timebase::cyclesToNanos(cycles);
+            }, "ns");
         }
 
     private:
-        uint64_t lastStartMicros = 0;
-        uint64_t lastDurationMicros = 0;
-        uint64_t longestDurationMicros = 0;
-        uint64_t shortestDurationMicros = UINT64_MAX;
-        uint64_t rollingAverageDurationMicros = 0;
+        uint32_t startCycles = 0;
+        uint32_t lastCycles = 0;
+        LatencyHistogram<> histogram;
     };
 }
 
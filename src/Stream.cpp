@@ -232,32 +232,28 @@ size_t Stream::readBytesUntil(char terminator, uint8_t *buffer, size_t length) {
 }
 
 
-/*
-String Stream::readString()
-{
-    String ret;
-    int c = timedRead();
-    while (c >= 0)
-    {
-        ret += (char)c;
-        c = timedRead();
+size_t Stream::readString(StaticStringBase &str) {
+    size_t index = 0;
+    while (!str.isFull()) {
+        int c = timedRead();
+        if (c < 0) break;
+        str.append((char) c);
+        index++;
     }
-    return ret;
+    return index;
 }
 
 
-String Stream::readStringUntil(char terminator)
-{
-    String ret;
-    int c = timedRead();
-    while (c >= 0 && c != terminator)
-    {
-        ret += (char)c;
-        c = timedRead();
+size_t Stream::readStringUntil(char terminator, StaticStringBase &str) {
+    size_t index = 0;
+    while (!str.isFull()) {
+        int c = timedRead();
+        if (c < 0 || c == terminator) break;
+        str.append((char) c);
+        index++;
     }
-    return ret;
+    return index;
 }
-*/
 
 
 long Stream::parseInt(char ignore) {
@@ -20,6 +20,7 @@
 
 #include <libsmart_config.hpp>
 #include "Print.hpp"
+#include "StaticString.hpp"
 
 #define NO_IGNORE_CHAR  '\x01' // a char not found in a valid ASCII numeric field
 
@@ -350,9 +351,30 @@ namespace Stm32Common {
          */
         size_t readBytesUntil(char terminator, uint8_t *buffer, size_t length);
 
-        //TODO: Arduino String functions to be added here
-        //        String readString();
-        //        String readStringUntil(char terminator);
+        /**
+         * @brief Reads characters from the stream into a StaticString until a timeout occurs.
+         *
+         * The characters are appended to the given string. Reading stops without consuming further characters
+         * when the string is full.
+         *
+         * @param str The string to which the characters are appended.
+         * @return The number of characters appended.
+         * @note Unlike arduino, this function does not allocate memory.
+         */
+        size_t readString(StaticStringBase &str);
+
+        /**
+         * @brief Reads characters from the stream into a StaticString until the terminator is found.
+         *
+         * The characters are appended to the given string, the terminator is consumed but not appended.
+         * Reading stops when the terminator is found, a timeout occurs, or the string is full.
+         *
+         * @param terminator The terminator character to search for.
+         * @param str The string to which the characters are appended.
+         * @return The number of characters appended.
+         * @note Unlike arduino, this function does not allocate memory.
+         */
+        size_t readStringUntil(char terminator, StaticStringBase &str);
 
     protected:
         /**
@@ -61,6 +61,22 @@ namespace Stm32Common {
 
         using Stream::write;
 
+#ifdef LIBSMART_ENABLE_DIRECT_BUFFER_WRITE
+        /**
+         * @brief Writes as many bytes as fit into the transmit buffer, like Print::write().
+         *
+         * The transmit buffer is told the full size, so bytes that do not fit abort a transaction and are counted
+         * as rejected instead of being cut off unnoticed.
+         *
+         * @return The number of bytes written.
+         */
+        size_t write(const uint8_t *buffer, size_t size) override {
+            const size_t sz = std::min(size, txBuffer.getRemainingSpace());
+            memcpy(txBuffer.getWritePointer(), buffer, sz);
+            return txBuffer.add(size);
+        }
+#endif
+
         /**
          * @brief Returns the number of bytes available for writing to the transmit buffer.
          *
@@ -81,6 +97,34 @@ namespace Stm32Common {
         void flush() override {
         }
 
+        /**
+         * @brief Starts a print transaction on the transmit buffer.
+         *
+         * Everything written until the matching endTransaction() is committed to the transmit buffer at once,
+         * so onWriteTx() is called only once per transaction.
+         *
+         * @see PrintTransaction
+         */
+        void beginTransaction() override {
+            txBuffer.beginTransaction();
+        }
+
+        /**
+         * @brief Ends a print transaction on the transmit buffer.
+         *
+         * @return True if the transaction was committed, false if it was rolled back.
+         */
+        bool endTransaction() override {
+            return txBuffer.endTransaction();
+        }
+
+        /**
+         * @brief Marks the current transaction on the transmit buffer to be rolled back.
+         */
+        void abortTransaction() override {
+            txBuffer.abortTransaction();
+        }
+
         /**
          * @brief Returns the number of bytes available for reading from the receive buffer.
          *
@@ -121,10 +165,6 @@ namespace Stm32Common {
         StringBufferInterface *getRxBuffer() override { return &rxBuffer; }
         StringBufferInterface *getTxBuffer() override { return &txBuffer; }
 
-    protected:
-        virtual void onWriteTx() { ; }
-        virtual void onWriteRx() { ; }
-
     private:
         /**
          * @class rxBufferClass
@@ -145,6 +185,11 @@ namespace Stm32Common {
                 streamRxTxInstance.onWriteRx();
             }
 
+            void onRead() override {
+                StringBuffer<bufferSizeRx>::onRead();
+                streamRxTxInstance.onReadRx();
+            }
+
             StreamRxTx &streamRxTxInstance;
         } rxBuffer{*this};
 
@@ -168,6 +213,11 @@ namespace Stm32Common {
                 streamRxTxInstance.onWriteTx();
             }
 
+            void onRead() override {
+                StringBuffer<bufferSizeTx>::onRead();
+                streamRxTxInstance.onReadTx();
+            }
+
             StreamRxTx &streamRxTxInstance;
         } txBuffer{*this};
     };
@@ -32,6 +32,40 @@ namespace Stm32Common {
          * @return A pointer to the transmit buffer implementing the StringBufferInterface.
          */
         virtual StringBufferInterface *getTxBuffer() = 0;
+
+#ifdef LIBSMART_ENABLE_BUFFER_STATISTICS
+        /**
+         * @brief Returns the counters of the receive buffer.
+         */
+        [[nodiscard]] const BufferStatistics &getRxStatistics() { return getRxBuffer()->getStatistics(); }
+
+        /**
+         * @brief Returns the counters of the transmit buffer. Rejected writes are bytes the session could not send.
+         */
+        [[nodiscard]] const BufferStatistics &getTxStatistics() { return getTxBuffer()->getStatistics(); }
+#endif
+
+    protected:
+        /**
+         * @brief Called after data has been written to the receive buffer. This may happen in an ISR.
+         */
+        virtual void onWriteRx() { ; }
+
+        /**
+         * @brief Called after data has been written to the transmit buffer. This may happen in an ISR.
+         */
+        virtual void onWriteTx() { ; }
+
+        /**
+         * @brief Called after data has been read from the receive buffer. This may happen in an ISR.
+         */
+        virtual void onReadRx() { ; }
+
+        /**
+         * @brief Called after data has been read from the transmit buffer, so there is space again. This may happen
+         * in an ISR.
+         */
+        virtual void onReadTx() { ; }
     };
 }
 #endif
@@ -0,0 +1,87 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "CoroutineStreamSession.hpp"
+
+#ifdef LIBSMART_HAS_COROUTINES
+
+using namespace Stm32Common::StreamSession;
+
+void CoroutineStreamSessionBase::loop() {
+    if (!waiting) return;
+    if (!check(wait, waitValue)) {
+        // Without a wake-up timer, nothing else ends a sleep
+        if (wait == Wait::TIME && !wakeTimer.isScheduled()) wakeUp();
+        return;
+    }
+    const std::coroutine_handle<> handle = waiting;
+    waiting = {};
+    wait = Wait::NONE;
+    handle.resume();
+}
+
+bool CoroutineStreamSessionBase::check(const Wait condition, const uint32_t value) {
+    switch (condition) {
+        case Wait::NONE:
+            result = 0;
+            return true;
+
+        case Wait::RX_LENGTH:
+            result = getRxBuffer()->getLength();
+            return result >= value;
+
+        case Wait::RX_DELIMITER: {
+            StringBufferInterface *rx = getRxBuffer();
+            const size_t length = rx->getLength();
+            if (scanned > length) scanned = 0;
+            for (; scanned < length; scanned++) {
+                if (rx->peek(scanned) == static_cast<int>(value)) {
+                    result = scanned + 1;
+                    scanned = 0;
+                    countMessage();
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        case Wait::TX_SPACE:
+            result = getTxBuffer()->getRemainingSpace();
+            return result >= value;
+
+        case Wait::TIME:
+            result = millis() - waitStart;
+            return result >= value;
+    }
+    return false;
+}
+
+void CoroutineStreamSessionBase::startWakeTimer(const uint32_t duration_ms) {
+    if (scheduler == nullptr) {
+        wakeUp();
+        return;
+    }
+    // A one-shot run, due duration_ms after now. The scheduler drops the timer after the run.
+    wakeTimer = RunEvery(duration_ms, duration_ms, 1);
+    if (!scheduler->add(wakeTimer)) wakeUp();
+}
+
+void CoroutineStreamSessionBase::setupStreamSession(StreamSessionAware *sessionOwner,
+                                                    ManagerInterface *sessionManager, const uint32_t id) {
+    StreamSessionInterface::setupStreamSession(sessionOwner, sessionManager, id);
+    scanned = 0;
+    wait = Wait::NONE;
+    task = run();
+    waiting = task.getHandle();
+}
+
+void CoroutineStreamSessionBase::endStreamSession() {
+    if (wakeTimer.isScheduled()) scheduler->remove(wakeTimer);
+    waiting = {};
+    task = {};
+    StreamSessionInterface::endStreamSession();
+}
+
+#endif
@@ -0,0 +1,200 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef LIBSMART_STM32COMMON_STREAMSESSION_COROUTINESTREAMSESSION_HPP
+#define LIBSMART_STM32COMMON_STREAMSESSION_COROUTINESTREAMSESSION_HPP
+
+#include "Coroutine.hpp"
+
+#ifdef LIBSMART_HAS_COROUTINES
+
+#include "Helper.hpp"
+#include "RunEvery.hpp"
+#include "SchedulerInterface.hpp"
+#include "StreamRxTx.hpp"
+#include "StreamSessionInterface.hpp"
+
+namespace Stm32Common::StreamSession {
+    /**
+     * @brief Session whose protocol is written as a coroutine instead of a state machine.
+     *
+     * This is the buffer size independent part of CoroutineStreamSession.
+     *
+     * run() is started when the manager opens the session and destroyed when the session ends. It suspends on
+     * the awaitables rxAvailable(), rxDelimiter(), txAvailable() and sleep(). loop() checks the condition the
+     * coroutine is waiting for and resumes it only when the condition holds, so the coroutine never polls the
+     * buffers itself. The search for a delimiter continues where the previous check stopped.
+     *
+     * A sleep() ends without any buffer activity. With a scheduler set by setScheduler(), the session registers a
+     * one-shot wake-up timer with it, so Idle can sleep until the timer is due. Without a scheduler, the session
+     * keeps itself ready while the coroutine sleeps, so the manager polls it on every pass and Idle does not sleep.
+     *
+     * @see CoroutineStreamSession
+     */
+    class CoroutineStreamSessionBase : public StreamSessionInterface {
+    public:
+        template<class StreamSessionT, size_t MaxSessionCount>
+        friend class Manager;
+
+        void setup() override { ; }
+
+        void loop() override;
+
+        void end() override { ; }
+
+        void errorHandler() override { ; }
+
+        /**
+         * @brief Returns true while the coroutine has been started and has not finished.
+         */
+        [[nodiscard]] bool isRunning() const { return !task.isDone(); }
+
+        /**
+         * @brief Sets the scheduler that wakes up the sessions at the end of a sleep(). It is shared by all
+         * coroutine sessions. nullptr polls sleeping sessions instead.
+         */
+        static void setScheduler(SchedulerInterface *scheduler) { CoroutineStreamSessionBase::scheduler = scheduler; }
+
+    protected:
+        enum class Wait : uint8_t {
+            NONE,
+            RX_LENGTH,
+            RX_DELIMITER,
+            TX_SPACE,
+            TIME
+        };
+
+        /**
+         * @brief Awaitable condition of the session. co_await returns the length of the condition, e.g. the
+         * number of bytes up to and including the delimiter.
+         */
+        struct Awaiter {
+            CoroutineStreamSessionBase &session;
+            Wait wait;
+            uint32_t value;
+
+            [[nodiscard]] bool await_ready() const { return session.check(wait, value); }
+
+            void await_suspend(const std::coroutine_handle<> handle) const {
+                session.waiting = handle;
+                session.wait = wait;
+                session.waitValue = value;
+                if (wait == Wait::TIME) session.startWakeTimer(value);
+            }
+
+            [[nodiscard]] size_t await_resume() const { return session.result; }
+        };
+
+        /**
+         * @brief The protocol of the session.
+         */
+        virtual Task run() = 0;
+
+        /**
+         * @brief Waits until the receive buffer holds at least length bytes.
+         */
+        Awaiter rxAvailable(const size_t length) { return {*this, Wait::RX_LENGTH, static_cast<uint32_t>(length)}; }
+
+        /**
+         * @brief Waits until the receive buffer holds the delimiter. Returns the number of bytes up to and including
+         * the delimiter. Every delimiter found counts as a message.
+         */
+        Awaiter rxDelimiter(const uint8_t c) { return {*this, Wait::RX_DELIMITER, c}; }
+
+        /**
+         * @brief Waits until the transmit buffer has space for at least length bytes.
+         */
+        Awaiter txAvailable(const size_t length) {
+            return {*this, Wait::TX_SPACE, static_cast<uint32_t>(length)};
+        }
+
+        /**
+         * @brief Waits for the given time [ms].
+         */
+        Awaiter sleep(const uint32_t duration_ms) {
+            waitStart = millis();
+            return {*this, Wait::TIME, duration_ms};
+        }
+
+        void setupStreamSession(StreamSessionAware *sessionOwner, ManagerInterface *sessionManager,
+                                uint32_t id) override;
+
+        void endStreamSession() override;
+
+    private:
+        /**
+         * @brief One-shot timer that wakes up the session when a sleep() is over.
+         */
+        class WakeTimer : public RunEvery {
+        public:
+            explicit WakeTimer(CoroutineStreamSessionBase &session) : session(session) { ; }
+
+            using RunEvery::operator=;
+
+        protected:
+            void run() override { session.wakeUp(); }
+
+        private:
+            CoroutineStreamSessionBase &session;
+        };
+
+        bool check(Wait condition, uint32_t value);
+
+        void startWakeTimer(uint32_t duration_ms);
+
+        inline static SchedulerInterface *scheduler = nullptr;
+
+        WakeTimer wakeTimer{*this};
+        Task task;
+        std::coroutine_handle<> waiting;
+        Wait wait = Wait::NONE;
+        uint32_t waitValue = 0;
+        uint32_t waitStart = 0;
+        size_t scanned = 0; // Bytes of the receive buffer that have been searched for the delimiter
+        size_t result = 0;
+    };
+
+
+    /**
+     * @brief CoroutineStreamSession with receive and transmit buffers of the given sizes.
+     *
+     * @code
+     * class LoginSession : public Stm32Common::StreamSession::CoroutineStreamSession<64, 128> {
+     * protected:
+     *     Stm32Common::Task run() override {
+     *         for (;;) {
+     *             print("login: ");
+     *             const size_t length = co_await rxDelimiter('\n');
+     *             char user[32] = {};
+     *             getRxBuffer()->read(user, std::min(length, sizeof(user) - 1));
+     *             co_await sleep(500);
+     *             println("denied");
+     *         }
+     *     }
+     * };
+     * @endcode
+     */
+    template<buf_size_t bufferSizeRx, buf_size_t bufferSizeTx>
+    class CoroutineStreamSession : public CoroutineStreamSessionBase,
+                                   public StreamRxTx<bufferSizeRx, bufferSizeTx> {
+    public:
+        CoroutineStreamSession() {
+            Nameable::setName("CoroutineStreamSession");
+        }
+
+        void end() override {
+            this->getRxBuffer()->clear();
+            this->getTxBuffer()->clear();
+        }
+
+        void flush() override {
+            StreamRxTx<bufferSizeRx, bufferSizeTx>::flush();
+        }
+    };
+}
+
+#endif
+
+#endif
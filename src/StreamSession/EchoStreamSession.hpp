@@ -31,6 +31,7 @@ namespace Stm32Common::StreamSession {
             }
 
             if (getTxBuffer()->available() > 0) {
+                // Every read of the owner from the transmit buffer wakes the session again, see onReadTx()
                 sessionOwner->dataReadyTx(this);
             }
         }
@@ -48,7 +49,7 @@ namespace Stm32Common::StreamSession {
 
     protected:
         void onWriteTx() override {
-            StreamRxTx::onWriteTx();
+            StreamSessionInterface::onWriteTx();
             loop();
         }
     };
@@ -8,8 +8,16 @@
 
 #include <main.h>
 #include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include "Idle.hpp"
 #include "Loggable.hpp"
 #include "ManagerInterface.hpp"
+#include "Profiler.hpp"
+#ifdef LIBSMART_ENABLE_TRACE
+#include "Trace.hpp"
+#endif
 #include "StreamSessionInterface.hpp"
 
 namespace Stm32Common::StreamSession {
@@ -32,6 +40,9 @@ namespace Stm32Common::StreamSession {
                     ->printf("Stm32Common::StreamSession::Manager::getNewSession(0x%08x, 0x%08x)\r\n", sessionOwner, id);
 
             if (getSessionById(id) != nullptr) {
+#ifdef LIBSMART_ENABLE_SESSION_STATISTICS
+                statistics.rejected++;
+#endif
                 log()->setSeverity(Stm32ItmLogger::LoggerInterface::Severity::WARNING)
                         ->printf("StreamSession with id 0x%08x already exists\r\n", id);
 
@@ -43,6 +54,12 @@ namespace Stm32Common::StreamSession {
             for (size_t i = 0; i < MaxSessionCount; i++) {
                 if (!sessions[i].isInUse()) {
                     sessions[i].setupStreamSession(sessionOwner, this, id);
+                    wakeUp(&sessions[i]);
+#ifdef LIBSMART_ENABLE_SESSION_STATISTICS
+                    statistics.opened++;
+                    const auto inUse = static_cast<uint32_t>(getSessionsInUse());
+                    if (inUse > statistics.peakInUse) statistics.peakInUse = inUse;
+#endif
 
                     log()->setSeverity(Stm32ItmLogger::LoggerInterface::Severity::INFORMATIONAL)->printf(
                         "Stm32Common::StreamSession::Manager sessions in use = %lu/%lu\r\n", getSessionsInUse(),
@@ -51,6 +68,9 @@ namespace Stm32Common::StreamSession {
                 }
             }
 
+#ifdef LIBSMART_ENABLE_SESSION_STATISTICS
+            statistics.rejected++;
+#endif
             log()->setSeverity(Stm32ItmLogger::LoggerInterface::Severity::INFORMATIONAL)->printf(
                 "Stm32Common::StreamSession::Manager sessions in use = %lu/%lu\r\n", getSessionsInUse(),
                 std::size(sessions));
@@ -62,6 +82,16 @@ namespace Stm32Common::StreamSession {
             if (session == nullptr) return;
             for (size_t i = 0; i < MaxSessionCount; i++) {
                 if (&sessions[i] == session && sessions[i].isInUse()) {
+#ifdef LIBSMART_ENABLE_SESSION_STATISTICS
+                    statistics.closed.add(sessions[i].getStatistics());
+#ifdef LIBSMART_ENABLE_BUFFER_STATISTICS
+                    const BufferStatistics &rx = sessions[i].getRxStatistics();
+                    const BufferStatistics &tx = sessions[i].getTxStatistics();
+                    statistics.closedRxBytes += rx.bytesIn;
+                    statistics.closedTxBytes += tx.bytesOut;
+                    statistics.closedDrops += rx.rejectedBytes + tx.rejectedBytes;
+#endif
+#endif
                     sessions[i].end();
                     sessions[i].endStreamSession();
                 }
@@ -120,14 +150,55 @@ namespace Stm32Common::StreamSession {
 
         void setup() override { ; }
 
+        /**
+         * @brief Calls loop() of the sessions which have been woken up since the last pass.
+         *
+         * Sessions without buffer activity are skipped. A session that has to be polled calls wakeUp() from its
+         * loop(), e.g. when its owner has not sent the whole transmit buffer, see StreamSessionAware::dataReadyTx().
+         */
         void loop() override {
-            for (size_t i = 0; i < MaxSessionCount; i++) {
-                if (sessions[i].isInUse()) {
-                    sessions[i].loop();
+            PROFILE_ZONE("sessions");
+            for (size_t word = 0; word < ReadyWords; word++) {
+                uint32_t bits = ready[word].exchange(0, std::memory_order_acquire);
+                while (bits != 0) {
+                    const size_t i = word * 32 + __builtin_ctz(bits);
+                    bits &= bits - 1;
+                    if (sessions[i].isInUse()) {
+#ifdef LIBSMART_ENABLE_SESSION_STATISTICS
+                        const uint32_t start = Timebase::getCycles32();
+                        sessions[i].loop();
+                        sessions[i].statistics.recordLoop(Timebase::getCycles32() - start);
+#else
+                        sessions[i].loop();
+#endif
+                    }
                 }
             }
         }
 
+        void wakeUp(StreamSessionInterface *session) override {
+            // std::less gives a total order, also for pointers that do not point into sessions
+            const std::less<const StreamSessionInterface *> less;
+            if (session == nullptr || less(session, &sessions[0]) || less(&sessions[MaxSessionCount - 1], session)) {
+                return;
+            }
+            const auto i = static_cast<size_t>(static_cast<StreamSessionT *>(session) - sessions.data());
+            if (&sessions[i] != session) return;
+
+            ready[i / 32].fetch_or(1UL << (i % 32), std::memory_order_release);
+#ifdef LIBSMART_ENABLE_TRACE
+            Tracer::wakeUp(static_cast<uint8_t>(i));
+#endif
+            if (idle != nullptr) idle->wakeUp();
+        }
+
+        bool hasReadySessions() override {
+            for (const auto &word: ready) {
+                if (word.load(std::memory_order_relaxed) != 0) return true;
+            }
+            return false;
+        }
+
         void flush() override {
             for (size_t i = 0; i < MaxSessionCount; i++) {
                 if (sessions[i].isInUse()) {
@@ -141,7 +212,14 @@ namespace Stm32Common::StreamSession {
         void errorHandler() override { ; }
 
     private:
+        static constexpr size_t ReadyWords = (MaxSessionCount + 31) / 32;
+
         std::array<StreamSessionT, MaxSessionCount> sessions = {};
+
+        /**
+         * @brief One bit per session that has to be looped. Set from buffer hooks, possibly in an ISR.
+         */
+        std::array<std::atomic<uint32_t>, ReadyWords> ready = {};
     };
 }
 
@@ -9,11 +9,30 @@
 #include <main.h>
 #include "StreamSessionInterface.hpp"
 #include "Process/ProcessInterface.hpp"
+#include "WakeSourceInterface.hpp"
 
 namespace Stm32Common::StreamSession {
     class StreamSessionAware;
 
-    class ManagerInterface : public virtual Process::ProcessInterface, public Stm32ItmLogger::Loggable {
+#ifdef LIBSMART_ENABLE_SESSION_STATISTICS
+    /**
+     * @brief Counters of a session manager, see ManagerInterface::getStatistics().
+     */
+    struct ManagerStatistics {
+        uint32_t opened = 0;
+        uint32_t rejected = 0; // Sessions that could not be opened, no free session or duplicate id
+        uint32_t peakInUse = 0;
+        SessionStatistics closed; // Sum of the sessions that have been removed
+#ifdef LIBSMART_ENABLE_BUFFER_STATISTICS
+        uint64_t closedRxBytes = 0;
+        uint64_t closedTxBytes = 0;
+        uint32_t closedDrops = 0;
+#endif
+    };
+#endif
+
+    class ManagerInterface : public virtual Process::ProcessInterface, public WakeSourceInterface,
+                             public Stm32ItmLogger::Loggable {
     public:
         ManagerInterface() = default;
 
@@ -120,8 +139,50 @@ namespace Stm32Common::StreamSession {
          * and ready to be transmitted for the given StreamSessionInterface instance.
          *
          * @param session A pointer to the StreamSessionInterface instance for which data is ready for transmission.
+         * @see StreamSessionAware::dataReadyTx()
          */
-        virtual void dataReadyTx(StreamSessionInterface *session) { ; }
+        virtual void dataReadyTx(StreamSessionInterface *session) { LIBSMART_UNUSED(session); }
+
+        /**
+         * @brief Marks a session as ready, so its loop() is called in the next pass.
+         *
+         * This method can be called from an ISR.
+         *
+         * @param session The session with work to do.
+         * @see StreamSessionInterface::wakeUp()
+         */
+        virtual void wakeUp(StreamSessionInterface *session) { LIBSMART_UNUSED(session); }
+
+        /**
+         * @brief Checks if any session is waiting for its loop() to be called.
+         */
+        virtual bool hasReadySessions() { return false; }
+
+        /**
+         * @brief A ready session is work for the main loop.
+         */
+        bool hasWork() override { return hasReadySessions(); }
+
+        /**
+         * @brief Sets the Idle object that is woken up together with a session. nullptr removes it.
+         *
+         * Idle::setSessionManager() calls this automatically.
+         */
+        void setIdle(Idle *idle) override { this->idle = idle; }
+
+#ifdef LIBSMART_ENABLE_SESSION_STATISTICS
+        /**
+         * @brief Returns the counters of the manager. The counters of the open sessions are not included, see
+         * SessionReport for the totals.
+         */
+        [[nodiscard]] const ManagerStatistics &getStatistics() const { return statistics; }
+#endif
+
+    protected:
+        Idle *idle = nullptr;
+#ifdef LIBSMART_ENABLE_SESSION_STATISTICS
+        ManagerStatistics statistics;
+#endif
     };
 }
 
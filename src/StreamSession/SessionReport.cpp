@@ -0,0 +1,106 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "SessionReport.hpp"
+#include "PrintColumn.hpp"
+#include "Timebase.hpp"
+
+using namespace Stm32Common;
+using namespace Stm32Common::StreamSession;
+
+namespace {
+#ifdef LIBSMART_ENABLE_SESSION_STATISTICS
+    uint32_t toMicros(const uint32_t cycles) {
+        return static_cast<uint32_t>(Timebase::cyclesToMicros(cycles));
+    }
+
+    size_t printStatistics(Print &out, const SessionStatistics &statistics) {
+        size_t n = printColumn(out, statistics.loops, 9);
+        n += printColumn(out, toMicros(statistics.getMeanLoop_cycles()), 9);
+        n += printColumn(out, toMicros(statistics.maxLoop_cycles), 9);
+        n += printColumn(out, statistics.messages, 9);
+        n += printColumn(out, statistics.responses, 9);
+        n += printColumn(out, toMicros(statistics.getMeanResponse_cycles()), 9);
+        n += printColumn(out, toMicros(statistics.maxResponse_cycles), 9);
+        return n;
+    }
+#endif
+
+#ifdef LIBSMART_ENABLE_BUFFER_STATISTICS
+    size_t printTraffic(Print &out, const uint64_t rxBytes, const uint64_t txBytes, const uint32_t drops) {
+        size_t n = printColumn(out, static_cast<uint32_t>(rxBytes), 11);
+        n += printColumn(out, static_cast<uint32_t>(txBytes), 11);
+        n += printColumn(out, drops, 8);
+        return n;
+    }
+#endif
+}
+
+size_t SessionReport::printTo(Print &printObject) const {
+    size_t n = printObject.print("        id name        ");
+#ifdef LIBSMART_ENABLE_SESSION_STATISTICS
+    n += printObject.print("    loops  loop_us   max_us     msgs    resps  resp_us   max_us");
+#endif
+#ifdef LIBSMART_ENABLE_BUFFER_STATISTICS
+    n += printObject.print("   rx_bytes   tx_bytes   drops");
+#endif
+    n += printObject.println();
+
+#ifdef LIBSMART_ENABLE_SESSION_STATISTICS
+    const ManagerStatistics &managerStatistics = manager.getStatistics();
+    SessionStatistics total = managerStatistics.closed;
+#ifdef LIBSMART_ENABLE_BUFFER_STATISTICS
+    uint64_t totalRx = managerStatistics.closedRxBytes;
+    uint64_t totalTx = managerStatistics.closedTxBytes;
+    uint32_t totalDrops = managerStatistics.closedDrops;
+#endif
+#endif
+
+    for (StreamSessionInterface *session = manager.getFirstSession(); session != nullptr;
+         session = manager.getNextSession(session)) {
+        n += printColumn(printObject, session->getId(), 10);
+        n += printObject.print(' ');
+        n += printTextColumn(printObject, session->getName(), 12);
+#ifdef LIBSMART_ENABLE_SESSION_STATISTICS
+        n += printStatistics(printObject, session->getStatistics());
+        total.add(session->getStatistics());
+#endif
+#ifdef LIBSMART_ENABLE_BUFFER_STATISTICS
+        const BufferStatistics &rx = session->getRxStatistics();
+        const BufferStatistics &tx = session->getTxStatistics();
+        n += printTraffic(printObject, rx.bytesIn, tx.bytesOut, rx.rejectedBytes + tx.rejectedBytes);
+#ifdef LIBSMART_ENABLE_SESSION_STATISTICS
+        totalRx += rx.bytesIn;
+        totalTx += tx.bytesOut;
+        totalDrops += rx.rejectedBytes + tx.rejectedBytes;
+#endif
+#endif
+        n += printObject.println();
+    }
+
+#ifdef LIBSMART_ENABLE_SESSION_STATISTICS
+    n += printTextColumn(printObject, "     total", 23);
+    n += printStatistics(printObject, total);
+#ifdef LIBSMART_ENABLE_BUFFER_STATISTICS
+    n += printTraffic(printObject, totalRx, totalTx, totalDrops);
+#endif
+    n += printObject.println();
+#endif
+
+    n += printObject.print("in use ");
+    n += printObject.print(static_cast<uint32_t>(manager.getSessionsInUse()));
+    n += printObject.print('/');
+    n += printObject.print(static_cast<uint32_t>(manager.getSessionsInUse() + manager.getFreeSessions()));
+#ifdef LIBSMART_ENABLE_SESSION_STATISTICS
+    n += printObject.print(", peak ");
+    n += printObject.print(managerStatistics.peakInUse);
+    n += printObject.print(", opened ");
+    n += printObject.print(managerStatistics.opened);
+    n += printObject.print(", rejected ");
+    n += printObject.print(managerStatistics.rejected);
+#endif
+    n += printObject.println();
+    return n;
+}
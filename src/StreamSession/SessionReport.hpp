@@ -0,0 +1,36 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef LIBSMART_STM32COMMON_STREAMSESSION_SESSIONREPORT_HPP
+#define LIBSMART_STM32COMMON_STREAMSESSION_SESSIONREPORT_HPP
+
+#include "ManagerInterface.hpp"
+#include "Printable.hpp"
+
+namespace Stm32Common::StreamSession {
+    /**
+     * @brief Prints the open sessions of a manager, e.g. for a "sessions" shell command.
+     *
+     * With LIBSMART_ENABLE_SESSION_STATISTICS every session is printed with its loops, mean and longest loop
+     * time, messages, responses and mean and longest response time, followed by a total line that includes the
+     * sessions that have been removed. With LIBSMART_ENABLE_BUFFER_STATISTICS the received and sent bytes and the
+     * bytes dropped by the buffers are added.
+     *
+     * @code
+     * shell.print(Stm32Common::StreamSession::SessionReport(sessionManager));
+     * @endcode
+     */
+    class SessionReport : public Printable {
+    public:
+        explicit SessionReport(ManagerInterface &manager) : manager(manager) { ; }
+
+        size_t printTo(Print &printObject) const override;
+
+    private:
+        ManagerInterface &manager;
+    };
+}
+
+#endif
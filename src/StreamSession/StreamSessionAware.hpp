@@ -25,6 +25,11 @@ namespace Stm32Common::StreamSession {
         /**
          * Notifies that data is ready to be transmitted for the given session.
          *
+         * The session manager does not poll the sessions, it calls loop() of a session only after a wakeUp(). So the
+         * owner sends as much of the transmit buffer as it can right here. If data is left, the session wakes itself
+         * up again and this method is called in the next pass. Reading from the transmit buffer wakes the session up,
+         * too, so an owner that sends asynchronously, e.g. by DMA, is called again when the transfer has completed.
+         *
          * @param session A pointer to the StreamSessionInterface indicating the session for which the data is ready.
          */
         virtual void dataReadyTx(StreamSessionInterface *session) { ; }
@@ -0,0 +1,24 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "StreamSessionInterface.hpp"
+#include "ManagerInterface.hpp"
+
+using namespace Stm32Common::StreamSession;
+
+void StreamSessionInterface::wakeUp() {
+    // Copy the pointer, endStreamSession() may clear it in between
+    ManagerInterface *manager = sessionManager;
+    if (manager != nullptr) manager->wakeUp(this);
+}
+
+size_t StreamSessionInterface::getTxAllowance() {
+    const size_t length = getTxBuffer()->getLength();
+    if (txLimiter == nullptr || length == 0) return length;
+    const size_t available = txLimiter->getAvailable();
+    if (available >= length) return length;
+    wakeUp();
+    return available;
+}
@@ -9,6 +9,10 @@
 #include "Loggable.hpp"
 #include "Nameable.hpp"
 #include "StreamRxTxInterface.hpp"
+#include "TokenBucket.hpp"
+#ifdef LIBSMART_ENABLE_SESSION_STATISTICS
+#include "Timebase.hpp"
+#endif
 #include "Process/ProcessInterface.hpp"
 
 namespace Stm32Common::StreamSession {
@@ -19,6 +23,54 @@ namespace Stm32Common::StreamSession {
     template<class StreamSessionT, size_t MaxSessionCount>
     class Manager;
 
+#ifdef LIBSMART_ENABLE_SESSION_STATISTICS
+    /**
+     * @brief Counters of a session, see StreamSessionInterface::getStatistics().
+     *
+     * The manager times every loop() of the session. A response is the first write to the transmit buffer after
+     * data has arrived in the receive buffer, its time is measured from the arrival.
+     */
+    struct SessionStatistics {
+        uint32_t loops = 0;
+        uint32_t maxLoop_cycles = 0;
+        uint64_t totalLoop_cycles = 0;
+        uint32_t messages = 0;
+        uint32_t responses = 0;
+        uint32_t maxResponse_cycles = 0;
+        uint64_t totalResponse_cycles = 0;
+
+        void recordLoop(const uint32_t cycles) {
+            loops++;
+            totalLoop_cycles += cycles;
+            if (cycles > maxLoop_cycles) maxLoop_cycles = cycles;
+        }
+
+        void recordResponse(const uint32_t cycles) {
+            responses++;
+            totalResponse_cycles += cycles;
+            if (cycles > maxResponse_cycles) maxResponse_cycles = cycles;
+        }
+
+        void add(const SessionStatistics &other) {
+            loops += other.loops;
+            totalLoop_cycles += other.totalLoop_cycles;
+            if (other.maxLoop_cycles > maxLoop_cycles) maxLoop_cycles = other.maxLoop_cycles;
+            messages += other.messages;
+            responses += other.responses;
+            totalResponse_cycles += other.totalResponse_cycles;
+            if (other.maxResponse_cycles > maxResponse_cycles) maxResponse_cycles = other.maxResponse_cycles;
+        }
+
+        [[nodiscard]] uint32_t getMeanLoop_cycles() const {
+            return loops == 0 ? 0 : static_cast<uint32_t>(totalLoop_cycles / loops);
+        }
+
+        [[nodiscard]] uint32_t getMeanResponse_cycles() const {
+            return responses == 0 ? 0 : static_cast<uint32_t>(totalResponse_cycles / responses);
+        }
+    };
+#endif
+
     class StreamSessionInterface : public virtual StreamRxTxInterface, public Process::ProcessInterface,
                                    public Nameable,
                                    public Stm32ItmLogger::Loggable {
@@ -46,7 +98,80 @@ namespace Stm32Common::StreamSession {
          */
         virtual uint32_t getId() { return id; }
 
+        /**
+         * @brief Marks the session as ready, so the session manager calls its loop() in the next pass.
+         *
+         * This is called automatically when data is written to the receive or transmit buffer and when data is read
+         * from the transmit buffer. A session that has more work to do without any buffer activity calls it from
+         * its loop(). This method can be called from an ISR.
+         */
+        void wakeUp();
+
+        /**
+         * @brief Limits the rate at which the owner sends the transmit buffer. nullptr removes the limit.
+         *
+         * The limiter is not owned by the session and can be shared by several sessions to limit them together.
+         */
+        void setTxLimiter(TokenBucket *txLimiter) { this->txLimiter = txLimiter; }
+
+        [[nodiscard]] TokenBucket *getTxLimiter() const { return txLimiter; }
+
+        /**
+         * @brief Returns the number of bytes of the transmit buffer the owner may send now.
+         *
+         * Owners call this in dataReadyTx() instead of getTxBuffer()->getLength() and report the bytes they have
+         * sent with txSent(). If the limiter holds bytes back, the session stays ready, so the manager calls its
+         * loop() again in the next pass.
+         */
+        size_t getTxAllowance();
+
+        /**
+         * @brief Reports the number of bytes the owner has sent from the transmit buffer.
+         */
+        void txSent(const size_t size) {
+            if (txLimiter != nullptr) txLimiter->consume(size);
+        }
+
+#ifdef LIBSMART_ENABLE_SESSION_STATISTICS
+        /**
+         * @brief Returns the counters of the session since it has been set up. The byte counters are part of the
+         * buffer statistics, see getRxStatistics() and getTxStatistics().
+         */
+        [[nodiscard]] const SessionStatistics &getStatistics() const { return statistics; }
+#endif
+
     protected:
+#ifdef LIBSMART_ENABLE_SESSION_STATISTICS
+        void onWriteRx() override {
+            if (rxArrival_cycles == 0) rxArrival_cycles = Timebase::getCycles32() | 1;
+            wakeUp();
+        }
+
+        void onWriteTx() override {
+            const uint32_t arrival = rxArrival_cycles;
+            if (arrival != 0) {
+                rxArrival_cycles = 0;
+                statistics.recordResponse(Timebase::getCycles32() - arrival);
+            }
+            wakeUp();
+        }
+#else
+        void onWriteRx() override { wakeUp(); }
+
+        void onWriteTx() override { wakeUp(); }
+#endif
+
+        void onReadTx() override { wakeUp(); }
+
+        /**
+         * @brief Counts a complete message, e.g. a line or a frame. Which data makes a message is up to the session.
+         */
+        void countMessage() {
+#ifdef LIBSMART_ENABLE_SESSION_STATISTICS
+            statistics.messages++;
+#endif
+        }
+
         /**
          * @brief Initializes the stream session with the specified ID.
          *
@@ -62,6 +187,14 @@ namespace Stm32Common::StreamSession {
             this->id = id;
             this->sessionOwner = sessionOwner;
             this->sessionManager = sessionManager;
+#ifdef LIBSMART_ENABLE_SESSION_STATISTICS
+            statistics = {};
+            rxArrival_cycles = 0;
+#endif
+#ifdef LIBSMART_ENABLE_BUFFER_STATISTICS
+            getRxBuffer()->clearStatistics();
+            getTxBuffer()->clearStatistics();
+#endif
         }
 
         /**
@@ -77,12 +210,18 @@ namespace Stm32Common::StreamSession {
             id = UINT32_MAX;
             sessionManager = nullptr;
             sessionOwner = nullptr;
+            txLimiter = nullptr;
         }
 
         bool inUse = false;
         uint32_t id = UINT32_MAX;
         ManagerInterface *sessionManager{};
         StreamSessionAware *sessionOwner{};
+        TokenBucket *txLimiter{};
+#ifdef LIBSMART_ENABLE_SESSION_STATISTICS
+        SessionStatistics statistics;
+        volatile uint32_t rxArrival_cycles = 0; // 0: no data is waiting for a response
+#endif
     };
 }
 #endif
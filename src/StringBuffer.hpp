@@ -7,11 +7,16 @@
 #define LIBSMART_STM32COMMON_STRINGBUFFER_HPP
 
 #include <algorithm>
+#include <atomic>
 #include <libsmart_config.hpp>
 #include <cstddef>
+#include "DeferredCallQueue.hpp"
 #include "Helper.hpp"
 #include "StringBufferInterface.hpp"
 #include "Stream.hpp"
+#ifdef LIBSMART_ENABLE_TRACE
+#include "Trace.hpp"
+#endif
 
 #ifdef LIBSMART_ENABLE_STD_FUNCTION
 #include <functional>
@@ -57,18 +62,18 @@ namespace Stm32Common {
          * \return True if the StringBuffer is full, false otherwise.
          */
         [[nodiscard]] bool isFull() override {
-            return head == Size;
+            return head + pending == Size;
         }
 
         /**
          * Get the remaining space of the StringBuffer.
          *
-         * This method returns the number of bytes that are available for writing to the StringBuffer. It is calculated by subtracting the head index from the maximum buffer size (Size).
+         * This method returns the number of bytes that are available for writing to the StringBuffer. It is calculated by subtracting the head index and the bytes reserved by an open transaction from the maximum buffer size (Size).
          *
          * \return The number of bytes available for writing.
          */
         [[nodiscard]] buf_size_t getRemainingSpace() override {
-            return Size - head;
+            return Size - head - pending;
         }
 
         /**
@@ -109,7 +114,11 @@ namespace Stm32Common {
         buf_size_t write(const uint8_t *in, buf_size_t strlen) override {
             if (in == nullptr) return 0;
             if (strlen == 0) return 0;
-            if (getRemainingSpace() < strlen) return 0;
+            if (getRemainingSpace() < strlen) {
+                abortTransaction();
+                countRejected(strlen);
+                return 0;
+            }
             memcpy(_getWritePointer(), in, strlen);
             return add(strlen);
         }
@@ -125,9 +134,17 @@ namespace Stm32Common {
 
 
         buf_size_t vprintf(const char *format, va_list args) PRINTF_OVERRIDE {
-            const int len = vsnprintf(reinterpret_cast<char *>(_getWritePointer()), getRemainingSpace(), format, args);
+            const buf_size_t space = getRemainingSpace();
+            const int len = vsnprintf(reinterpret_cast<char *>(_getWritePointer()), space, format, args);
             if (len <= 0) return 0;
-            return add(std::min(static_cast<buf_size_t>(len), getRemainingSpace()));
+            if (static_cast<buf_size_t>(len) >= space) {
+                // vsnprintf() needs the last byte for the NUL, so only space - 1 characters have been written
+                const buf_size_t written = space > 0 ? space - 1 : 0;
+                abortTransaction();
+                countRejected(len - written);
+                return add(written);
+            }
+            return add(len);
         }
 #endif
 
@@ -179,7 +196,7 @@ namespace Stm32Common {
 
     private:
         uint8_t *_getWritePointer() {
-            return buffer + head;
+            return buffer + head + pending;
         }
 
         const uint8_t *_getReadPointer() {
@@ -189,14 +206,18 @@ namespace Stm32Common {
     public:
         buf_size_t add(const buf_size_t add) override {
             const size_t sz = std::min(getRemainingSpace(), add);
+            if (sz < add) {
+                abortTransaction();
+                countRejected(add - sz);
+            }
             if (sz == 0) return 0;
-            head += sz;
-            if (head == sz) {
-                onNonEmpty();
-                onNonEmptyFunction();
+            if (transactionDepth > 0) {
+                pending = pending + sz;
+                return sz;
             }
-            onWrite();
-            onWriteFunction();
+            head = head + sz;
+            countCommitted(sz);
+            fireHooks(head == sz ? HOOK_NON_EMPTY | HOOK_WRITE : HOOK_WRITE);
             return sz;
         }
 
@@ -209,14 +230,17 @@ namespace Stm32Common {
         buf_size_t remove(const buf_size_t remove) override {
             const size_t sz = std::min(getLength(), remove);
             if (sz == 0) return 0;
-            tail += sz;
+            tail = tail + sz;
+#ifdef LIBSMART_ENABLE_BUFFER_STATISTICS
+            statistics.bytesOut += sz;
+            if (head == tail) statistics.drains++;
+#endif
             if (head == tail) {
-                clear();
-                onEmpty();
-                onEmptyFunction();
+                if (pending == 0) clear();
+                fireHooks(HOOK_EMPTY | HOOK_READ);
+            } else {
+                fireHooks(HOOK_READ);
             }
-            onRead();
-            onReadFunction();
             return sz;
         }
 
@@ -227,6 +251,7 @@ namespace Stm32Common {
         void clear() override {
             head = 0;
             tail = 0;
+            pending = 0;
             std::memset(buffer, 0, Size);
         }
 
@@ -269,6 +294,53 @@ namespace Stm32Common {
             //DOES NOTHING
         }
 
+        /**
+         * Start a transaction.
+         *
+         * Bytes added within a transaction are reserved behind the head index. They are neither visible to readers
+         * nor do they fire any callback until the outermost transaction is committed by endTransaction().
+         */
+        void beginTransaction() override {
+            if (transactionDepth++ == 0) {
+                transactionFailed = false;
+            }
+        }
+
+        /**
+         * End a transaction.
+         *
+         * When the outermost transaction ends, all reserved bytes are committed at once and onNonEmpty()/onWrite()
+         * are fired a single time. If a write within the transaction did not fit, the reserved bytes are discarded.
+         *
+         * \return True if the transaction was committed, false if it was rolled back.
+         */
+        bool endTransaction() override {
+            if (transactionDepth == 0) return true;
+            if (--transactionDepth > 0) return !transactionFailed;
+            if (transactionFailed) {
+#ifdef LIBSMART_ENABLE_BUFFER_STATISTICS
+                // The write that failed has been counted already, only the bytes reserved before it are added
+                statistics.rejectedBytes += pending;
+#endif
+                pending = 0;
+                return false;
+            }
+            if (pending == 0) return true;
+            const bool wasEmpty = isEmpty();
+            head = head + pending;
+            countCommitted(pending);
+            pending = 0;
+            fireHooks(wasEmpty ? HOOK_NON_EMPTY | HOOK_WRITE : HOOK_WRITE);
+            return true;
+        }
+
+        /**
+         * Mark the current transaction to be rolled back. Does nothing outside of a transaction.
+         */
+        void abortTransaction() override {
+            if (transactionDepth > 0) transactionFailed = true;
+        }
+
         buf_size_signed_t findPos(const uint8_t c) override {
             for (buf_size_t i = 0; i < getLength(); i++) {
                 const auto ch = peek(i);
@@ -292,7 +364,8 @@ namespace Stm32Common {
          * This function sets the callback function for write operations. The provided on_write_fn will be called
          * whenever a write operation is performed on the StringBuffer.
          *
-         * Note: Take care when using StrinBuffer with interrupts. Some callbacks are called by the isr.
+         * Note: Take care when using StrinBuffer with interrupts. Some callbacks are called by the isr, see
+         * setDeferredCallQueue().
          *
          * \param on_write_fn The callback function for write operations.
          */
@@ -301,6 +374,35 @@ namespace Stm32Common {
 
         void setOnReadFn(const onReadFn_t &on_read_fn) override { onReadFn = on_read_fn; }
 
+#endif
+
+        /**
+         * Route callbacks that are triggered by an ISR through a deferred-call queue.
+         *
+         * While a queue is set, onNonEmpty(), onWrite(), onEmpty() and onRead() and their callback functions are
+         * not called by the isr, but later by the consumer of the queue. Callbacks that are triggered while an
+         * earlier deferred call is still queued are merged into it, so each callback runs at most once per drain
+         * and has to look at the current state of the buffer instead of counting calls. If the queue is full, the
+         * callbacks are called by the isr as before.
+         *
+         * \param queue The queue, or nullptr to call all callbacks directly.
+         */
+        void setDeferredCallQueue(DeferredCallQueueBase *queue) override { deferredCallQueue = queue; }
+
+#ifdef LIBSMART_ENABLE_BUFFER_STATISTICS
+        [[nodiscard]] const BufferStatistics &getStatistics() const override { return statistics; }
+
+        void clearStatistics() override {
+            statistics = {};
+            statistics.highWater = head - tail;
+        }
+#endif
+
+#ifdef LIBSMART_ENABLE_TRACE
+        void setTraceId(const uint8_t id, const char *name) override {
+            traceId = id;
+            if (id != 0) Tracer::name(Trace::EventType::COUNTER, id, name);
+        }
 #endif
 
     protected:
@@ -315,6 +417,70 @@ namespace Stm32Common {
         virtual void onRead() { ; }
 
     private:
+        enum : uint8_t {
+            HOOK_NON_EMPTY = 0x01,
+            HOOK_WRITE = 0x02,
+            HOOK_EMPTY = 0x04,
+            HOOK_READ = 0x08
+        };
+
+        // Called by the writer after bytes have been committed, the reader only updates bytesOut and drains
+        void countCommitted(const size_t bytes) {
+#ifdef LIBSMART_ENABLE_BUFFER_STATISTICS
+            statistics.bytesIn += bytes;
+            if (head - tail > statistics.highWater) statistics.highWater = head - tail;
+#else
+            LIBSMART_UNUSED(bytes);
+#endif
+        }
+
+        void countRejected(const size_t bytes) {
+#ifdef LIBSMART_ENABLE_BUFFER_STATISTICS
+            statistics.rejectedWrites++;
+            statistics.rejectedBytes += bytes;
+#else
+            LIBSMART_UNUSED(bytes);
+#endif
+        }
+
+        void fireHooks(const uint8_t hooks) {
+#ifdef LIBSMART_ENABLE_TRACE
+            if (traceId != 0) Tracer::counter(traceId, static_cast<uint16_t>(getLength()));
+#endif
+            if (deferredCallQueue != nullptr && isInIsr()) {
+                // Only the first pending hook posts, later ones are merged into the queued call
+                if (deferredHooks.fetch_or(hooks) != 0) return;
+                if (deferredCallQueue->post(runDeferredHooks, this)) return;
+                runHooks(deferredHooks.exchange(0));
+                return;
+            }
+            runHooks(hooks);
+        }
+
+        static void runDeferredHooks(void *context) {
+            auto *self = static_cast<StringBuffer *>(context);
+            self->runHooks(self->deferredHooks.exchange(0));
+        }
+
+        void runHooks(const uint8_t hooks) {
+            if (hooks & HOOK_NON_EMPTY) {
+                onNonEmpty();
+                onNonEmptyFunction();
+            }
+            if (hooks & HOOK_WRITE) {
+                onWrite();
+                onWriteFunction();
+            }
+            if (hooks & HOOK_EMPTY) {
+                onEmpty();
+                onEmptyFunction();
+            }
+            if (hooks & HOOK_READ) {
+                onRead();
+                onReadFunction();
+            }
+        }
+
         void init() {
             clear();
             onInit();
@@ -334,6 +500,17 @@ namespace Stm32Common {
         uint8_t buffer[Size] = {};
         volatile size_t head = 0; // Index of the next free byte for write
         volatile size_t tail = 0; // Index of the next byte to read
+        volatile size_t pending = 0; // Bytes reserved behind head by an open transaction
+        uint8_t transactionDepth = 0;
+        bool transactionFailed = false;
+        DeferredCallQueueBase *deferredCallQueue = nullptr;
+        std::atomic<uint8_t> deferredHooks{0}; // Hooks waiting in the deferred-call queue
+#ifdef LIBSMART_ENABLE_TRACE
+        uint8_t traceId = 0;
+#endif
+#ifdef LIBSMART_ENABLE_BUFFER_STATISTICS
+        BufferStatistics statistics;
+#endif
     };
 }
 
@@ -8,6 +8,7 @@
 
 #include <libsmart_config.hpp>
 #include <cstddef>
+#include "DeferredCallQueue.hpp"
 #include "Stream.hpp"
 
 #ifdef LIBSMART_ENABLE_STD_FUNCTION
@@ -30,6 +31,20 @@ namespace Stm32Common {
     typedef size_t buf_size_t;
     typedef int64_t buf_size_signed_t;
 
+#ifdef LIBSMART_ENABLE_BUFFER_STATISTICS
+    /**
+     * @brief Counters of a StringBuffer, see StringBufferInterface::getStatistics().
+     */
+    struct BufferStatistics {
+        uint32_t bytesIn = 0; // Bytes that have been committed to the buffer
+        uint32_t bytesOut = 0; // Bytes that have been removed from the buffer
+        uint32_t highWater = 0; // Largest length since the last clearStatistics() [bytes]
+        uint32_t rejectedWrites = 0; // Writes that did not fit completely
+        uint32_t rejectedBytes = 0; // Bytes that have been lost, including the bytes of rolled back transactions
+        uint32_t drains = 0; // Times the buffer has been read until it was empty
+    };
+#endif
+
     class StringBufferInterface : public Stream {
     public:
         /**
@@ -183,7 +198,8 @@ namespace Stm32Common {
          * This function sets the callback function for write operations. The provided on_write_fn will be called
          * whenever a write operation is performed on the StringBuffer.
          *
-         * Note: Take care when using StrinBuffer with interrupts. Some callbacks are called by the isr.
+         * Note: Take care when using StrinBuffer with interrupts. Some callbacks are called by the isr, see
+         * setDeferredCallQueue().
          *
          * \param on_write_fn The callback function for write operations.
          */
@@ -192,6 +208,32 @@ namespace Stm32Common {
 
         virtual void setOnReadFn(const onReadFn_t &on_read_fn) = 0;
 #endif
+
+        /**
+         * Route callbacks that are triggered by an ISR through a deferred-call queue, nullptr calls them directly.
+         */
+        virtual void setDeferredCallQueue(DeferredCallQueueBase *queue) = 0;
+
+#ifdef LIBSMART_ENABLE_TRACE
+        /**
+         * Trace the length of the buffer after every write and read as counter with the given id (1..255) and name.
+         * The name is sent immediately, so call this after Tracer::begin(). 0 disables tracing.
+         */
+        virtual void setTraceId(uint8_t id, const char *name) = 0;
+#endif
+
+#ifdef LIBSMART_ENABLE_BUFFER_STATISTICS
+        /**
+         * Get the counters of the buffer. An undersized buffer shows rejected writes with a high-water mark at the
+         * size of the buffer, a stalling consumer shows few drains.
+         */
+        [[nodiscard]] virtual const BufferStatistics &getStatistics() const = 0;
+
+        /**
+         * Reset the counters, the high-water mark restarts at the current length.
+         */
+        virtual void clearStatistics() = 0;
+#endif
     };
 }
 
@@ -0,0 +1,71 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "Timebase.hpp"
+#include "Helper.hpp"
+#ifdef LIBSMART_HOST_BUILD
+#include "HostHal.hpp"
+#else
+#include <main.h>
+#endif
+
+using namespace Stm32Common;
+
+#if defined(LIBSMART_HOST_BUILD)
+// One cycle is one nanosecond of the simulated time of the HostHal
+uint32_t Timebase::frequency = 1000000000U;
+uint32_t Timebase::microsPerCycle = static_cast<uint32_t>(((1000000ULL << 32) + 1000000000U - 1) / 1000000000U);
+uint32_t Timebase::nanosPerCycle = 1U << 16;
+#else
+uint32_t Timebase::frequency = 0;
+uint32_t Timebase::microsPerCycle = 0;
+uint32_t Timebase::nanosPerCycle = 0;
+#endif
+uint32_t Timebase::lastCycles32 = 0;
+uint32_t Timebase::overflows = 0;
+
+void Timebase::begin() {
+#if defined(LIBSMART_HOST_BUILD)
+    frequency = 1000000000U;
+#elif defined(DWT_CTRL_CYCCNTENA_Msk)
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    frequency = SystemCoreClock;
+#else
+    // Cores without DWT (Cortex-M0) count microseconds
+    frequency = 1000000U;
+#endif
+    // Rounded up, so whole microseconds and nanoseconds are not converted to one less
+    microsPerCycle = static_cast<uint32_t>(((1000000ULL << 32) + frequency - 1) / frequency);
+    nanosPerCycle = static_cast<uint32_t>(((1000000000ULL << 16) + frequency - 1) / frequency);
+    lastCycles32 = 0;
+    overflows = 0;
+}
+
+uint32_t Timebase::getCycles32() {
+#if defined(LIBSMART_HOST_BUILD)
+    return static_cast<uint32_t>(getCycles());
+#elif defined(DWT_CTRL_CYCCNTENA_Msk)
+    return DWT->CYCCNT;
+#else
+    return static_cast<uint32_t>(micros());
+#endif
+}
+
+uint64_t Timebase::getCycles() {
+#if defined(LIBSMART_HOST_BUILD)
+    return Host::HostHal::getTimeNanos();
+#else
+    const uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    const uint32_t cycles32 = getCycles32();
+    if (cycles32 < lastCycles32) overflows++;
+    lastCycles32 = cycles32;
+    const uint64_t cycles = static_cast<uint64_t>(overflows) << 32 | cycles32;
+    __set_PRIMASK(primask);
+    return cycles;
+#endif
+}
@@ -0,0 +1,111 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef LIBSMART_STM32COMMON_TIMEBASE_HPP
+#define LIBSMART_STM32COMMON_TIMEBASE_HPP
+
+#include <libsmart_config.hpp>
+#include <cstdint>
+
+namespace Stm32Common {
+    /**
+     * @brief Monotonic high resolution time base.
+     *
+     * On the MCU, the time base is the DWT cycle counter (CYCCNT), extended to 64 bit in software. On a host build
+     * (LIBSMART_HOST_BUILD), the time of the HostHal is used, including its virtual time, and a cycle is one
+     * nanosecond.
+     *
+     * The 32 bit cycle counter overflows every 2^32 cycles (59 s at 72 MHz). The 64 bit extension detects an
+     * overflow when the counter is read, so getCycles() or update() has to be called at least once per overflow
+     * period, e.g. from a RunEvery object:
+     * @code
+     * Stm32Common::Timebase::begin();
+     * Stm32Common::RunEvery timebaseUpdate(10000, []() { Stm32Common::Timebase::update(); });
+     * @endcode
+     *
+     * Cycles are converted to microseconds with a multiplication instead of a division. The conversion factor is
+     * computed by begin(), so begin() has to be called again after the core clock has changed.
+     */
+    class Timebase {
+    public:
+        /**
+         * @brief Enables the cycle counter and computes the conversion factors from SystemCoreClock.
+         */
+        static void begin();
+
+        /**
+         * @brief Returns the lower 32 bit of the cycle counter. This is a single register read on the MCU.
+         */
+        [[nodiscard]] static uint32_t getCycles32();
+
+        /**
+         * @brief Returns the 64 bit cycle counter. This method can be called from an ISR.
+         */
+        [[nodiscard]] static uint64_t getCycles();
+
+        /**
+         * @brief Returns the microseconds since begin().
+         */
+        [[nodiscard]] static uint64_t getMicros() { return cyclesToMicros(getCycles()); }
+
+        /**
+         * @brief Returns the lower 32 bit of getMicros(). They overflow every 71 minutes.
+         */
+        [[nodiscard]] static uint32_t getMicros32() { return static_cast<uint32_t>(getMicros()); }
+
+        /**
+         * @brief Keeps the 64 bit extension of the cycle counter up to date.
+         */
+        static void update() { (void) getCycles(); }
+
+        /**
+         * @brief Returns the cycle counter frequency [Hz].
+         */
+        [[nodiscard]] static uint32_t getFrequency() { return frequency; }
+
+        /**
+         * @brief Converts a number of cycles to microseconds.
+         */
+        [[nodiscard]] static uint64_t cyclesToMicros(const uint64_t cycles) {
+            // 32.32 fixed point multiplication, split to stay within 64 bit
+            const auto high = static_cast<uint32_t>(cycles >> 32);
+            const auto low = static_cast<uint32_t>(cycles);
+            return static_cast<uint64_t>(high) * microsPerCycle +
+                   ((static_cast<uint64_t>(low) * microsPerCycle) >> 32);
+        }
+
+        /**
+         * @brief Converts a number of cycles to nanoseconds.
+         */
+        [[nodiscard]] static uint64_t cyclesToNanos(const uint64_t cycles) {
+            // 16.16 fixed point multiplication, split to stay within 64 bit
+            const auto high = static_cast<uint32_t>(cycles >> 32);
+            const auto low = static_cast<uint32_t>(cycles);
+            return ((static_cast<uint64_t>(high) * nanosPerCycle) << 16) +
+                   ((static_cast<uint64_t>(low) * nanosPerCycle) >> 16);
+        }
+
+        /**
+         * @brief Converts microseconds to cycles.
+         */
+        [[nodiscard]] static uint64_t microsToCycles(const uint64_t micros) {
+            return micros * (frequency / 1000000U);
+        }
+
+    private:
+        static uint32_t frequency;
+
+        /** Microseconds per cycle as 32.32 fixed point number */
+        static uint32_t microsPerCycle;
+
+        /** Nanoseconds per cycle as 16.16 fixed point number */
+        static uint32_t nanosPerCycle;
+
+        static uint32_t lastCycles32;
+        static uint32_t overflows;
+    };
+}
+
+#endif
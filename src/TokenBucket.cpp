@@ -0,0 +1,69 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "TokenBucket.hpp"
+
+using namespace Stm32Common;
+
+TokenBucket::TokenBucket(const uint32_t rate_Bps, const uint32_t burst)
+    : rate_Bps(rate_Bps),
+      burst(burst < MaxBurst ? burst : MaxBurst),
+      tokens_mB(this->burst * 1000),
+      last_ms(clock()) { ; }
+
+void TokenBucket::setRate(const uint32_t rate_Bps, const uint32_t burst) {
+    this->rate_Bps = rate_Bps;
+    this->burst = burst < MaxBurst ? burst : MaxBurst;
+    tokens_mB = this->burst * 1000;
+    last_ms = clock();
+}
+
+void TokenBucket::setClock(const clock_fn_t clock) {
+    this->clock = clock;
+    last_ms = clock();
+}
+
+size_t TokenBucket::getAvailable() {
+    refill();
+    return tokens_mB / 1000;
+}
+
+size_t TokenBucket::take(const size_t wanted) {
+    const size_t available = getAvailable();
+    const size_t granted = wanted < available ? wanted : available;
+    tokens_mB -= granted * 1000;
+    return granted;
+}
+
+void TokenBucket::consume(const size_t size) {
+    // size <= tokens_mB / 1000 is size * 1000 <= tokens_mB, without the overflow of size * 1000
+    tokens_mB = size <= tokens_mB / 1000 ? tokens_mB - size * 1000 : 0;
+}
+
+uint32_t TokenBucket::getTimeUntilAvailable(const size_t size) {
+    refill();
+    if (size > burst) return UINT32_MAX;
+    // Does not overflow, burst is at most MaxBurst
+    const uint32_t needed_mB = size * 1000;
+    if (tokens_mB >= needed_mB) return 0;
+    if (rate_Bps == 0) return UINT32_MAX;
+    return static_cast<uint32_t>((static_cast<uint64_t>(needed_mB - tokens_mB) + rate_Bps - 1) / rate_Bps);
+}
+
+void TokenBucket::refill() {
+    const uint32_t now = clock();
+    const uint32_t elapsed_ms = now - last_ms;
+    if (elapsed_ms == 0) return;
+    last_ms = now;
+
+    // bytes/s * ms = 1/1000 bytes
+    const uint32_t capacity_mB = burst * 1000;
+    const uint32_t missing_mB = capacity_mB - tokens_mB;
+    if (rate_Bps != 0 && elapsed_ms > missing_mB / rate_Bps) {
+        tokens_mB = capacity_mB;
+    } else {
+        tokens_mB += elapsed_ms * rate_Bps;
+    }
+}
@@ -0,0 +1,94 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef LIBSMART_STM32COMMON_TOKENBUCKET_HPP
+#define LIBSMART_STM32COMMON_TOKENBUCKET_HPP
+
+#include <libsmart_config.hpp>
+#include <cstddef>
+#include <cstdint>
+#include "Helper.hpp"
+
+namespace Stm32Common {
+    /**
+     * @brief Token bucket that limits a byte stream to a rate with a burst.
+     *
+     * The bucket holds up to burst bytes and refills with rate bytes per second. Refilling is done once per call
+     * of getAvailable(), take() or getTimeUntilAvailable() with one read of the clock, by default millis() like
+     * RunEvery, never per byte. Tokens are counted in 1/1000 bytes, so rates below 1000 bytes/s do not lose
+     * precision to the millisecond clock.
+     *
+     * @code
+     * Stm32Common::TokenBucket logLimit(2000, 64); // 2000 bytes/s, bursts of up to 64 bytes
+     *
+     * const size_t n = logLimit.take(length);
+     * uart.write(data, n);
+     * @endcode
+     */
+    class TokenBucket {
+    public:
+        using clock_fn_t = unsigned long (*)();
+
+        /**
+         * @brief The largest burst, so the bucket fits into 32 bit in 1/1000 bytes [bytes].
+         */
+        static constexpr uint32_t MaxBurst = UINT32_MAX / 1000;
+
+        /**
+         * @param rate_Bps The long-term rate [bytes/s]. 0 blocks after the first burst.
+         * @param burst The maximum number of bytes that can be sent at once, at most MaxBurst [bytes]. The bucket
+         * starts full.
+         */
+        TokenBucket(uint32_t rate_Bps, uint32_t burst);
+
+        /**
+         * @brief Changes rate and burst. The bucket is filled up to the new burst. A burst above MaxBurst is
+         * limited to MaxBurst.
+         */
+        void setRate(uint32_t rate_Bps, uint32_t burst);
+
+        [[nodiscard]] uint32_t getRate() const { return rate_Bps; }
+
+        [[nodiscard]] uint32_t getBurst() const { return burst; }
+
+        /**
+         * @brief Replaces the clock, e.g. with a synthetic clock for simulations [ms].
+         */
+        void setClock(clock_fn_t clock);
+
+        /**
+         * @brief Returns the number of bytes that may be sent now.
+         */
+        size_t getAvailable();
+
+        /**
+         * @brief Grants up to wanted bytes and removes them from the bucket.
+         *
+         * @return The number of bytes that may be sent, 0 to wanted.
+         */
+        size_t take(size_t wanted);
+
+        /**
+         * @brief Removes bytes that have been sent after getAvailable(). More bytes than available empty the bucket.
+         */
+        void consume(size_t size);
+
+        /**
+         * @brief Returns the time until size bytes are available [ms], UINT32_MAX if they never will be.
+         */
+        uint32_t getTimeUntilAvailable(size_t size);
+
+    private:
+        void refill();
+
+        clock_fn_t clock = millis;
+        uint32_t rate_Bps;
+        uint32_t burst;
+        uint32_t tokens_mB; // 1/1000 bytes
+        uint32_t last_ms;
+    };
+}
+
+#endif
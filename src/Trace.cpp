@@ -0,0 +1,119 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "Trace.hpp"
+#include "Print.hpp"
+#include "Profiler.hpp"
+#include "Timebase.hpp"
+
+using namespace Stm32Common;
+
+namespace {
+    // Longer names are cut, so a NAME record fits into a small buffer on the stack
+    constexpr size_t maxNameLength = 32;
+
+    // Timestamps and writes the record within a critical section, so records of interrupts are not interleaved
+    // and the timestamps in the stream are ascending
+    void writeRecord(TraceSink *traceSink, uint32_t *words, const size_t count, const bool timestamp = true) {
+        const uint32_t primask = __get_PRIMASK();
+        __disable_irq();
+        if (timestamp) words[0] = Timebase::getCycles32();
+        traceSink->write(words, count);
+        __set_PRIMASK(primask);
+    }
+}
+
+TraceSink *volatile Tracer::sink = nullptr;
+
+
+#ifdef ITM_TCR_ITMENA_Msk
+bool ItmTraceSink::write(const uint32_t *words, const size_t count) {
+    if ((ITM->TCR & ITM_TCR_ITMENA_Msk) == 0 || (ITM->TER & (1UL << port)) == 0) return false;
+    for (size_t i = 0; i < count; i++) {
+        while (ITM->PORT[port].u32 == 0UL) {
+            __NOP();
+        }
+        ITM->PORT[port].u32 = words[i];
+    }
+    return true;
+}
+#endif
+
+
+bool RingTraceSinkBase::write(const uint32_t *data, const size_t count) {
+    const size_t h = head.load(std::memory_order_relaxed);
+    const size_t t = tail.load(std::memory_order_acquire);
+    if (getCapacity() - (h - t) < count) {
+        dropCount++;
+        return false;
+    }
+    for (size_t i = 0; i < count; i++) {
+        words[(h + i) & mask] = data[i];
+    }
+    head.store(h + count, std::memory_order_release);
+    return true;
+}
+
+size_t RingTraceSinkBase::drainTo(Print &printObject, const size_t maxWords) {
+    const size_t t = tail.load(std::memory_order_relaxed);
+    size_t count = head.load(std::memory_order_acquire) - t;
+    if (count > maxWords) count = maxWords;
+    const int space = printObject.availableForWrite();
+    if (space >= 0 && count > static_cast<size_t>(space) / 4) count = static_cast<size_t>(space) / 4;
+
+    for (size_t i = 0; i < count; i++) {
+        const uint32_t word = words[(t + i) & mask];
+        const uint8_t bytes[4] = {
+            static_cast<uint8_t>(word), static_cast<uint8_t>(word >> 8), static_cast<uint8_t>(word >> 16),
+            static_cast<uint8_t>(word >> 24)
+        };
+        printObject.write(bytes, sizeof(bytes));
+    }
+    tail.store(t + count, std::memory_order_release);
+    return count;
+}
+
+
+void Tracer::begin(TraceSink *traceSink) {
+    sink = traceSink;
+    if (traceSink == nullptr) return;
+
+    uint32_t sync[Trace::recordWords] = {Timebase::getFrequency(), Trace::packInfo(Trace::EventType::SYNC, 0, 0)};
+    writeRecord(traceSink, sync, Trace::recordWords, false);
+
+#ifdef LIBSMART_ENABLE_PROFILER
+    for (const ProfileZone *zone = Profiler::getInstance().getFirstZone(); zone != nullptr; zone = zone->getNext()) {
+        name(Trace::EventType::ZONE_BEGIN, zone->getTraceId(), zone->getName());
+    }
+#endif
+}
+
+void Tracer::name(const Trace::EventType space, const uint8_t id, const char *text) {
+    TraceSink *traceSink = sink;
+    if (traceSink == nullptr || text == nullptr) return;
+
+    size_t length = 0;
+    while (text[length] != '\0' && length < maxNameLength) length++;
+
+    uint32_t words[Trace::recordWords + maxNameLength / 4] = {
+        0, Trace::packInfo(Trace::EventType::NAME, id, Trace::packNameValue(space, length))
+    };
+    for (size_t i = 0; i < length; i++) {
+        words[Trace::recordWords + i / 4] |= static_cast<uint32_t>(static_cast<uint8_t>(text[i])) << (i % 4 * 8);
+    }
+    writeRecord(traceSink, words, Trace::recordWords + (length + 3) / 4);
+}
+
+void Tracer::event(const Trace::EventType type, const uint8_t id, const uint16_t value) {
+    TraceSink *traceSink = sink;
+    if (traceSink == nullptr) return;
+
+    uint32_t words[Trace::recordWords] = {0, Trace::packInfo(type, id, value)};
+    writeRecord(traceSink, words, Trace::recordWords);
+}
+
+uint8_t Tracer::getActiveIrq() {
+    return static_cast<uint8_t>(SCB->ICSR & SCB_ICSR_VECTACTIVE_Msk);
+}
@@ -0,0 +1,191 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef LIBSMART_STM32COMMON_TRACE_HPP
+#define LIBSMART_STM32COMMON_TRACE_HPP
+
+#include <libsmart_config.hpp>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <main.h>
+#include "TraceRecord.hpp"
+
+#ifndef LIBSMART_TRACE_ITM_PORT
+#define LIBSMART_TRACE_ITM_PORT 8
+#endif
+
+namespace Stm32Common {
+    class Print;
+
+    /**
+     * @brief Destination of the trace records.
+     */
+    class TraceSink {
+    public:
+        virtual ~TraceSink() = default;
+
+        /**
+         * @brief Writes one record. The words of a record must not be interleaved with other records.
+         *
+         * @return false if the record has been dropped.
+         */
+        virtual bool write(const uint32_t *words, size_t count) = 0;
+    };
+
+
+#ifdef ITM_TCR_ITMENA_Msk
+    /**
+     * @brief Writes the records to an ITM stimulus port, by default LIBSMART_TRACE_ITM_PORT.
+     *
+     * The port has to be enabled by the debugger, e.g. "itm port 8 on" in OpenOCD. Records are dropped while ITM
+     * or the port is disabled. Writing waits until the stimulus port can take the next word.
+     */
+    class ItmTraceSink : public TraceSink {
+    public:
+        explicit ItmTraceSink(const uint8_t port = LIBSMART_TRACE_ITM_PORT) : port(port) { ; }
+
+        bool write(const uint32_t *words, size_t count) override;
+
+    private:
+        const uint8_t port;
+    };
+#endif
+
+
+    /**
+     * @brief Keeps the records in RAM until they are drained, e.g. to a UART or by the debugger.
+     *
+     * This is the buffer size independent part of RingTraceSink. When the ring is full, new records are dropped
+     * and counted, so the stream always stays aligned to records.
+     */
+    class RingTraceSinkBase : public TraceSink {
+    public:
+        bool write(const uint32_t *words, size_t count) override;
+
+        /**
+         * @brief Writes up to maxWords words as little endian bytes to the given Print and removes them.
+         *
+         * @return The number of words written.
+         */
+        size_t drainTo(Print &printObject, size_t maxWords = SIZE_MAX);
+
+        [[nodiscard]] size_t getLength() const {
+            return head.load(std::memory_order_acquire) - tail.load(std::memory_order_relaxed);
+        }
+
+        [[nodiscard]] size_t getCapacity() const { return mask + 1; }
+
+        [[nodiscard]] uint32_t getDropCount() const { return dropCount; }
+
+    protected:
+        RingTraceSinkBase(uint32_t *words, const size_t capacity) : words(words), mask(capacity - 1) { ; }
+
+    private:
+        uint32_t *const words;
+        const size_t mask;
+        std::atomic<size_t> head{0};
+        std::atomic<size_t> tail{0};
+        uint32_t dropCount = 0;
+    };
+
+
+    /**
+     * @brief RingTraceSink for the given number of words, must be a power of two.
+     */
+    template<size_t Words>
+    class RingTraceSink : public RingTraceSinkBase {
+        static_assert(Words >= 2 * Trace::recordWords && (Words & (Words - 1)) == 0,
+                      "RingTraceSink needs a power of two number of words");
+
+    public:
+        RingTraceSink() : RingTraceSinkBase(ringWords, Words) { ; }
+
+    private:
+        uint32_t ringWords[Words] = {};
+    };
+
+
+    /**
+     * @brief Writes timestamped binary trace records to a TraceSink.
+     *
+     * With LIBSMART_ENABLE_TRACE the library traces the enter and exit of ProfileZone objects, the level of
+     * buffers with a trace id, and the wake-ups of stream sessions. Interrupt handlers can be traced with a
+     * Tracer::IsrScope, which records the active exception number. Records are timestamped and written within a
+     * critical section, so they can be written from interrupts and appear in the order of their timestamps.
+     *
+     * The host tool tools/trace2chrome converts the stream to Chrome Trace Event JSON, which can be viewed in
+     * chrome://tracing or Perfetto.
+     *
+     * @code
+     * static Stm32Common::ItmTraceSink traceSink;
+     *
+     * Stm32Common::Tracer::begin(&traceSink);
+     * rxBuffer.setTraceId(1, "uart rx");
+     *
+     * extern "C" void USART1_IRQHandler() {
+     *     Stm32Common::Tracer::IsrScope trace;
+     *     HAL_UART_IRQHandler(&huart1);
+     * }
+     * @endcode
+     */
+    class Tracer {
+    public:
+        /**
+         * @brief Traces an interrupt handler from its construction to its destruction.
+         */
+        class IsrScope {
+        public:
+            IsrScope() : irq(getActiveIrq()) { isrEnter(irq); }
+
+            ~IsrScope() { isrExit(irq); }
+
+            IsrScope(const IsrScope &) = delete;
+
+            IsrScope &operator=(const IsrScope &) = delete;
+
+        private:
+            const uint8_t irq;
+        };
+
+        /**
+         * @brief Starts the stream on the given sink with a SYNC record and the names of all profile zones.
+         */
+        static void begin(TraceSink *traceSink);
+
+        /**
+         * @brief Stops tracing, the sink is no longer used.
+         */
+        static void end() { sink = nullptr; }
+
+        [[nodiscard]] static bool isEnabled() { return sink != nullptr; }
+
+        /**
+         * @brief Gives a name to the id of the given type, e.g. to a counter.
+         */
+        static void name(Trace::EventType space, uint8_t id, const char *text);
+
+        static void zoneBegin(const uint8_t id) { event(Trace::EventType::ZONE_BEGIN, id, 0); }
+
+        static void zoneEnd(const uint8_t id) { event(Trace::EventType::ZONE_END, id, 0); }
+
+        static void counter(const uint8_t id, const uint16_t value) { event(Trace::EventType::COUNTER, id, value); }
+
+        static void wakeUp(const uint8_t id) { event(Trace::EventType::WAKEUP, id, 0); }
+
+        static void isrEnter(const uint8_t irq) { event(Trace::EventType::ISR_ENTER, irq, 0); }
+
+        static void isrExit(const uint8_t irq) { event(Trace::EventType::ISR_EXIT, irq, 0); }
+
+        static void event(Trace::EventType type, uint8_t id, uint16_t value);
+
+    private:
+        static uint8_t getActiveIrq();
+
+        static TraceSink *volatile sink;
+    };
+}
+
+#endif
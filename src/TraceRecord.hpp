@@ -0,0 +1,78 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef LIBSMART_STM32COMMON_TRACERECORD_HPP
+#define LIBSMART_STM32COMMON_TRACERECORD_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Stm32Common::Trace {
+    /**
+     * @brief Binary format of the trace event stream, shared by the firmware and the host decoder.
+     *
+     * This header depends on nothing but the standard library, so host tools can include it.
+     *
+     * Every record consists of two 32 bit words, sent little endian:
+     * - word 0: timestamp [cycles of the Timebase], wraps every 2^32 cycles
+     * - word 1: marker 0xA (bits 31..28), type (bits 27..24), id (bits 23..16), value (bits 15..0)
+     *
+     * SYNC carries the core frequency [Hz] instead of a timestamp and starts a stream. NAME gives a name to an id,
+     * the id space is the type in bits 15..8 of the value, the length of the name is in bits 7..0. It is followed
+     * by (length + 3) / 4 words with the characters of the name, not terminated.
+     *
+     * The marker lets the decoder find the record boundaries again when words are lost. The decoder has to see at
+     * least one record every 2^32 cycles to unwrap the timestamps.
+     */
+    enum class EventType : uint8_t {
+        SYNC = 0,
+        NAME = 1,
+        ZONE_BEGIN = 2,
+        ZONE_END = 3,
+        COUNTER = 4,
+        WAKEUP = 5,
+        ISR_ENTER = 6,
+        ISR_EXIT = 7
+    };
+
+    static constexpr uint8_t eventTypeCount = 8;
+    static constexpr uint32_t infoMarker = 0xa0000000;
+    static constexpr uint32_t infoMarkerMask = 0xf0000000;
+    static constexpr size_t recordWords = 2;
+    static constexpr size_t maxNameLength = 255;
+
+    struct Record {
+        uint32_t timestamp;
+        EventType type;
+        uint8_t id;
+        uint16_t value;
+    };
+
+    [[nodiscard]] constexpr uint32_t packInfo(const EventType type, const uint8_t id, const uint16_t value) {
+        return infoMarker | static_cast<uint32_t>(type) << 24 | static_cast<uint32_t>(id) << 16 | value;
+    }
+
+    [[nodiscard]] constexpr bool isValidInfo(const uint32_t info) {
+        return (info & infoMarkerMask) == infoMarker && (info >> 24 & 0x0f) < eventTypeCount;
+    }
+
+    [[nodiscard]] constexpr Record unpack(const uint32_t timestamp, const uint32_t info) {
+        return {
+            timestamp, static_cast<EventType>(info >> 24 & 0x0f), static_cast<uint8_t>(info >> 16),
+            static_cast<uint16_t>(info)
+        };
+    }
+
+    [[nodiscard]] constexpr uint16_t packNameValue(const EventType space, const size_t length) {
+        const size_t clipped = length > maxNameLength ? maxNameLength : length;
+        return static_cast<uint16_t>(static_cast<uint16_t>(space) << 8 | clipped);
+    }
+
+    [[nodiscard]] constexpr size_t getNameWords(const uint16_t nameValue) {
+        return ((nameValue & 0xff) + 3) / 4;
+    }
+}
+
+#endif
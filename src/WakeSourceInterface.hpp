@@ -0,0 +1,37 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef LIBSMART_STM32COMMON_WAKESOURCEINTERFACE_HPP
+#define LIBSMART_STM32COMMON_WAKESOURCEINTERFACE_HPP
+
+#include <libsmart_config.hpp>
+
+namespace Stm32Common {
+    class Idle;
+
+    /**
+     * @brief A source of work for the main loop that Idle asks before sleeping, e.g. a session manager.
+     *
+     * @see Idle::setSessionManager()
+     */
+    class WakeSourceInterface {
+    public:
+        virtual ~WakeSourceInterface() = default;
+
+        /**
+         * @brief Checks if there is work to do, so Idle must not sleep.
+         */
+        virtual bool hasWork() = 0;
+
+        /**
+         * @brief Sets the Idle object to wake up when work arrives. nullptr removes it.
+         *
+         * Idle::setSessionManager() calls this automatically.
+         */
+        virtual void setIdle(Idle *idle) = 0;
+    };
+}
+
+#endif
@@ -42,6 +42,71 @@
 
 
 
+/**
+ * Enable or disable the timing statistics of RunEvery objects.
+ * Costs 52 bytes of RAM per RunEvery object.
+ */
+#undef LIBSMART_ENABLE_RUNEVERY_STATISTICS
+// #define LIBSMART_ENABLE_RUNEVERY_STATISTICS
+
+
+
+/**
+ * Enable or disable the counters of StringBuffer objects: bytes in and out, high-water mark, rejected writes and
+ * bytes, and drains to empty. Costs 24 bytes of RAM per buffer.
+ * @see Stm32Common::BufferStatistics
+ */
+#undef LIBSMART_ENABLE_BUFFER_STATISTICS
+// #define LIBSMART_ENABLE_BUFFER_STATISTICS
+
+
+
+/**
+ * Enable or disable the counters of stream sessions and their manager: loop time, messages and response time per
+ * session, opened and rejected sessions. Costs 40 bytes of RAM per session and two cycle counter reads per loop()
+ * of a session.
+ * @see Stm32Common::StreamSession::SessionReport
+ */
+#undef LIBSMART_ENABLE_SESSION_STATISTICS
+// #define LIBSMART_ENABLE_SESSION_STATISTICS
+
+
+
+/**
+ * Enable or disable the PROFILE_ZONE() macro and the zones of the library (session loop, RunEvery dispatch,
+ * printf). Costs 32 bytes of RAM per zone and two cycle counter reads per pass through a zone.
+ * @see Stm32Common::Profiler
+ */
+#undef LIBSMART_ENABLE_PROFILER
+// #define LIBSMART_ENABLE_PROFILER
+
+
+
+/**
+ * Enable or disable the binary trace records of the library: profile zones, buffer levels and session wake-ups.
+ * Records are only written after Stm32Common::Tracer::begin(). LIBSMART_TRACE_ITM_PORT sets the stimulus port of
+ * the ItmTraceSink.
+ * @see Stm32Common::Tracer
+ */
+#undef LIBSMART_ENABLE_TRACE
+// #define LIBSMART_ENABLE_TRACE
+#undef LIBSMART_TRACE_ITM_PORT
+#define LIBSMART_TRACE_ITM_PORT 8
+
+
+
+/**
+ * Size [bytes] and number of the coroutine frames in the static FramePool (C++20 only).
+ * Costs LIBSMART_COROUTINE_FRAMES * LIBSMART_COROUTINE_FRAME_SIZE bytes of RAM if coroutines are used.
+ * @see Stm32Common::FramePool::getLargestFrameSize()
+ */
+#undef LIBSMART_COROUTINE_FRAME_SIZE
+#define LIBSMART_COROUTINE_FRAME_SIZE 128
+#undef LIBSMART_COROUTINE_FRAMES
+#define LIBSMART_COROUTINE_FRAMES 8
+
+
+
 /**
  * Enable or disable direct buffer read.
  * Enables functions that allow direct buffer reads to external
@@ -48,10 +48,12 @@
 #ifdef __cplusplus
 #include <cstdint>
 #include <climits>
+#include <cstring>
 #else
 #include <stdint.h>
 #include <limits.h>
 #include <stdbool.h>
+#include <string.h>
 #endif // __cplusplus
 
 #if PRINTF_ALIAS_STANDARD_FUNCTION_NAMES_HARD
@@ -133,6 +135,11 @@
 #define PRINTF_CHECK_FOR_NUL_IN_FORMAT_SPECIFIER 1
 #endif
 
+// Convert decimal integers two digits at a time, using a 200 byte lookup table
+#ifndef PRINTF_USE_DIGIT_PAIR_TABLE
+#define PRINTF_USE_DIGIT_PAIR_TABLE 1
+#endif
+
 #define PRINTF_PREFER_DECIMAL     false
 #define PRINTF_PREFER_EXPONENTIAL true
 
@@ -368,6 +375,29 @@ static inline void putchar_via_gadget(output_gadget_t* gadget, char c)
   }
 }
 
+// Write a run of characters which contains no '\0'. Equivalent to calling
+// putchar_via_gadget() for each character, but copies the run in one go
+// when writing to a buffer.
+static inline void putstr_via_gadget(output_gadget_t* gadget, const char* str, printf_size_t len)
+{
+  if (gadget->function != NULL) {
+    for (printf_size_t i = 0U; i < len; i++) {
+      putchar_via_gadget(gadget, str[i]);
+    }
+    return;
+  }
+  printf_size_t write_pos = gadget->pos;
+  gadget->pos += len;
+  if (write_pos >= gadget->max_chars) {
+    return;
+  }
+  printf_size_t copy_len = gadget->max_chars - write_pos;
+  if (copy_len > len) {
+    copy_len = len;
+  }
+  memcpy(gadget->buffer + write_pos, str, copy_len);
+}
+
 // Possibly-write the string-terminating '\0' character
 static inline void append_termination_with_gadget(output_gadget_t* gadget)
 {
@@ -572,6 +602,31 @@ static void print_integer(output_gadget_t* output, printf_unsigned_value_t value
     }
   }
   else {
+#if PRINTF_USE_DIGIT_PAIR_TABLE
+    if (base == BASE_DECIMAL) {
+      static const char digit_pairs[201] =
+        "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+        "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+        "8081828384858687888990919293949596979899";
+      // buf is filled in reverse order, so the low digit of each pair goes first
+      while (value >= 100U) {
+        const unsigned pair = (unsigned)(value % 100U) * 2U;
+        value /= 100U;
+        buf[len++] = digit_pairs[pair + 1U];
+        buf[len++] = digit_pairs[pair];
+      }
+      if (value >= 10U) {
+        const unsigned pair = (unsigned) value * 2U;
+        buf[len++] = digit_pairs[pair + 1U];
+        buf[len++] = digit_pairs[pair];
+      }
+      else {
+        buf[len++] = (char)('0' + value);
+      }
+      print_integer_finalization(output, buf, len, negative, base, precision, width, flags);
+      return;
+    }
+#endif
     do {
       const char digit = (char)(value % base);
       buf[len++] = (char)(digit < 10 ? '0' + digit : (flags & FLAGS_UPPERCASE ? 'A' : 'a') + digit - 10);
@@ -1045,6 +1100,9 @@ static void print_floating_point(output_gadget_t* output, floating_point_t value
     // implementation.
 #if PRINTF_SUPPORT_EXPONENTIAL_SPECIFIERS
     print_exponential_number(output, value, precision, width, flags, buf, len);
+#else
+    // Without exponential notation the value cannot be printed, say so like Print::printFloat() does
+    out_rev_(output, "fvo", 3, width, flags);
 #endif
     return;
   }
@@ -1099,9 +1157,13 @@ static inline void format_string_loop(output_gadget_t* output, const char* forma
   while (*format)
   {
     if (*format != '%') {
-      // A regular content character
-      putchar_via_gadget(output, *format);
-      format++;
+      // A run of regular content characters, written in one go. A format
+      // string without any '%' is copied completely by this fast path.
+      const char* run = format;
+      do {
+        format++;
+      } while (*format && *format != '%');
+      putstr_via_gadget(output, run, (printf_size_t)(format - run));
       continue;
     }
     // We're parsing a format specifier: %[flags][width][.precision][length]
@@ -2,12 +2,54 @@
 #ifndef PRINTF_CONFIG_H_
 #define PRINTF_CONFIG_H_
 
+/*
+ * Named printf profiles. Select one with a global definition, e.g. in CMakeLists_template.txt:
+ * add_compile_definitions(-DPRINTF_INCLUDE_CONFIG_H -DLIBSMART_PRINTF_PROFILE=LIBSMART_PRINTF_PROFILE_INTEGER)
+ *
+ * LIBSMART_PRINTF_PROFILE_INTEGER      %d %i %u %x %o %b %c %s %p, no floating point, no long long, no %n.
+ *                                      Smallest code, no soft-float routines are pulled in by printf.
+ * LIBSMART_PRINTF_PROFILE_FIXED_FLOAT  Like INTEGER, plus %f with single precision math internally.
+ *                                      Values beyond +/-1e9 print as "ovf", as there is no exponential notation.
+ * LIBSMART_PRINTF_PROFILE_FULL         Everything, including %e %g, long long, %n and MSVC %I specifiers.
+ *                                      This is the default.
+ *
+ * Passing a specifier that is not part of the selected profile is not supported, as its argument is not
+ * consumed. Print::print(double) does not use printf if the profile has no %f.
+ *
+ * The code size and the speed of the profiles are measured by tools/printf_profiles.
+ */
+#define LIBSMART_PRINTF_PROFILE_INTEGER     1
+#define LIBSMART_PRINTF_PROFILE_FIXED_FLOAT 2
+#define LIBSMART_PRINTF_PROFILE_FULL        3
+
+#ifndef LIBSMART_PRINTF_PROFILE
+#define LIBSMART_PRINTF_PROFILE LIBSMART_PRINTF_PROFILE_FULL
+#endif
+
+#if LIBSMART_PRINTF_PROFILE == LIBSMART_PRINTF_PROFILE_INTEGER
+#define PRINTF_SUPPORT_DECIMAL_SPECIFIERS       0
+#define PRINTF_SUPPORT_EXPONENTIAL_SPECIFIERS   0
+#define PRINTF_SUPPORT_WRITEBACK_SPECIFIER      0
+#define PRINTF_SUPPORT_LONG_LONG                0
+#define PRINTF_USE_DOUBLE_INTERNALLY            0
+#elif LIBSMART_PRINTF_PROFILE == LIBSMART_PRINTF_PROFILE_FIXED_FLOAT
+#define PRINTF_SUPPORT_DECIMAL_SPECIFIERS       1
+#define PRINTF_SUPPORT_EXPONENTIAL_SPECIFIERS   0
+#define PRINTF_SUPPORT_WRITEBACK_SPECIFIER      0
+#define PRINTF_SUPPORT_LONG_LONG                0
+#define PRINTF_USE_DOUBLE_INTERNALLY            0
+#elif LIBSMART_PRINTF_PROFILE == LIBSMART_PRINTF_PROFILE_FULL
 #define PRINTF_SUPPORT_DECIMAL_SPECIFIERS       1
 #define PRINTF_SUPPORT_EXPONENTIAL_SPECIFIERS   1
 #define PRINTF_SUPPORT_WRITEBACK_SPECIFIER      1
+// printf.c checks this one with #ifdef, so it is only defined for the full profile
 #define PRINTF_SUPPORT_MSVC_STYLE_INTEGER_SPECIFIERS 1
 #define PRINTF_SUPPORT_LONG_LONG                1
 #define PRINTF_USE_DOUBLE_INTERNALLY            1
+#else
+#error "Unknown LIBSMART_PRINTF_PROFILE"
+#endif
+
 #define PRINTF_ALIAS_STANDARD_FUNCTION_NAMES_SOFT    0
 #define PRINTF_ALIAS_STANDARD_FUNCTION_NAMES_HARD    1
 
@@ -18,5 +60,12 @@
 #define PRINTF_LOG10_TAYLOR_TERMS               4
 #define PRINTF_CHECK_FOR_NUL_IN_FORMAT_SPECIFIER 1
 
-#endif // PRINTF_CONFIG_H_
+/*
+ * Convert decimal integers two digits at a time with a 200 byte lookup table.
+ * Set to 0 to save the table at the cost of one division per digit.
+ */
+#ifndef PRINTF_USE_DIGIT_PAIR_TABLE
+#define PRINTF_USE_DIGIT_PAIR_TABLE             1
+#endif
 
+#endif // PRINTF_CONFIG_H_
@@ -0,0 +1,82 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "Check.hpp"
+#include "StringBuffer.hpp"
+#include "Serialize/CborWriter.hpp"
+
+using namespace Stm32Common;
+using namespace Stm32Common::Serialize;
+using namespace Stm32Common::Test;
+
+// The expected encodings are the examples of RFC 8949, appendix A, where there is one
+
+TEST_CASE(writesDefiniteMap) {
+    StringBuffer<64> buffer;
+    CborWriter cbor(buffer);
+    cbor.beginMap(2).key("a").value(1).key("b").value(true).end();
+    CHECK(cbor.isComplete());
+    CHECK_EQUAL(std::string("a26161016162f5"), hex(buffer));
+}
+
+TEST_CASE(writesIndefiniteArray) {
+    StringBuffer<64> buffer;
+    CborWriter cbor(buffer);
+    cbor.beginArray().value(1).value("a").value(-500).end();
+    CHECK(cbor.isComplete());
+    CHECK_EQUAL(std::string("9f0161613901f3ff"), hex(buffer));
+}
+
+TEST_CASE(writesIndefiniteMapWithFloats) {
+    StringBuffer<64> buffer;
+    CborWriter cbor(buffer);
+    cbor.beginMap().key("a").value(1.5f).key("b").value(100000.0f).end();
+    CHECK(cbor.isComplete());
+    CHECK_EQUAL(std::string("bf6161fa3fc000006162fa47c35000ff"), hex(buffer));
+}
+
+TEST_CASE(rejectsIndefiniteMapWithOddItemCount) {
+    StringBuffer<64> buffer;
+    CborWriter cbor(buffer);
+    cbor.beginMap().key("a").end();
+    CHECK(cbor.hasError());
+    CHECK(!cbor.isComplete());
+}
+
+TEST_CASE(writesTagAndDouble) {
+    StringBuffer<64> buffer;
+    CborWriter cbor(buffer);
+    cbor.beginArray(2).tag(1).value(1363896240UL).value(1.1).end();
+    CHECK(cbor.isComplete());
+    CHECK_EQUAL(std::string("82c11a514b67b0fb3ff199999999999a"), hex(buffer));
+}
+
+TEST_CASE(rejectsCountsOfIndefiniteStates) {
+    StringBuffer<64> buffer;
+    for (const size_t items: {size_t{UINT32_MAX}, size_t{UINT32_MAX - 1}, size_t{UINT32_MAX - 2}}) {
+        CborWriter cbor(buffer);
+        cbor.beginArray(items);
+        CHECK(cbor.hasError());
+        CHECK_EQUAL(0U, cbor.getBytesWritten());
+    }
+
+    CborWriter cbor(buffer);
+    cbor.beginArray(CborWriter::MaxItems);
+    CHECK(!cbor.hasError());
+    CHECK_EQUAL(std::string("9afffffffc"), hex(buffer));
+}
+
+TEST_CASE(rejectsMapPairsThatOverflowItemCount) {
+    StringBuffer<64> buffer;
+    CborWriter cbor(buffer);
+    cbor.beginMap(size_t{1} << 31);
+    CHECK(cbor.hasError());
+    CHECK_EQUAL(0U, cbor.getBytesWritten());
+
+    CborWriter largest(buffer);
+    largest.beginMap(CborWriter::MaxItems / 2);
+    CHECK(!largest.hasError());
+    CHECK_EQUAL(std::string("ba7ffffffe"), hex(buffer));
+}
@@ -0,0 +1,68 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "Check.hpp"
+#include <iostream>
+#include <vector>
+#include "Helper.hpp"
+#include "HostHal.hpp"
+
+using namespace Stm32Common::Test;
+
+namespace {
+    struct TestCase {
+        const char *name;
+        test_fn_t fn;
+    };
+
+    std::vector<TestCase> &getTestCases() {
+        static std::vector<TestCase> testCases;
+        return testCases;
+    }
+
+    const char *currentTest = "";
+    size_t failures = 0;
+}
+
+Registration::Registration(const char *name, const test_fn_t fn) {
+    getTestCases().push_back({name, fn});
+}
+
+void Stm32Common::Test::fail(const char *file, const int line, const std::string &message) {
+    std::cerr << file << ':' << line << ": " << currentTest << ": " << message << '\n';
+    failures++;
+}
+
+std::string Stm32Common::Test::hex(const uint8_t *data, const size_t size) {
+    static const char digits[] = "0123456789abcdef";
+    std::string text;
+    for (size_t i = 0; i < size; i++) {
+        text += digits[data[i] >> 4];
+        text += digits[data[i] & 0x0f];
+    }
+    return text;
+}
+
+void Stm32Common::Test::setMillis(const uint32_t millis) {
+    Host::HostHal::setVirtualTime(true);
+    // Start at a whole millisecond, so the following steps are exact
+    Host::HostHal::advanceTime(1000 - Host::HostHal::getTime() % 1000);
+    advanceMillis(millis - static_cast<uint32_t>(::millis()));
+}
+
+void Stm32Common::Test::advanceMillis(const uint32_t duration_ms) {
+    Host::HostHal::advanceTime(static_cast<uint64_t>(duration_ms) * 1000);
+}
+
+int main() {
+    for (const TestCase &testCase: getTestCases()) {
+        currentTest = testCase.name;
+        const size_t failuresBefore = failures;
+        testCase.fn();
+        std::cout << (failures == failuresBefore ? "ok   " : "FAIL ") << testCase.name << '\n';
+    }
+    std::cout << getTestCases().size() << " tests, " << failures << " failed checks\n";
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,97 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef LIBSMART_STM32COMMON_TESTS_CHECK_HPP
+#define LIBSMART_STM32COMMON_TESTS_CHECK_HPP
+
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include "StringBufferInterface.hpp"
+
+/**
+ * Minimal test framework of the host tests. Every test executable consists of TEST_CASE() functions, which are run
+ * in the order of their definition by the main() of Check.cpp.
+ *
+ * @code
+ * TEST_CASE(emptyBufferHasNoLength) {
+ *     Stm32Common::StringBuffer<8> buffer;
+ *     CHECK_EQUAL(0U, buffer.getLength());
+ * }
+ * @endcode
+ */
+namespace Stm32Common::Test {
+    using test_fn_t = void (*)();
+
+    /**
+     * @brief Adds a test case to the list of the executable. Used by TEST_CASE().
+     */
+    class Registration {
+    public:
+        Registration(const char *name, test_fn_t fn);
+    };
+
+    /**
+     * @brief Reports a failed check. The test case continues, the executable fails at the end.
+     */
+    void fail(const char *file, int line, const std::string &message);
+
+    template<typename T>
+    std::string toString(const T &value) {
+        std::ostringstream out;
+        if constexpr (std::is_same_v<T, uint8_t> || std::is_same_v<T, int8_t>) {
+            out << static_cast<int>(value);
+        } else {
+            out << value;
+        }
+        return out.str();
+    }
+
+    template<typename Expected, typename Actual>
+    void checkEqual(const Expected &expected, const Actual &actual, const char *expression, const char *file,
+                    const int line) {
+        if (expected == actual) return;
+        fail(file, line, std::string(expression) + ": expected " + toString(expected) + ", got " + toString(actual));
+    }
+
+    /**
+     * @brief Returns the unread content of a buffer, without reading it.
+     */
+    inline std::string contents(StringBufferInterface &buffer) {
+        return {reinterpret_cast<const char *>(buffer.getReadPointer()), buffer.getLength()};
+    }
+
+    /**
+     * @brief Returns bytes as lower case hex digits, e.g. "a1ff".
+     */
+    std::string hex(const uint8_t *data, size_t size);
+
+    inline std::string hex(StringBufferInterface &buffer) { return hex(buffer.getReadPointer(), buffer.getLength()); }
+
+    /**
+     * @brief Switches the HostHal to virtual time and advances it until millis() returns the given value. The time
+     * only moves forward, so a value below the current one is reached after the wrap-around.
+     */
+    void setMillis(uint32_t millis);
+
+    /**
+     * @brief Advances the virtual time [ms].
+     */
+    void advanceMillis(uint32_t duration_ms);
+}
+
+#define TEST_CASE(name) \
+    static void name(); \
+    static const Stm32Common::Test::Registration name##Registration(#name, name); \
+    static void name()
+
+#define CHECK(condition) \
+    do { if (!(condition)) Stm32Common::Test::fail(__FILE__, __LINE__, #condition); } while (false)
+
+#define CHECK_EQUAL(expected, actual) \
+    Stm32Common::Test::checkEqual((expected), (actual), #actual, __FILE__, __LINE__)
+
+#endif
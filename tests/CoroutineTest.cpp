@@ -0,0 +1,154 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "Check.hpp"
+#include "Idle.hpp"
+#include "Scheduler.hpp"
+#include "SleepBackend.hpp"
+#include "StreamSession/CoroutineStreamSession.hpp"
+#include "StreamSession/Manager.hpp"
+#include "StreamSession/StreamSessionAware.hpp"
+
+using namespace Stm32Common;
+using namespace Stm32Common::StreamSession;
+using namespace Stm32Common::Test;
+
+namespace {
+    class Owner : public StreamSessionAware {
+    public:
+        Owner() : StreamSessionAware(nullptr) { ; }
+
+        void dataReadyTx(StreamSessionInterface *session) override { ; }
+    };
+
+    /**
+     * Answers every line with its length, after a header of four bytes has been received.
+     */
+    class LineSession : public CoroutineStreamSession<64, 64> {
+    public:
+        size_t lines = 0;
+
+    protected:
+        Task run() override {
+            co_await rxAvailable(4);
+            getRxBuffer()->remove(4);
+            for (;;) {
+                const size_t length = co_await rxDelimiter('\n');
+                getRxBuffer()->remove(length);
+                lines++;
+                print(length);
+            }
+        }
+    };
+
+    /**
+     * Sleeps for 100 ms, then counts a wake-up, forever.
+     */
+    class SleepingSession : public CoroutineStreamSession<16, 16> {
+    public:
+        size_t wakeUps = 0;
+        uint32_t lastWakeUp = 0;
+
+    protected:
+        Task run() override {
+            for (;;) {
+                co_await sleep(100);
+                wakeUps++;
+                lastWakeUp = ::millis();
+            }
+        }
+    };
+}
+
+TEST_CASE(coroutineResumesOnReceivedData) {
+    Manager<LineSession, 2> manager;
+    Owner owner;
+    auto *session = static_cast<LineSession *>(manager.getNewSession(&owner, 1));
+    manager.loop();
+    CHECK(session->isRunning());
+
+    session->getRxBuffer()->write("HDR:ab");
+    manager.loop();
+    CHECK_EQUAL(0U, session->lines);
+
+    session->getRxBuffer()->write("c\nxy\n");
+    for (int i = 0; i < 5; i++) manager.loop();
+    CHECK_EQUAL(2U, session->lines);
+    CHECK_EQUAL(std::string("43"), contents(*session->getTxBuffer()));
+}
+
+TEST_CASE(endedSessionReturnsFrame) {
+    const size_t freeFrames = FramePool::getFreeFrames();
+    {
+        Manager<LineSession, 2> manager;
+        Owner owner;
+        auto *session = manager.getNewSession(&owner, 1);
+        manager.loop();
+        CHECK_EQUAL(freeFrames - 1, FramePool::getFreeFrames());
+        manager.removeSession(session);
+        CHECK_EQUAL(freeFrames, FramePool::getFreeFrames());
+    }
+    CHECK_EQUAL(freeFrames, FramePool::getFreeFrames());
+}
+
+TEST_CASE(sleepWithoutSchedulerPolls) {
+    setMillis(1000);
+    CoroutineStreamSessionBase::setScheduler(nullptr);
+    Manager<SleepingSession, 2> manager;
+    Owner owner;
+    auto *session = static_cast<SleepingSession *>(manager.getNewSession(&owner, 1));
+    manager.loop();
+    CHECK(manager.hasReadySessions());
+
+    advanceMillis(100);
+    manager.loop();
+    CHECK_EQUAL(1U, session->wakeUps);
+    CHECK(manager.hasReadySessions());
+    manager.removeSession(session);
+}
+
+TEST_CASE(sleepRegistersWakeUpTimer) {
+    setMillis(1000);
+    Scheduler<4> scheduler;
+    CoroutineStreamSessionBase::setScheduler(&scheduler);
+    Manager<SleepingSession, 2> manager;
+    VirtualSleepBackend backend;
+    Idle idle(backend);
+    idle.setMaxSleepTime(1000);
+    idle.setScheduler(&scheduler);
+    idle.setSessionManager(&manager);
+    Owner owner;
+    auto *session = static_cast<SleepingSession *>(manager.getNewSession(&owner, 1));
+    manager.loop();
+    // The new session has requested a wake-up
+    CHECK(!idle.loop());
+
+    // The session is not polled while it sleeps, Idle sleeps until the timer is due
+    CHECK(!manager.hasReadySessions());
+    CHECK_EQUAL(1U, scheduler.getTaskCount());
+    CHECK_EQUAL(100U, idle.getSleepTime());
+    CHECK(idle.loop());
+    CHECK_EQUAL(1100UL, ::millis());
+
+    scheduler.loop();
+    CHECK(manager.hasReadySessions());
+    manager.loop();
+    CHECK_EQUAL(1U, session->wakeUps);
+    CHECK_EQUAL(1100U, session->lastWakeUp);
+
+    // The next sleep has registered a new timer
+    CHECK(!manager.hasReadySessions());
+    CHECK_EQUAL(1U, scheduler.getTaskCount());
+    CHECK(!idle.loop());
+    CHECK(idle.loop());
+    scheduler.loop();
+    manager.loop();
+    CHECK_EQUAL(2U, session->wakeUps);
+    CHECK_EQUAL(1200U, session->lastWakeUp);
+
+    manager.removeSession(session);
+    CHECK_EQUAL(0U, scheduler.getTaskCount());
+    CoroutineStreamSessionBase::setScheduler(nullptr);
+}
@@ -0,0 +1,62 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "Check.hpp"
+#include "CpuLoad.hpp"
+
+using namespace Stm32Common;
+using namespace Stm32Common::Test;
+
+// On the host, a Timebase cycle is one nanosecond, so a window of 1 ms has 1000000 cycles
+
+TEST_CASE(measuresBusyShareOfWindow) {
+    Timebase::begin();
+    CpuLoad load(1);
+    load.begin(0);
+    load.idleBegin(100000);
+    load.idleEnd(850000);
+    CHECK(!load.loop(999999));
+    CHECK(load.loop(1000000));
+    CHECK_EQUAL(250U, load.getLoad_permille());
+    CHECK_EQUAL(1U, load.getWindowCount());
+}
+
+TEST_CASE(splitsRunningIdleBetweenWindows) {
+    Timebase::begin();
+    CpuLoad load(1);
+    load.begin(0);
+    load.idleBegin(500000);
+    CHECK(load.loop(1000000));
+    CHECK_EQUAL(500U, load.getLoad_permille());
+
+    // Still idle for the first quarter of the next window
+    load.idleEnd(1250000);
+    CHECK(load.loop(2000000));
+    CHECK_EQUAL(750U, load.getLoad_permille());
+    CHECK_EQUAL(750U, load.getPeakLoad_permille());
+    CHECK_EQUAL(625U, load.getAverageLoad_permille());
+}
+
+TEST_CASE(survivesCycleCounterWrapAround) {
+    Timebase::begin();
+    CpuLoad load(1);
+    const uint32_t start = UINT32_MAX - 400000;
+    load.begin(start);
+    load.idleBegin(start + 200000);
+    load.idleEnd(start + 300000);
+    CHECK(load.loop(start + 1000000));
+    CHECK_EQUAL(900U, load.getLoad_permille());
+}
+
+TEST_CASE(fullyBusyWithoutIdle) {
+    Timebase::begin();
+    CpuLoad load(1);
+    load.begin(0);
+    CHECK(load.loop(1000000));
+    CHECK_EQUAL(1000U, load.getLoad_permille());
+    load.clear();
+    CHECK_EQUAL(0U, load.getWindowCount());
+    CHECK_EQUAL(0U, load.getAverageLoad_permille());
+}
@@ -0,0 +1,148 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+#include "Check.hpp"
+#include "DeferredCallQueue.hpp"
+#include "HostHal.hpp"
+#include "StringBuffer.hpp"
+
+using namespace Stm32Common;
+using namespace Stm32Common::Test;
+
+namespace {
+    std::vector<int> calls;
+
+    void record(void *context) { calls.push_back(*static_cast<int *>(context)); }
+
+    DeferredCallQueue<2> repostQueue;
+    int remaining = 0;
+
+    void repost(void *) {
+        if (--remaining > 0) repostQueue.post(repost);
+    }
+
+    constexpr uint32_t StressProducers = 4;
+    constexpr uint32_t StressCalls = 100000;
+
+    // The calls received from each producer, in the order they have been drained
+    std::vector<uint32_t> received[StressProducers];
+
+    // The context encodes the producer in the upper byte and its sequence number in the lower bits
+    void receive(void *context) {
+        const auto value = reinterpret_cast<uintptr_t>(context);
+        received[value >> 24].push_back(static_cast<uint32_t>(value & 0xffffff));
+    }
+
+    /**
+     * Simulates an ISR for the lifetime of the object, so isInIsr() returns true.
+     */
+    class IsrScope {
+    public:
+        IsrScope() { Host::HostHal::setActiveIrq(16 + 37); }
+
+        ~IsrScope() { Host::HostHal::setActiveIrq(0); }
+    };
+}
+
+TEST_CASE(drainsInPostOrder) {
+    calls.clear();
+    DeferredCallQueue<4> queue;
+    int values[] = {1, 2, 3};
+    for (int &value: values) CHECK(queue.post(record, &value));
+    CHECK_EQUAL(3U, queue.getLength());
+
+    CHECK_EQUAL(2U, queue.drain(2));
+    CHECK_EQUAL(1U, queue.drain());
+    CHECK(queue.isEmpty());
+    CHECK(calls == std::vector<int>({1, 2, 3}));
+}
+
+TEST_CASE(fullQueueDropsAndCounts) {
+    calls.clear();
+    DeferredCallQueue<2> queue;
+    int value = 7;
+    CHECK(queue.post(record, &value));
+    CHECK(queue.post(record, &value));
+    CHECK(!queue.post(record, &value));
+    CHECK_EQUAL(1U, queue.getDropCount());
+    CHECK_EQUAL(2U, queue.getHighWater());
+
+    // Slots are reused after the wrap-around of the positions
+    for (int round = 0; round < 10; round++) {
+        CHECK_EQUAL(2U, queue.drain());
+        CHECK(queue.post(record, &value));
+        CHECK(queue.post(record, &value));
+    }
+    CHECK_EQUAL(1U, queue.getDropCount());
+}
+
+TEST_CASE(callMayPostAgain) {
+    remaining = 5;
+    CHECK(repostQueue.post(repost));
+
+    // The slot is released before the call, so even a queue of two slots runs all five
+    CHECK_EQUAL(5U, repostQueue.drain());
+    CHECK_EQUAL(0, remaining);
+    CHECK(repostQueue.isEmpty());
+}
+
+TEST_CASE(bufferHooksFromIsrAreDeferredAndMerged) {
+    DeferredCallQueue<4> queue;
+    StringBuffer<32> buffer;
+    buffer.setDeferredCallQueue(&queue);
+    int writes = 0;
+    buffer.setOnWriteFn([&writes]() { writes++; });
+
+    {
+        IsrScope isr;
+        buffer.print("a");
+        buffer.print("b");
+    }
+    CHECK_EQUAL(0, writes);
+    CHECK_EQUAL(1U, queue.getLength());
+
+    CHECK_EQUAL(1U, queue.drain());
+    CHECK_EQUAL(1, writes);
+
+    // Outside of an ISR, the hooks are called directly
+    buffer.print("c");
+    CHECK_EQUAL(2, writes);
+    CHECK(queue.isEmpty());
+}
+
+TEST_CASE(concurrentProducersLoseAndDuplicateNothing) {
+    for (std::vector<uint32_t> &calls: received) calls.clear();
+    DeferredCallQueue<64> queue;
+    std::atomic<uint32_t> running{StressProducers};
+
+    std::vector<std::thread> producers;
+    for (uintptr_t producer = 0; producer < StressProducers; producer++) {
+        producers.emplace_back([&queue, &running, producer]() {
+            for (uintptr_t seq = 0; seq < StressCalls; seq++) {
+                // A full queue is retried, like an ISR that keeps its event pending
+                while (!queue.post(receive, reinterpret_cast<void *>(producer << 24 | seq))) std::this_thread::yield();
+            }
+            running--;
+        });
+    }
+
+    // The test thread is the single consumer
+    while (running > 0 || !queue.isEmpty()) {
+        if (queue.drain() == 0) std::this_thread::yield();
+    }
+    for (std::thread &producer: producers) producer.join();
+
+    for (const std::vector<uint32_t> &calls: received) {
+        CHECK_EQUAL(static_cast<size_t>(StressCalls), calls.size());
+        bool inOrder = true;
+        for (size_t i = 0; i < calls.size(); i++) inOrder = inOrder && calls[i] == i;
+        CHECK(inOrder);
+    }
+    CHECK(queue.getHighWater() <= queue.getCapacity());
+}
@@ -0,0 +1,72 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "Check.hpp"
+#include "Hexdump.hpp"
+#include "StringBuffer.hpp"
+
+using namespace Stm32Common;
+using namespace Stm32Common::Test;
+
+namespace {
+    const char data[] = "Hello, World! 012345";
+
+    const std::string expected =
+            "00000000  48 65 6c 6c 6f 2c 20 57  6f 72 6c 64 21 20 30 31  |Hello, World! 01|\r\n"
+            "00000010  32 33 34 35                                       |2345|\r\n";
+
+    /**
+     * Dumps into a buffer of the given size, which is drained after every call of dump().
+     */
+    template<size_t Size>
+    std::string dumpInPieces(Hexdump &hexdump, size_t &calls) {
+        StringBuffer<Size> buffer;
+        std::string text;
+        calls = 0;
+        while (!hexdump.isDone() && calls < 1000) {
+            const size_t written = hexdump.dump(buffer);
+            CHECK(written > 0);
+            CHECK_EQUAL(written, buffer.getLength());
+            text += contents(buffer);
+            buffer.clear();
+            calls++;
+        }
+        return text;
+    }
+}
+
+TEST_CASE(printToWritesAllLines) {
+    StringBuffer<256> buffer;
+    buffer.print(Hexdump(data, 20));
+    CHECK_EQUAL(expected, contents(buffer));
+}
+
+TEST_CASE(dumpResumesOnSinkSmallerThanLine) {
+    Hexdump hexdump(data, 20);
+    size_t calls;
+    CHECK_EQUAL(expected, dumpInPieces<7>(hexdump, calls));
+    CHECK_EQUAL((expected.size() + 6) / 7, calls);
+}
+
+TEST_CASE(dumpWritesWholeLinesWhileTheyFit) {
+    Hexdump hexdump(data, 20);
+    StringBuffer<100> buffer;
+    CHECK_EQUAL(hexdump.getLineLength(), hexdump.dump(buffer));
+    CHECK_EQUAL(16U, hexdump.getPosition());
+    buffer.clear();
+
+    size_t calls;
+    CHECK_EQUAL(expected.substr(hexdump.getLineLength()), dumpInPieces<100>(hexdump, calls));
+    CHECK_EQUAL(1U, calls);
+}
+
+TEST_CASE(rewindStartsOver) {
+    Hexdump hexdump(data, 20);
+    size_t calls;
+    (void) dumpInPieces<50>(hexdump, calls);
+    CHECK(hexdump.isDone());
+    hexdump.rewind();
+    CHECK_EQUAL(expected, dumpInPieces<200>(hexdump, calls));
+}
@@ -0,0 +1,84 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "Check.hpp"
+#include "Idle.hpp"
+#include "Scheduler.hpp"
+#include "SleepBackend.hpp"
+
+using namespace Stm32Common;
+using namespace Stm32Common::Test;
+
+namespace {
+    class CountingTask : public RunEvery {
+    public:
+        explicit CountingTask(const uint32_t interval_ms) : RunEvery(interval_ms) { ; }
+
+        uint32_t runs = 0;
+        uint32_t lastRun = 0;
+
+    protected:
+        void run() override {
+            runs++;
+            lastRun = ::millis();
+        }
+    };
+}
+
+TEST_CASE(sleepingRunsTasksOnTime) {
+    setMillis(1000);
+    Scheduler<4> scheduler;
+    CountingTask task(10);
+    scheduler.add(task);
+    VirtualSleepBackend backend;
+    Idle idle(backend);
+    idle.setScheduler(&scheduler);
+
+    for (int i = 0; i < 20; i++) {
+        scheduler.loop();
+        CHECK(idle.loop());
+    }
+    // The first pass sleeps until the first run is due
+    CHECK_EQUAL(19U, task.runs);
+    CHECK_EQUAL(1190U, task.lastRun);
+    CHECK_EQUAL(1200UL, ::millis());
+    CHECK_EQUAL(20U, backend.getSleepCount());
+    CHECK_EQUAL(uint64_t{200}, idle.getSleptTime());
+}
+
+TEST_CASE(maxSleepTimeLimitsSleep) {
+    setMillis(1000);
+    Scheduler<4> scheduler;
+    CountingTask task(25);
+    scheduler.add(task);
+    VirtualSleepBackend backend;
+    Idle idle(backend);
+    idle.setScheduler(&scheduler);
+    idle.setMaxSleepTime(10);
+
+    CHECK(idle.loop());
+    CHECK(idle.loop());
+    CHECK_EQUAL(1020UL, ::millis());
+    CHECK_EQUAL(5U, idle.getSleepTime());
+    CHECK(idle.loop());
+    scheduler.loop();
+    CHECK_EQUAL(1U, task.runs);
+}
+
+TEST_CASE(wakeUpSkipsNextSleep) {
+    setMillis(1000);
+    VirtualSleepBackend backend;
+    Idle idle(backend);
+    idle.setMaxSleepTime(50);
+
+    idle.wakeUp();
+    CHECK_EQUAL(0U, idle.getSleepTime());
+    CHECK(!idle.loop());
+    CHECK_EQUAL(1000UL, ::millis());
+
+    CHECK(idle.loop());
+    CHECK_EQUAL(1050UL, ::millis());
+    CHECK_EQUAL(1U, idle.getSleepCount());
+}
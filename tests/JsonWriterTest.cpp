@@ -0,0 +1,49 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <cmath>
+#include "Check.hpp"
+#include "StringBuffer.hpp"
+#include "Serialize/JsonWriter.hpp"
+
+using namespace Stm32Common;
+using namespace Stm32Common::Serialize;
+using namespace Stm32Common::Test;
+
+TEST_CASE(writesNestedDocument) {
+    StringBuffer<128> buffer;
+    JsonWriter json(buffer);
+    json.beginObject()
+            .member("id", 7U)
+            .member("offset", -5)
+            .member("name", "a\"b\n")
+            .key("flags").beginArray().value(true).nullValue().endArray()
+            .endObject();
+    CHECK(json.isComplete());
+    CHECK_EQUAL(std::string(R"({"id":7,"offset":-5,"name":"a\"b\n","flags":[true,null]})"), contents(buffer));
+    CHECK_EQUAL(buffer.getLength(), json.getBytesWritten());
+}
+
+TEST_CASE(writesDoublesAsValidNumbers) {
+    StringBuffer<128> buffer;
+    JsonWriter json(buffer);
+    json.beginArray()
+            .value(3.14159, 3)
+            .value(-0.5)
+            .value(1.5e12)
+            .value(NAN)
+            .value(INFINITY)
+            .endArray();
+    CHECK(json.isComplete());
+    CHECK_EQUAL(std::string("[3.142,-0.50,1.50e12,null,null]"), contents(buffer));
+}
+
+TEST_CASE(rejectsValueWithoutKeyInObject) {
+    StringBuffer<128> buffer;
+    JsonWriter json(buffer);
+    json.beginObject().value(1);
+    CHECK(json.hasError());
+    CHECK(!json.isComplete());
+}
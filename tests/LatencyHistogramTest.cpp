@@ -0,0 +1,70 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "Check.hpp"
+#include "LatencyHistogram.hpp"
+
+using namespace Stm32Common;
+using namespace Stm32Common::Test;
+
+TEST_CASE(emptyHistogramReportsZero) {
+    LatencyHistogram<> histogram;
+    CHECK_EQUAL(0U, histogram.getCount());
+    CHECK_EQUAL(0U, histogram.getMin());
+    CHECK_EQUAL(0U, histogram.getPercentile(50));
+    CHECK_EQUAL(0U, histogram.getMean());
+}
+
+TEST_CASE(smallValuesAreExact) {
+    LatencyHistogram<> histogram;
+    for (uint32_t value = 1; value <= 7; value++) histogram.record(value);
+    CHECK_EQUAL(1U, histogram.getMin());
+    CHECK_EQUAL(4U, histogram.getPercentile(50));
+    CHECK_EQUAL(7U, histogram.getPercentile(100));
+    CHECK_EQUAL(4U, histogram.getMean());
+}
+
+TEST_CASE(percentilesAreWithinBucketPrecision) {
+    LatencyHistogram<> histogram;
+    for (uint32_t value = 1; value <= 1000; value++) histogram.record(value * 100);
+
+    // Three sub-bucket bits: the upper bound of a bucket is at most 1/8 above its values
+    const uint32_t percentiles[] = {50, 90, 99};
+    for (const uint32_t percentile: percentiles) {
+        const uint32_t exact = percentile * 1000;
+        const uint32_t reported = histogram.getPercentile(percentile);
+        CHECK(reported >= exact);
+        CHECK(reported <= exact + exact / 8);
+    }
+    CHECK_EQUAL(100000U, histogram.getPercentile(100));
+    CHECK_EQUAL(100000U, histogram.getMax());
+    CHECK_EQUAL(50050U, histogram.getMean());
+}
+
+TEST_CASE(percentileIsCappedByMax) {
+    LatencyHistogram<> histogram;
+    histogram.record(1000);
+    histogram.record(1001);
+    CHECK_EQUAL(1001U, histogram.getPercentile(99));
+}
+
+TEST_CASE(outOfRangeValuesCountForMax) {
+    LatencyHistogram<3, 16> histogram;
+    histogram.record(10);
+    histogram.record(1UL << 20);
+    CHECK_EQUAL(2U, histogram.getCount());
+    CHECK_EQUAL(static_cast<uint32_t>(1UL << 20), histogram.getMax());
+    CHECK_EQUAL(static_cast<uint32_t>(1UL << 20), histogram.getPercentile(100));
+}
+
+TEST_CASE(clearResets) {
+    LatencyHistogram<> histogram;
+    histogram.record(5);
+    histogram.clear();
+    CHECK_EQUAL(0U, histogram.getCount());
+    CHECK_EQUAL(0U, histogram.getMax());
+    histogram.record(3);
+    CHECK_EQUAL(3U, histogram.getMin());
+}
@@ -0,0 +1,222 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "Check.hpp"
+#include "HostHal.hpp"
+#include "Idle.hpp"
+#include "SleepBackend.hpp"
+#include "StreamSession/StreamSessionAware.hpp"
+#include "StreamSession/EchoStreamSession.hpp"
+#include "StreamSession/Manager.hpp"
+
+using namespace Stm32Common;
+using namespace Stm32Common::StreamSession;
+using namespace Stm32Common::Test;
+
+namespace {
+    /**
+     * Sends at most a given number of bytes per dataReadyTx(), like an owner with a small hardware FIFO.
+     */
+    class Owner : public StreamSessionAware {
+    public:
+        explicit Owner(const size_t chunk) : StreamSessionAware(nullptr), chunk(chunk) { ; }
+
+        void dataReadyTx(StreamSessionInterface *session) override {
+            calls++;
+            auto *echo = static_cast<EchoStreamSession *>(session);
+            for (size_t i = 0; i < chunk && echo->getTxBuffer()->available() > 0; i++) {
+                sent += static_cast<char>(echo->getTxBuffer()->read());
+            }
+        }
+
+        size_t chunk;
+        size_t calls = 0;
+        std::string sent;
+    };
+
+    /**
+     * Counts the calls of loop().
+     */
+    class CountingSession : public EchoStreamSession {
+    public:
+        void loop() override {
+            loops++;
+            EchoStreamSession::loop();
+        }
+
+        size_t loops = 0;
+    };
+
+    /**
+     * Spends loopCost_us of the virtual time in every loop() with received data, then echoes it.
+     */
+    class SlowEchoSession : public EchoStreamSession {
+    public:
+        void loop() override {
+            if (available() > 0) Host::HostHal::advanceTime(loopCost_us);
+            EchoStreamSession::loop();
+        }
+
+        uint32_t loopCost_us = 0;
+
+    protected:
+        // Echoes only from loop(), so every byte is echoed within the measured loop
+        void onWriteTx() override { StreamSessionInterface::onWriteTx(); }
+    };
+}
+
+TEST_CASE(idleSessionsAreNotLooped) {
+    Manager<CountingSession, 3> manager;
+    Owner owner(64);
+    auto *session = static_cast<CountingSession *>(manager.getNewSession(&owner, 1));
+    CHECK(session != nullptr);
+
+    // A new session is looped once, for its setup
+    manager.loop();
+    CHECK_EQUAL(1U, session->loops);
+    CHECK(!manager.hasReadySessions());
+
+    for (int i = 0; i < 5; i++) manager.loop();
+    CHECK_EQUAL(1U, session->loops);
+}
+
+TEST_CASE(receivedDataWakesSession) {
+    Manager<EchoStreamSession, 3> manager;
+    Owner owner(64);
+    auto *session = static_cast<EchoStreamSession *>(manager.getNewSession(&owner, 1));
+    manager.loop();
+
+    session->getRxBuffer()->write("ping");
+    CHECK(manager.hasReadySessions());
+    manager.loop();
+    CHECK_EQUAL(std::string("ping"), owner.sent);
+
+    // Reading the transmit buffer wakes the session once more, then it is idle
+    manager.loop();
+    CHECK(!manager.hasReadySessions());
+}
+
+TEST_CASE(unsentDataKeepsSessionReady) {
+    Manager<EchoStreamSession, 3> manager;
+    Owner owner(1);
+    auto *session = static_cast<EchoStreamSession *>(manager.getNewSession(&owner, 1));
+    manager.loop();
+
+    session->getRxBuffer()->write("abc");
+    for (int i = 0; i < 10 && manager.hasReadySessions(); i++) manager.loop();
+    CHECK_EQUAL(std::string("abc"), owner.sent);
+    CHECK(!manager.hasReadySessions());
+}
+
+TEST_CASE(blockedOwnerDoesNotKeepSessionReady) {
+    Manager<CountingSession, 3> manager;
+    Owner owner(0);
+    auto *session = static_cast<CountingSession *>(manager.getNewSession(&owner, 1));
+    manager.loop();
+
+    // Writing the echo wakes the session again, then it waits for the owner to read
+    session->getRxBuffer()->write("abc");
+    for (int i = 0; i < 3; i++) manager.loop();
+    CHECK(!manager.hasReadySessions());
+    const size_t loops = session->loops;
+    for (int i = 0; i < 10; i++) manager.loop();
+    CHECK_EQUAL(loops, session->loops);
+
+    owner.chunk = 64;
+    owner.dataReadyTx(session);
+    CHECK_EQUAL(std::string("abc"), owner.sent);
+    CHECK(manager.hasReadySessions());
+}
+
+TEST_CASE(wakeUpIgnoresForeignSessions) {
+    Manager<EchoStreamSession, 3> manager;
+    EchoStreamSession foreign;
+    manager.wakeUp(&foreign);
+    manager.wakeUp(nullptr);
+    CHECK(!manager.hasReadySessions());
+}
+
+TEST_CASE(readySessionKeepsIdleAwake) {
+    Manager<EchoStreamSession, 3> manager;
+    VirtualSleepBackend backend;
+    Idle idle(backend);
+    idle.setMaxSleepTime(50);
+    idle.setSessionManager(&manager);
+    Owner owner(64);
+    auto *session = static_cast<EchoStreamSession *>(manager.getNewSession(&owner, 1));
+    manager.loop();
+    // The new session has requested a wake-up
+    CHECK(!idle.loop());
+    CHECK_EQUAL(50U, idle.getSleepTime());
+
+    session->wakeUp();
+    CHECK_EQUAL(0U, idle.getSleepTime());
+    CHECK(!idle.loop());
+    manager.loop();
+    CHECK_EQUAL(50U, idle.getSleepTime());
+}
+
+#ifdef LIBSMART_ENABLE_SESSION_STATISTICS
+TEST_CASE(statisticsAreKeptPerSession) {
+    setMillis(1000);
+    Manager<SlowEchoSession, 3> manager;
+    Owner owner(64);
+    auto *a = static_cast<SlowEchoSession *>(manager.getNewSession(&owner, 1));
+    auto *b = static_cast<SlowEchoSession *>(manager.getNewSession(&owner, 2));
+    auto *c = static_cast<SlowEchoSession *>(manager.getNewSession(&owner, 3));
+    a->loopCost_us = 10;
+    b->loopCost_us = 20;
+    manager.loop();
+
+    // The responses are measured from the arrival of the data to the first write of the echo. The arrival is stored
+    // with bit 0 set, so on the even timestamps of the virtual time every response is one cycle shorter.
+    a->getRxBuffer()->write("hello");
+    Host::HostHal::advanceTime(100);
+    b->getRxBuffer()->write("0123456789abcdef");
+    Host::HostHal::advanceTime(50);
+    for (int i = 0; i < 3; i++) manager.loop();
+    a->getRxBuffer()->write("x");
+    for (int i = 0; i < 3; i++) manager.loop();
+    CHECK_EQUAL(std::string("hello0123456789abcdefx"), owner.sent);
+
+    CHECK_EQUAL(2U, a->getStatistics().responses);
+    CHECK_EQUAL(160000U - 1, a->getStatistics().maxResponse_cycles);
+    CHECK_EQUAL(170000ULL - 2, a->getStatistics().totalResponse_cycles);
+    CHECK_EQUAL(10000U, a->getStatistics().maxLoop_cycles);
+    CHECK_EQUAL(1U, b->getStatistics().responses);
+    CHECK_EQUAL(80000U - 1, b->getStatistics().maxResponse_cycles);
+    CHECK_EQUAL(20000U, b->getStatistics().maxLoop_cycles);
+    CHECK_EQUAL(0U, c->getStatistics().responses);
+    CHECK_EQUAL(1U, c->getStatistics().loops);
+    CHECK_EQUAL(0U, c->getStatistics().maxLoop_cycles);
+#ifdef LIBSMART_ENABLE_BUFFER_STATISTICS
+    CHECK_EQUAL(6U, a->getRxStatistics().bytesIn);
+    CHECK_EQUAL(6U, a->getTxStatistics().bytesOut);
+    CHECK_EQUAL(16U, b->getRxStatistics().bytesIn);
+    CHECK_EQUAL(16U, b->getTxStatistics().bytesOut);
+    CHECK_EQUAL(0U, c->getRxStatistics().bytesIn);
+    CHECK_EQUAL(0U, c->getTxStatistics().bytesOut);
+#endif
+
+    // The counters of a removed session move to the manager, its slot starts again from zero
+    manager.removeSession(a);
+    CHECK_EQUAL(2U, manager.getStatistics().closed.responses);
+#ifdef LIBSMART_ENABLE_BUFFER_STATISTICS
+    CHECK_EQUAL(6U, manager.getStatistics().closedRxBytes);
+    CHECK_EQUAL(6U, manager.getStatistics().closedTxBytes);
+#endif
+    CHECK(manager.getNewSession(&owner, 4) == a);
+    CHECK_EQUAL(0U, a->getStatistics().loops);
+    CHECK_EQUAL(0U, a->getStatistics().responses);
+    CHECK_EQUAL(0U, a->getStatistics().maxResponse_cycles);
+#ifdef LIBSMART_ENABLE_BUFFER_STATISTICS
+    CHECK_EQUAL(0U, a->getRxStatistics().bytesIn);
+    CHECK_EQUAL(0U, a->getTxStatistics().bytesOut);
+    CHECK_EQUAL(0U, a->getTxStatistics().highWater);
+    CHECK_EQUAL(16U, b->getRxStatistics().bytesIn);
+#endif
+    CHECK_EQUAL(1U, b->getStatistics().responses);
+}
+#endif
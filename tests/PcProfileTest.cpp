@@ -0,0 +1,105 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <sstream>
+#include "Check.hpp"
+#include "PcProfile.hpp"
+
+using namespace Stm32Common::Test;
+using namespace Stm32Common::Tools;
+
+namespace {
+    /**
+     * A firmware with a gap after loop(), a function that starts within a bucket and one without a size.
+     */
+    SymbolTable fakeSymbols() {
+        SymbolTable symbols;
+        symbols.add("loop", 0x08000140, 0x20);
+        symbols.add("main", 0x08000100, 0x40);
+        symbols.add("main_alias", 0x08000100, 0x40);
+        symbols.add("helper", 0x08000168, 0x08);
+        symbols.add("tail", 0x08000180, 0);
+        symbols.add("SysTick_Handler", 0x08000200, 0x10);
+        return symbols;
+    }
+
+    std::string nameAt(const SymbolTable &symbols, const uint64_t address) {
+        const SymbolTable::Function *function = symbols.find(address);
+        return function != nullptr ? function->name : "-";
+    }
+}
+
+TEST_CASE(findHonorsSymbolBoundaries) {
+    const SymbolTable symbols = fakeSymbols();
+    CHECK_EQUAL(5U, symbols.getCount());
+
+    CHECK_EQUAL(std::string("-"), nameAt(symbols, 0x080000ff));
+    CHECK_EQUAL(std::string("main"), nameAt(symbols, 0x08000100));
+    CHECK_EQUAL(std::string("main"), nameAt(symbols, 0x0800013f));
+    CHECK_EQUAL(std::string("loop"), nameAt(symbols, 0x08000140));
+    CHECK_EQUAL(std::string("loop"), nameAt(symbols, 0x0800015f));
+    CHECK_EQUAL(std::string("-"), nameAt(symbols, 0x08000160));
+    CHECK_EQUAL(std::string("helper"), nameAt(symbols, 0x08000168));
+    CHECK_EQUAL(std::string("-"), nameAt(symbols, 0x08000170));
+
+    // A function without a size extends to the next one
+    CHECK_EQUAL(std::string("tail"), nameAt(symbols, 0x08000180));
+    CHECK_EQUAL(std::string("tail"), nameAt(symbols, 0x080001ff));
+    CHECK_EQUAL(std::string("SysTick_Handler"), nameAt(symbols, 0x08000200));
+    CHECK_EQUAL(std::string("-"), nameAt(symbols, 0x08000210));
+
+    CHECK(symbols.findFirst(0x08000160, 0x08000170) == symbols.find(0x08000168));
+    CHECK(symbols.findFirst(0x08000170, 0x08000180) == nullptr);
+}
+
+TEST_CASE(samplesAreAttributedToFunctions) {
+    std::istringstream dump(
+        "boot ok\n"
+        "[pc] pcsampler base=0x080000f0 shift=4 scale=1 rate=1000 samples=40 other=3\n"
+        "[pc] 080000f0 3\n"
+        "[pc] 08000100 5\n"
+        "[pc] 08000130 2\n"
+        "[pc] 08000140 4\n"
+        "[pc] 08000160 1\n"
+        "[pc] 08000170 1\n"
+        "[pc] 08000300 2\n"
+        "[pc] end\n"
+        "pcsampler base=0x0 shift=4 scale=0 rate=1 samples=1 other=0\n");
+    PcProfile profile;
+    CHECK(profile.parse(dump));
+    CHECK_EQUAL(7U, profile.getBuckets().size());
+    CHECK_EQUAL(16ULL, profile.getBucketSize());
+    CHECK_EQUAL(40ULL, profile.getSamples());
+
+    // Buckets before, between and after the functions are unknown, a bucket in a gap goes to the function that
+    // starts in it, the samples outside the histogram are outside flash
+    profile.symbolize(fakeSymbols());
+    std::ostringstream text;
+    profile.writeText(text);
+    CHECK_EQUAL(std::string(
+                    "samples 40, rate 1000 Hz, bucket 16 B, scale 2\n"
+                    "      %    samples  function\n"
+                    "  35.90         14  main\n"
+                    "  30.77         12  (unknown)\n"
+                    "  20.51          8  loop\n"
+                    "   7.69          3  (outside flash)\n"
+                    "   5.13          2  helper\n"),
+                text.str());
+
+    std::ostringstream json;
+    profile.writeJson(json);
+    CHECK(json.str().find("{\"name\": \"(unknown)\", \"samples\": 12, \"percent\": 30.77}") != std::string::npos);
+}
+
+TEST_CASE(incompleteDumpIsRejected) {
+    PcProfile profile;
+    std::istringstream noDump("boot ok\n");
+    CHECK(!profile.parse(noDump));
+    CHECK_EQUAL(std::string("no pcsampler dump found"), profile.getError());
+
+    std::istringstream noEnd("pcsampler base=0x08000000 shift=4 scale=0 rate=1000 samples=1 other=0\n08000000 1\n");
+    CHECK(!profile.parse(noEnd));
+    CHECK_EQUAL(std::string("dump without end"), profile.getError());
+}
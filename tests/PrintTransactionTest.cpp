@@ -0,0 +1,76 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "Check.hpp"
+#include "PrintTransaction.hpp"
+#include "StringBuffer.hpp"
+
+using namespace Stm32Common;
+using namespace Stm32Common::Test;
+
+TEST_CASE(committedTransactionFiresWriteOnce) {
+    StringBuffer<32> buffer;
+    int writes = 0;
+    buffer.setOnWriteFn([&writes]() { writes++; });
+
+    {
+        PrintTransaction transaction(buffer);
+        buffer.print("id=");
+        buffer.print(42);
+        buffer.println();
+        CHECK_EQUAL(0U, buffer.getLength());
+        CHECK(transaction.end());
+    }
+    CHECK_EQUAL(std::string("id=42\r\n"), contents(buffer));
+    CHECK_EQUAL(1, writes);
+}
+
+TEST_CASE(overflowRollsBackWholeTransaction) {
+    StringBuffer<8> buffer;
+    buffer.print("ab");
+    {
+        PrintTransaction transaction(buffer);
+        buffer.print("cde");
+        buffer.print("fghij");
+        CHECK(!transaction.end());
+    }
+    CHECK_EQUAL(std::string("ab"), contents(buffer));
+    CHECK_EQUAL(6U, buffer.getRemainingSpace());
+}
+
+TEST_CASE(nestedTransactionsCommitWithOutermost) {
+    StringBuffer<32> buffer;
+    buffer.beginTransaction();
+    buffer.print("outer ");
+    buffer.beginTransaction();
+    buffer.print("inner");
+    CHECK(buffer.endTransaction());
+    CHECK_EQUAL(0U, buffer.getLength());
+    CHECK(buffer.endTransaction());
+    CHECK_EQUAL(std::string("outer inner"), contents(buffer));
+}
+
+TEST_CASE(abortDiscardsAndClosesTransaction) {
+    StringBuffer<32> buffer;
+    int writes = 0;
+    buffer.setOnWriteFn([&writes]() { writes++; });
+    {
+        PrintTransaction transaction(buffer);
+        buffer.print("partial");
+        transaction.abort();
+        CHECK(!transaction.end());
+
+        // The transaction is closed, so this write is not part of it
+        buffer.print("after");
+    }
+    CHECK_EQUAL(std::string("after"), contents(buffer));
+    CHECK_EQUAL(1, writes);
+
+    // A transaction started afterwards is not affected by the abort
+    PrintTransaction next(buffer);
+    buffer.print("!");
+    CHECK(next.end());
+    CHECK_EQUAL(std::string("after!"), contents(buffer));
+}
@@ -0,0 +1,128 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "Check.hpp"
+#include "HostHal.hpp"
+#include "Profiler.hpp"
+#include "StringBuffer.hpp"
+
+using namespace Stm32Common;
+using namespace Stm32Common::Test;
+
+namespace {
+    // One microsecond of the virtual time is 1000 cycles
+    void spend(const uint64_t duration_us) { Host::HostHal::advanceTime(duration_us); }
+}
+
+TEST_CASE(zonesRegisterForTheirLifetime) {
+    const size_t zones = Profiler::getInstance().getZoneCount();
+    {
+        ProfileZone zone("registered");
+        CHECK_EQUAL(zones + 1, Profiler::getInstance().getZoneCount());
+        CHECK(Profiler::getInstance().findZone("registered") == &zone);
+    }
+    CHECK_EQUAL(zones, Profiler::getInstance().getZoneCount());
+    CHECK(Profiler::getInstance().findZone("registered") == nullptr);
+}
+
+TEST_CASE(nestedScopesAreInclusiveAndSelfTimeExclusive) {
+    setMillis(1000);
+    ProfileZone outer("outer");
+    ProfileZone inner("inner");
+
+    for (int i = 0; i < 2; i++) {
+        const ProfileZone::Scope outerScope(outer);
+        spend(10);
+        {
+            const ProfileZone::Scope innerScope(inner);
+            spend(30);
+        }
+        {
+            const ProfileZone::Scope innerScope(inner);
+            spend(5);
+        }
+        spend(i == 0 ? 15 : 25);
+    }
+
+    CHECK_EQUAL(2U, outer.getCalls());
+    CHECK_EQUAL(4U, inner.getCalls());
+    CHECK_EQUAL(130000U, outer.getTotalCycles());
+    CHECK_EQUAL(60000U, outer.getSelfCycles());
+    CHECK_EQUAL(60000U, outer.getMinCycles());
+    CHECK_EQUAL(70000U, outer.getMaxCycles());
+    CHECK_EQUAL(70000U, inner.getTotalCycles());
+    CHECK_EQUAL(70000U, inner.getSelfCycles());
+    CHECK_EQUAL(5000U, inner.getMinCycles());
+    CHECK_EQUAL(30000U, inner.getMaxCycles());
+    CHECK_EQUAL(17500U, inner.getMeanCycles());
+}
+
+TEST_CASE(recursiveZoneCountsEveryLevel) {
+    setMillis(2000);
+    ProfileZone zone("recursive");
+    {
+        const ProfileZone::Scope first(zone);
+        spend(1);
+        {
+            const ProfileZone::Scope second(zone);
+            spend(2);
+        }
+    }
+    // The nested time is counted in both totals, but only once in the self time
+    CHECK_EQUAL(2U, zone.getCalls());
+    CHECK_EQUAL(5000U, zone.getTotalCycles());
+    CHECK_EQUAL(3000U, zone.getSelfCycles());
+}
+
+TEST_CASE(clearResetsZones) {
+    setMillis(3000);
+    ProfileZone zone("cleared");
+    {
+        const ProfileZone::Scope scope(zone);
+        spend(4);
+    }
+    Profiler::getInstance().clear();
+    CHECK_EQUAL(0U, zone.getCalls());
+    CHECK_EQUAL(0U, zone.getTotalCycles());
+    CHECK_EQUAL(0U, zone.getSelfCycles());
+    CHECK_EQUAL(0U, zone.getMinCycles());
+    CHECK_EQUAL(0U, zone.getMaxCycles());
+}
+
+TEST_CASE(printToSortsByTotalTime) {
+    setMillis(4000);
+    Profiler::getInstance().clear();
+    ProfileZone parent("parent");
+    ProfileZone child("child");
+    {
+        const ProfileZone::Scope parentScope(parent);
+        spend(100);
+        const ProfileZone::Scope childScope(child);
+        spend(300);
+    }
+    spend(600);
+
+    StringBuffer<512> out;
+    Profiler::getInstance().printTo(out);
+    CHECK_EQUAL(std::string(
+                    "zone                  calls   total_us    self_us     min_ns    mean_ns     max_ns  share_%\r\n"
+                    "parent                    1        400        100     400000     400000     400000       40\r\n"
+                    "child                     1        300        300     300000     300000     300000       30\r\n"),
+                contents(out));
+}
+
+#ifdef LIBSMART_ENABLE_PROFILER
+TEST_CASE(profileZoneMacroRegistersOnFirstEntry) {
+    setMillis(5000);
+    for (int i = 0; i < 3; i++) {
+        PROFILE_ZONE("macro");
+        spend(2);
+    }
+    const ProfileZone *zone = Profiler::getInstance().findZone("macro");
+    CHECK(zone != nullptr);
+    CHECK_EQUAL(3U, zone->getCalls());
+    CHECK_EQUAL(6000U, zone->getTotalCycles());
+}
+#endif
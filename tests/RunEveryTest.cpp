@@ -0,0 +1,160 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <vector>
+#include "Check.hpp"
+#include "Helper.hpp"
+#include "HostHal.hpp"
+#include "RunEvery.hpp"
+#include "RunEveryMicros.hpp"
+
+using namespace Stm32Common;
+using namespace Stm32Common::Test;
+
+namespace {
+    struct Run {
+        uint32_t at_ms;
+        uint32_t periods;
+    };
+
+    /**
+     * Polls the object once per millisecond. A run that starts at one of the stall times lasts 35 ms.
+     */
+    std::vector<Run> poll(RunEvery &every, const uint32_t start_ms, const uint32_t duration_ms,
+                          const std::vector<uint32_t> &stalls = {}) {
+        std::vector<Run> runs;
+        const uint32_t end_ms = start_ms + duration_ms;
+        while (static_cast<int32_t>(static_cast<uint32_t>(millis()) - end_ms) < 0) {
+            const auto now = static_cast<uint32_t>(millis());
+            every.loop([&]() {
+                runs.push_back({now - start_ms, every.getPeriodsInRun()});
+                for (const uint32_t stall: stalls) {
+                    if (now - start_ms == stall) advanceMillis(35);
+                }
+            });
+            advanceMillis(1);
+        }
+        return runs;
+    }
+
+    std::vector<uint32_t> times(const std::vector<Run> &runs) {
+        std::vector<uint32_t> result;
+        for (const Run &run: runs) result.push_back(run.at_ms);
+        return result;
+    }
+
+    /**
+     * Uses the protected members under their RunEvery names, like existing derived classes do.
+     */
+    class Backoff : public RunEvery {
+    public:
+        explicit Backoff(const uint32_t interval_ms) : RunEvery(interval_ms) { ; }
+
+        void backOff() { _interval_ms *= 2; }
+
+        [[nodiscard]] uint32_t getLastRun() const { return _last_last_run_ms; }
+
+        [[nodiscard]] uint32_t getDelay() const { return _delay_ms; }
+    };
+
+    std::string toText(const std::vector<uint32_t> &values) {
+        std::string text;
+        for (const uint32_t value: values) text += (text.empty() ? "" : ",") + std::to_string(value);
+        return text;
+    }
+}
+
+TEST_CASE(relativeDelaysFollowingRuns) {
+    setMillis(1000);
+    RunEvery every(10);
+    const auto runs = poll(every, 1000, 80, {20});
+    CHECK_EQUAL(std::string("10,20,65,75"), toText(times(runs)));
+}
+
+TEST_CASE(catchUpRunsMissedPeriodsBackToBack) {
+    setMillis(2000);
+    RunEvery every(10);
+    every.setTiming(RunEvery::Timing::CATCH_UP);
+    const auto runs = poll(every, 2000, 80, {20});
+    CHECK_EQUAL(std::string("10,20,56,57,58,60,70"), toText(times(runs)));
+}
+
+TEST_CASE(skipDropsMissedPeriods) {
+    setMillis(3000);
+    RunEvery every(10);
+    every.setTiming(RunEvery::Timing::SKIP);
+    const auto runs = poll(every, 3000, 80, {20});
+    CHECK_EQUAL(std::string("10,20,56,60,70"), toText(times(runs)));
+    for (const Run &run: runs) CHECK_EQUAL(1U, run.periods);
+}
+
+TEST_CASE(coalesceReportsMissedPeriods) {
+    setMillis(4000);
+    RunEvery every(10);
+    every.setTiming(RunEvery::Timing::COALESCE);
+    const auto runs = poll(every, 4000, 80, {20});
+    CHECK_EQUAL(std::string("10,20,56,60,70"), toText(times(runs)));
+    CHECK_EQUAL(3U, runs[2].periods);
+    CHECK_EQUAL(1U, runs[3].periods);
+}
+
+TEST_CASE(lateFirstRunDefinesPhase) {
+    for (const auto timing: {RunEvery::Timing::CATCH_UP, RunEvery::Timing::SKIP, RunEvery::Timing::COALESCE}) {
+        setMillis(5000);
+        RunEvery every(10);
+        every.setTiming(timing);
+        advanceMillis(25);
+        const auto runs = poll(every, 5000, 60);
+        CHECK_EQUAL(std::string("25,35,45,55"), toText(times(runs)));
+        CHECK_EQUAL(1U, runs.front().periods);
+    }
+}
+
+TEST_CASE(runCountMaxFinishes) {
+    setMillis(6000);
+    RunEvery every(10, 5, 3);
+    const auto runs = poll(every, 6000, 100);
+    CHECK_EQUAL(std::string("5,15,25"), toText(times(runs)));
+    CHECK(every.isFinished());
+}
+
+TEST_CASE(microsVariantFollowsVirtualTime) {
+    setMillis(7000);
+    Timebase::begin();
+    int runs = 0;
+    RunEveryMicros every(250, [&runs]() { runs++; });
+    every.setTiming(RunEveryMicros::Timing::CATCH_UP);
+    for (int i = 0; i < 100; i++) {
+        every.loop();
+        Host::HostHal::advanceTime(10);
+    }
+    every.loop();
+    CHECK_EQUAL(4, runs);
+    CHECK_EQUAL(static_cast<uint32_t>(Timebase::getMicros32() + 250), every.getNextRunTime());
+}
+
+TEST_CASE(timebaseConvertsWholeUnitsExactly) {
+    Timebase::begin();
+    CHECK_EQUAL(1U, Timebase::cyclesToMicros(1000));
+    CHECK_EQUAL(400U, Timebase::cyclesToMicros(400000));
+    CHECK_EQUAL(999U, Timebase::cyclesToMicros(999999));
+    // The 32.32 fixed point factor is exact to less than 1 ppm
+    const uint64_t hour_us = Timebase::cyclesToMicros(3600000000000ULL);
+    CHECK(hour_us >= 3600000000ULL && hour_us < 3600003600ULL);
+    CHECK_EQUAL(400000U, Timebase::cyclesToNanos(400000));
+}
+
+TEST_CASE(derivedClassUsesMemberNames) {
+    setMillis(1000);
+    Backoff every(10);
+    CHECK_EQUAL(1000U, every.getLastRun());
+    CHECK_EQUAL(10U, every.getDelay());
+
+    every.backOff();
+    CHECK_EQUAL(20U, every.getInterval());
+    const auto runs = poll(every, 1000, 60);
+    CHECK_EQUAL(std::string("10,30,50"), toText(times(runs)));
+    CHECK_EQUAL(1050U, every.getLastRun());
+}
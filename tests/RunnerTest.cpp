@@ -0,0 +1,222 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <string>
+#include "Check.hpp"
+#include "Process/Runner.hpp"
+#include "StringBuffer.hpp"
+
+using namespace Stm32Common;
+using namespace Stm32Common::Process;
+using namespace Stm32Common::Test;
+
+namespace {
+    uint32_t cycles = 0;
+    std::string calls;
+
+    uint32_t syntheticClock() { return cycles; }
+
+    /**
+     * Appends its letter to the call log and advances the synthetic clock by its cost on every loop().
+     */
+    class CostlyProcess : public ProcessInterface {
+    public:
+        CostlyProcess(const char letter, const uint32_t cost_cycles) : letter(letter), cost_cycles(cost_cycles) { ; }
+
+        void setup() override { calls += std::string("s") + letter; }
+
+        void loop() override {
+            calls += letter;
+            cycles += cost_cycles;
+        }
+
+        void end() override { calls += std::string("e") + letter; }
+
+        void errorHandler() override { errors++; }
+
+        char letter;
+        uint32_t cost_cycles;
+        size_t errors = 0;
+    };
+
+    template<size_t MaxProcesses>
+    void prepare(Runner<MaxProcesses> &runner) {
+        cycles = 0;
+        calls.clear();
+        runner.setClock(syntheticClock);
+    }
+}
+
+TEST_CASE(setupAndEndRunInOppositeOrder) {
+    Runner<3> runner;
+    prepare(runner);
+    CostlyProcess a('a', 1), b('b', 1), c('c', 1);
+    runner.add(a);
+    runner.add(b);
+    runner.add(c);
+    runner.setup();
+    runner.end();
+    CHECK_EQUAL(std::string("sasbscecebea"), calls);
+}
+
+TEST_CASE(addFailsWhenFull) {
+    Runner<2> runner;
+    CostlyProcess a('a', 1), b('b', 1), c('c', 1);
+    CHECK(runner.add(a));
+    CHECK(runner.add(b));
+    CHECK(!runner.add(c));
+    CHECK_EQUAL(2U, runner.getProcessCount());
+}
+
+TEST_CASE(roundRobinRunsInOrderOfAdding) {
+    Runner<3> runner;
+    prepare(runner);
+    CostlyProcess a('a', 1), b('b', 1), c('c', 1);
+    runner.add(a, "a", 0);
+    runner.add(b, "b", 9);
+    runner.add(c, "c", 5);
+    runner.loop();
+    runner.loop();
+    CHECK_EQUAL(std::string("abcabc"), calls);
+}
+
+TEST_CASE(priorityRunsHighestFirstAndKeepsOrderOfEqualPriorities) {
+    Runner<4> runner;
+    prepare(runner);
+    runner.setPolicy(RunnerBase::Policy::PRIORITY);
+    CostlyProcess a('a', 1), b('b', 1), c('c', 1), d('d', 1);
+    runner.add(a, "a", 1);
+    runner.add(b, "b", 5);
+    runner.add(c, "c", 1);
+    runner.add(d, "d", 5);
+    runner.loop();
+    CHECK_EQUAL(std::string("bdac"), calls);
+}
+
+TEST_CASE(statisticsFollowSyntheticClock) {
+    Runner<2> runner;
+    prepare(runner);
+    CostlyProcess a('a', 10), b('b', 100);
+    runner.add(a, "a");
+    runner.add(b, "b");
+    runner.loop();
+    b.cost_cycles = 40;
+    runner.loop();
+    runner.loop();
+
+    const RunnerBase::Statistics &stats = runner.getStatistics(1);
+    CHECK_EQUAL(3U, stats.runs);
+    CHECK_EQUAL(40U, stats.lastCycles);
+    CHECK_EQUAL(100U, stats.maxCycles);
+    CHECK_EQUAL(180U, static_cast<uint32_t>(stats.totalCycles));
+    CHECK_EQUAL(60U, stats.getMeanCycles());
+    CHECK_EQUAL(3U, runner.getStatistics(0).runs);
+    CHECK_EQUAL(10U, runner.getStatistics(0).maxCycles);
+
+    runner.clearStatistics();
+    CHECK_EQUAL(0U, runner.getStatistics(1).runs);
+    CHECK_EQUAL(0U, runner.getStatistics(1).maxCycles);
+}
+
+TEST_CASE(processOverBudgetGetsErrorHandler) {
+    Runner<2> runner;
+    prepare(runner);
+    CostlyProcess a('a', 50), b('b', 5);
+    runner.add(a, "a", 0, 40);
+    runner.add(b, "b", 0, 40);
+    runner.loop();
+    runner.loop();
+    CHECK_EQUAL(2U, runner.getStatistics(0).overruns);
+    CHECK_EQUAL(2U, a.errors);
+    CHECK_EQUAL(0U, runner.getStatistics(1).overruns);
+    CHECK_EQUAL(0U, b.errors);
+
+    // A duration equal to the budget is not an overrun
+    a.cost_cycles = 40;
+    runner.loop();
+    CHECK_EQUAL(2U, runner.getStatistics(0).overruns);
+}
+
+TEST_CASE(roundRobinPassBudgetContinuesWithLeftOutProcess) {
+    Runner<3> runner;
+    prepare(runner);
+    runner.setPassBudget(15);
+    CostlyProcess a('a', 10), b('b', 10), c('c', 10);
+    runner.add(a);
+    runner.add(b);
+    runner.add(c);
+
+    // Every pass runs two processes: the second starts at 10 cycles, the third would start at 20
+    runner.loop();
+    runner.loop();
+    runner.loop();
+    CHECK_EQUAL(std::string("abcabc"), calls);
+    CHECK_EQUAL(3U, runner.getPassOverruns());
+    for (size_t i = 0; i < 3; i++) CHECK_EQUAL(2U, runner.getStatistics(i).runs);
+}
+
+TEST_CASE(priorityPassBudgetStartsAgainAtHighestPriority) {
+    Runner<3> runner;
+    prepare(runner);
+    runner.setPolicy(RunnerBase::Policy::PRIORITY);
+    runner.setPassBudget(15);
+    CostlyProcess a('a', 10), b('b', 10), c('c', 10);
+    runner.add(a, "a", 1);
+    runner.add(b, "b", 2);
+    runner.add(c, "c", 3);
+    runner.loop();
+    runner.loop();
+    CHECK_EQUAL(std::string("cbcb"), calls);
+    CHECK_EQUAL(0U, runner.getStatistics(0).runs);
+    CHECK_EQUAL(2U, runner.getPassOverruns());
+}
+
+TEST_CASE(firstProcessAlwaysRuns) {
+    Runner<2> runner;
+    prepare(runner);
+    runner.setPassBudget(5);
+    CostlyProcess a('a', 10), b('b', 10);
+    runner.add(a);
+    runner.add(b);
+    runner.loop();
+    runner.loop();
+    CHECK_EQUAL(std::string("ab"), calls);
+}
+
+TEST_CASE(nestedRunnerIsMeasuredAsOneProcess) {
+    Runner<2> outer;
+    prepare(outer);
+    Runner<2> inner;
+    inner.setClock(syntheticClock);
+    CostlyProcess a('a', 3), b('b', 4), c('c', 5);
+    inner.add(a);
+    inner.add(b);
+    outer.add(inner, "inner");
+    outer.add(c, "c");
+    outer.loop();
+    CHECK_EQUAL(std::string("abc"), calls);
+    CHECK_EQUAL(7U, outer.getStatistics(0).lastCycles);
+    CHECK_EQUAL(4U, inner.getStatistics(1).lastCycles);
+}
+
+TEST_CASE(printToListsStatistics) {
+    Runner<2> runner;
+    prepare(runner);
+    runner.setPassBudget(4);
+    CostlyProcess a('a', 30), b('b', 5);
+    runner.add(a, "sensor", 2, 20);
+    runner.add(b);
+    runner.loop();
+    runner.loop();
+
+    StringBuffer<512> out;
+    runner.printTo(out);
+    CHECK_EQUAL(std::string(
+                    "process          prio       runs   overruns       last        max       mean\r\n"
+                    "sensor              2          1          1         30         30         30\r\n"
+                    "-                   0          1          0          5          5          5\r\n"
+                    "pass budget exceeded 2 times\r\n"),
+                contents(out));
+}
@@ -0,0 +1,228 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <vector>
+#include "Check.hpp"
+#include "Helper.hpp"
+#include "RunEvery.hpp"
+#include "Scheduler.hpp"
+
+using namespace Stm32Common;
+using namespace Stm32Common::Test;
+
+namespace {
+    /**
+     * Runs the scheduler once per millisecond.
+     */
+    template<size_t MaxTasks>
+    void runFor(Scheduler<MaxTasks> &scheduler, const uint32_t duration_ms) {
+        for (uint32_t i = 0; i < duration_ms; i++) {
+            scheduler.loop();
+            advanceMillis(1);
+        }
+        scheduler.loop();
+    }
+
+    /**
+     * Counts its runs, without std::function.
+     */
+    class CountingTask : public RunEvery {
+    public:
+        using RunEvery::RunEvery;
+
+        std::vector<uint32_t> runs;
+
+    protected:
+        void run() override { runs.push_back(static_cast<uint32_t>(millis())); }
+    };
+
+    /**
+     * Takes runtime_ms of the virtual time on every run, like a long housekeeping task.
+     */
+    class LongTask : public CountingTask {
+    public:
+        LongTask(const uint32_t interval_ms, const uint32_t runtime_ms)
+            : CountingTask(interval_ms), runtime_ms(runtime_ms) { ; }
+
+        uint32_t runtime_ms;
+
+    protected:
+        void run() override {
+            CountingTask::run();
+            advanceMillis(runtime_ms);
+        }
+    };
+
+    /**
+     * Is held back by isSet() as long as it is blocked.
+     */
+    class BlockedTask : public CountingTask {
+    public:
+        using CountingTask::CountingTask;
+
+        bool blocked = true;
+
+        [[nodiscard]] bool isSet() const override { return !blocked && CountingTask::isSet(); }
+    };
+}
+
+TEST_CASE(runsTasksAcrossMillisWrapAround) {
+    setMillis(UINT32_MAX - 24);
+    Scheduler<4> scheduler;
+    CountingTask fast(10);
+    CountingTask slow(30);
+    fast.setTiming(RunEvery::Timing::CATCH_UP);
+    CHECK(scheduler.add(fast));
+    CHECK(scheduler.add(slow));
+
+    runFor(scheduler, 100);
+
+    CHECK_EQUAL(10U, fast.runs.size());
+    for (size_t i = 0; i < fast.runs.size(); i++) {
+        CHECK_EQUAL(static_cast<uint32_t>(UINT32_MAX - 14 + i * 10), fast.runs[i]);
+    }
+    CHECK_EQUAL(3U, slow.runs.size());
+    CHECK_EQUAL(static_cast<uint32_t>(UINT32_MAX + 6), slow.runs.front());
+}
+
+TEST_CASE(higherPriorityRunsFirst) {
+    setMillis(1000);
+    Scheduler<4> scheduler;
+    std::vector<char> order;
+    RunEvery low(5, [&order]() { order.push_back('l'); });
+    RunEvery high(5, [&order]() { order.push_back('h'); });
+    high.setPriority(1);
+    scheduler.add(low);
+    scheduler.add(high);
+
+    advanceMillis(5);
+    scheduler.loop();
+    CHECK_EQUAL(2U, order.size());
+    CHECK_EQUAL('h', order.front());
+}
+
+TEST_CASE(settersReorderTheQueue) {
+    setMillis(2000);
+    Scheduler<4> scheduler;
+    CountingTask task(100);
+    scheduler.add(task);
+    CHECK_EQUAL(2100U, scheduler.getNextDeadline());
+
+    task.setDelay(10);
+    CHECK_EQUAL(2010U, scheduler.getNextDeadline());
+
+    // Assigning another object keeps the registration and reorders it
+    task = CountingTask(50);
+    CHECK(task.isScheduled());
+    CHECK_EQUAL(task.getNextRunTime(), scheduler.getNextDeadline());
+}
+
+TEST_CASE(dispatchHonorsIsSet) {
+    setMillis(3000);
+    Scheduler<4> scheduler;
+    BlockedTask blocked(5);
+    CountingTask other(5);
+    scheduler.add(blocked);
+    scheduler.add(other);
+
+    runFor(scheduler, 20);
+    CHECK(blocked.runs.empty());
+    CHECK_EQUAL(4U, other.runs.size());
+
+    blocked.blocked = false;
+    runFor(scheduler, 1);
+    CHECK_EQUAL(1U, blocked.runs.size());
+}
+
+TEST_CASE(finishedTasksLeaveTheQueue) {
+    setMillis(4000);
+    Scheduler<4> scheduler;
+    CountingTask twice(5, 5, 2);
+    scheduler.add(twice);
+
+    runFor(scheduler, 30);
+    CHECK_EQUAL(2U, twice.runs.size());
+    CHECK_EQUAL(0U, scheduler.getTaskCount());
+}
+
+TEST_CASE(longLowPriorityTaskDelaysDueHighPriorityTask) {
+    setMillis(5000);
+    Scheduler<4> scheduler;
+    CountingTask sampling(5);
+    sampling.setPriority(2);
+    sampling.setDeadline(2);
+    LongTask housekeeping(20, 30);
+    scheduler.add(housekeeping);
+    scheduler.add(sampling);
+
+    // At 5020 both are due: sampling runs first, then housekeeping blocks the scheduler until 5050
+    runFor(scheduler, 20);
+    CHECK(sampling.runs == std::vector<uint32_t>({5005, 5010, 5015, 5020}));
+    CHECK(housekeeping.runs == std::vector<uint32_t>({5020}));
+    CHECK_EQUAL(5050UL, ::millis());
+
+    // The run of sampling that was due at 5025 starts 25 ms late
+    scheduler.loop();
+    CHECK_EQUAL(5050U, sampling.runs.back());
+    CHECK_EQUAL(5055U, sampling.getNextRunTime());
+
+#ifdef LIBSMART_ENABLE_RUNEVERY_STATISTICS
+    const RunEvery::TimingStatistics &stats = sampling.getTimingStatistics();
+    CHECK_EQUAL(5U, stats.runs);
+    CHECK_EQUAL(1U, stats.lateRuns);
+    CHECK_EQUAL(1U, stats.deadlineMisses);
+    CHECK_EQUAL(25U, stats.maxJitter_ms);
+    CHECK_EQUAL(30000000U, housekeeping.getTimingStatistics().maxExecution_cycles);
+    CHECK_EQUAL(0U, housekeeping.getTimingStatistics().deadlineMisses);
+#endif
+}
+
+TEST_CASE(passBudgetRunsEveryDueTaskOnce) {
+    setMillis(6000);
+    Scheduler<4> scheduler;
+    CountingTask busy(0);
+    busy.setPriority(1);
+    CountingTask slow(10);
+    scheduler.add(busy);
+    scheduler.add(slow);
+
+    // A task with interval 0 is due again immediately, but the pass ends after one run of every task
+    advanceMillis(10);
+    scheduler.loop();
+    CHECK_EQUAL(1U, busy.runs.size());
+    CHECK_EQUAL(1U, slow.runs.size());
+
+    scheduler.loop();
+    CHECK_EQUAL(2U, busy.runs.size());
+    CHECK_EQUAL(1U, slow.runs.size());
+}
+
+TEST_CASE(deadlineMissesAndExecutionTime) {
+    setMillis(7000);
+    Scheduler<4> scheduler;
+    LongTask task(10, 3);
+    task.setDeadline(3);
+    scheduler.add(task);
+
+    // The runs end 3, 7 and 1 ms after their due time
+    setMillis(7010);
+    scheduler.loop();
+    task.runtime_ms = 7;
+    setMillis(7023);
+    scheduler.loop();
+    task.runtime_ms = 1;
+    setMillis(7040);
+    scheduler.loop();
+    CHECK(task.runs == std::vector<uint32_t>({7010, 7023, 7040}));
+
+#ifdef LIBSMART_ENABLE_RUNEVERY_STATISTICS
+    // A run that ends exactly at its deadline is on time
+    const RunEvery::TimingStatistics &stats = task.getTimingStatistics();
+    CHECK_EQUAL(3U, stats.runs);
+    CHECK_EQUAL(1U, stats.deadlineMisses);
+    CHECK_EQUAL(7000000U, stats.maxExecution_cycles);
+    CHECK_EQUAL(1000000U, stats.lastExecution_cycles);
+#endif
+}
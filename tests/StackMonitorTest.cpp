@@ -0,0 +1,112 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "Check.hpp"
+#include "StackMonitor.hpp"
+#include "StringBuffer.hpp"
+
+using namespace Stm32Common;
+using namespace Stm32Common::Test;
+
+namespace {
+    /**
+     * Writes the given number of words below the top, as a stack that has grown this deep.
+     */
+    void dirty(uint32_t *top, const size_t words) {
+        for (size_t i = 1; i <= words; i++) top[-static_cast<ptrdiff_t>(i)] = 0x12345678;
+    }
+}
+
+TEST_CASE(paintFillsWholeStackWithPattern) {
+    uint32_t stack[32] = {};
+    StackMonitor<2> monitor;
+    CHECK(monitor.addStack("task", stack, stack + 32));
+    for (const uint32_t word: stack) CHECK_EQUAL(StackRegion::pattern, word);
+
+    // An untouched stack is free
+    CHECK(!monitor.update());
+    const StackRegion &region = monitor.getStack(0);
+    CHECK_EQUAL(128U, region.getSize());
+    CHECK_EQUAL(0U, region.getUsed());
+    CHECK_EQUAL(128U, region.getFree());
+    CHECK(!region.isOverflowed());
+}
+
+TEST_CASE(paintStopsAtEnd) {
+    uint32_t stack[32] = {};
+    StackMonitor<2> monitor;
+    monitor.addStack("main", stack, stack + 32, stack + 24);
+    CHECK_EQUAL(StackRegion::pattern, stack[23]);
+    CHECK_EQUAL(0U, stack[24]);
+
+    // The words above the end count as used
+    monitor.update();
+    CHECK_EQUAL(32U, monitor.getStack(0).getUsed());
+}
+
+TEST_CASE(highWaterFollowsDeepestUse) {
+    uint32_t stack[64] = {};
+    StackMonitor<2> monitor;
+    monitor.addStack("task", stack, stack + 64);
+
+    dirty(stack + 64, 10);
+    // The mark moves with update() only
+    CHECK_EQUAL(0U, monitor.getStack(0).getUsed());
+    monitor.update();
+    const StackRegion &region = monitor.getStack(0);
+    CHECK_EQUAL(40U, region.getUsed());
+    CHECK_EQUAL(216U, region.getFree());
+
+    // A used word that has the pattern again does not lower the mark
+    for (size_t i = 54; i < 64; i++) stack[i] = StackRegion::pattern;
+    monitor.update();
+    CHECK_EQUAL(40U, region.getUsed());
+
+    dirty(stack + 64, 20);
+    monitor.update();
+    CHECK_EQUAL(80U, region.getUsed());
+    CHECK_EQUAL(176U, region.getFree());
+}
+
+TEST_CASE(usedBottomWordIsOverflow) {
+    uint32_t stack[16] = {};
+    StackMonitor<2> monitor;
+    monitor.addStack("task", stack, stack + 16);
+
+    // All words but the bottom one used
+    dirty(stack + 16, 15);
+    CHECK(!monitor.update());
+    CHECK_EQUAL(60U, monitor.getStack(0).getUsed());
+    CHECK_EQUAL(4U, monitor.getStack(0).getFree());
+
+    dirty(stack + 16, 16);
+    CHECK(monitor.update());
+    CHECK(monitor.getStack(0).isOverflowed());
+    CHECK_EQUAL(64U, monitor.getStack(0).getUsed());
+    CHECK_EQUAL(0U, monitor.getStack(0).getFree());
+}
+
+TEST_CASE(stacksAreScannedIndependently) {
+    uint32_t first[16] = {};
+    uint32_t second[32] = {};
+    uint32_t third[8] = {};
+    StackMonitor<2> monitor;
+    CHECK(monitor.addStack("first", first, first + 16));
+    CHECK(monitor.addStack("second", second, second + 32));
+    CHECK(!monitor.addStack("third", third, third + 8));
+    CHECK_EQUAL(2U, monitor.getStackCount());
+
+    dirty(first + 16, 16);
+    dirty(second + 32, 8);
+    CHECK(monitor.update());
+
+    StringBuffer<256> out;
+    monitor.printTo(out);
+    CHECK_EQUAL(std::string(
+                    "stack            size     used     free  used_%\r\n"
+                    "first              64       64        0     100 OVERFLOW\r\n"
+                    "second            128       32       96      25\r\n"),
+                contents(out));
+}
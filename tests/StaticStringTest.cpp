@@ -0,0 +1,118 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <cstdlib>
+#include <new>
+#include "Check.hpp"
+#include "Helper.hpp"
+#include "StaticString.hpp"
+#include "StringBuffer.hpp"
+
+using namespace Stm32Common;
+using namespace Stm32Common::Test;
+
+namespace {
+    size_t allocations = 0;
+
+    /**
+     * Advances the virtual time by 1 ms on every read of an empty buffer, so a timed read times out.
+     */
+    class SlowStream : public StringBuffer<32> {
+    public:
+        int read() override {
+            const int c = StringBuffer::read();
+            if (c < 0) advanceMillis(1);
+            return c;
+        }
+
+        using StringBuffer::read;
+    };
+}
+
+// Counts the heap allocations of the test executable
+void *operator new(const size_t size) {
+    allocations++;
+    if (void *p = std::malloc(size == 0 ? 1 : size)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+
+void operator delete(void *p, size_t) noexcept { std::free(p); }
+
+TEST_CASE(appendTruncatesAtCapacity) {
+    StaticString<5> str("hello world");
+    CHECK_EQUAL(std::string("hello"), std::string(str.c_str()));
+    CHECK_EQUAL(5U, str.length());
+    CHECK(str.isFull());
+    CHECK(str.isTruncated());
+
+    str.clear();
+    CHECK(!str.isTruncated());
+    str.append("abc").append(42);
+    CHECK(str == "abc42");
+    CHECK(!str.isTruncated());
+    str.append('x');
+    CHECK(str == "abc42");
+    CHECK(str.isTruncated());
+}
+
+TEST_CASE(formatTruncatesAtCapacity) {
+    StaticString<8> str;
+    CHECK_EQUAL(8U, str.format("%d-%s", 1234, "abcdef"));
+    CHECK(str == "1234-abc");
+    CHECK_EQUAL('\0', str.c_str()[8]);
+    CHECK(str.isTruncated());
+
+    CHECK_EQUAL(0U, str.appendFormat("%d", 5));
+    CHECK(str == "1234-abc");
+}
+
+TEST_CASE(readStringUntilConsumesTerminator) {
+    SlowStream stream;
+    stream.write("abc\ndef");
+    StaticString<16> str;
+    CHECK_EQUAL(3U, stream.readStringUntil('\n', str));
+    CHECK(str == "abc");
+    CHECK_EQUAL(std::string("def"), contents(stream));
+}
+
+TEST_CASE(readStringUntilStopsWhenFull) {
+    SlowStream stream;
+    stream.write("abcdefg\n");
+    StaticString<4> str;
+    CHECK_EQUAL(4U, stream.readStringUntil('\n', str));
+    CHECK(str == "abcd");
+    // Nothing has been dropped, the rest is left in the stream
+    CHECK(!str.isTruncated());
+    CHECK_EQUAL(std::string("efg\n"), contents(stream));
+}
+
+TEST_CASE(readStringUntilTimesOut) {
+    setMillis(1000);
+    SlowStream stream;
+    stream.setTimeout(20);
+    stream.write("ab");
+    StaticString<16> str("> ");
+    CHECK_EQUAL(2U, stream.readStringUntil('\n', str));
+    CHECK(str == "> ab");
+    CHECK_EQUAL(1020UL, ::millis());
+}
+
+TEST_CASE(readStringUntilDoesNotAllocate) {
+    SlowStream stream;
+    stream.setTimeout(5);
+    StaticString<32> str;
+    const size_t before = allocations;
+    for (int i = 0; i < 10; i++) {
+        str.clear();
+        stream.write("GET /status\r\n");
+        stream.readStringUntil('\n', str);
+        str.append(" ok ").append(i);
+    }
+    stream.readStringUntil('\n', str);
+    CHECK_EQUAL(before, allocations);
+    CHECK(str == "GET /status\r ok 9");
+}
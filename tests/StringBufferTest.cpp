@@ -0,0 +1,110 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "Check.hpp"
+#include "StringBuffer.hpp"
+
+using namespace Stm32Common;
+using namespace Stm32Common::Test;
+
+TEST_CASE(printfFitsWithTerminator) {
+    StringBuffer<8> buffer;
+    CHECK_EQUAL(7U, buffer.printf("%s", "abcdefg"));
+    CHECK_EQUAL(std::string("abcdefg"), contents(buffer));
+#ifdef LIBSMART_ENABLE_BUFFER_STATISTICS
+    CHECK_EQUAL(0U, buffer.getStatistics().rejectedWrites);
+#endif
+}
+
+TEST_CASE(printfExactFitLosesLastCharacter) {
+    StringBuffer<8> buffer;
+    // The NUL of vsnprintf() takes the last byte, so one character of the eight is lost
+    CHECK_EQUAL(7U, buffer.printf("%s", "abcdefgh"));
+    CHECK_EQUAL(std::string("abcdefg"), contents(buffer));
+#ifdef LIBSMART_ENABLE_BUFFER_STATISTICS
+    CHECK_EQUAL(1U, buffer.getStatistics().rejectedWrites);
+    CHECK_EQUAL(1U, buffer.getStatistics().rejectedBytes);
+    CHECK_EQUAL(7U, buffer.getStatistics().bytesIn);
+#endif
+}
+
+TEST_CASE(printfTruncationCountsAllLostCharacters) {
+    StringBuffer<8> buffer;
+    buffer.write("ab");
+    CHECK_EQUAL(5U, buffer.printf("%d", 1234567890));
+    CHECK_EQUAL(std::string("ab12345"), contents(buffer));
+#ifdef LIBSMART_ENABLE_BUFFER_STATISTICS
+    CHECK_EQUAL(5U, buffer.getStatistics().rejectedBytes);
+#endif
+
+    // A full buffer takes nothing
+    buffer.write('x');
+    CHECK_EQUAL(0U, buffer.printf("%d", 42));
+#ifdef LIBSMART_ENABLE_BUFFER_STATISTICS
+    CHECK_EQUAL(7U, buffer.getStatistics().rejectedBytes);
+#endif
+}
+
+#ifdef LIBSMART_ENABLE_BUFFER_STATISTICS
+TEST_CASE(writeThatDoesNotFitIsRejectedAsAWhole) {
+    StringBuffer<8> buffer;
+    CHECK_EQUAL(5U, buffer.write("abcde"));
+    CHECK_EQUAL(0U, buffer.write("vwxyz"));
+    CHECK_EQUAL(std::string("abcde"), contents(buffer));
+    CHECK_EQUAL(5U, buffer.getStatistics().bytesIn);
+    CHECK_EQUAL(1U, buffer.getStatistics().rejectedWrites);
+    CHECK_EQUAL(5U, buffer.getStatistics().rejectedBytes);
+
+    // A rolled back transaction loses the bytes reserved before the write that failed, too
+    buffer.beginTransaction();
+    buffer.write("fg");
+    buffer.write("hij");
+    CHECK(!buffer.endTransaction());
+    CHECK_EQUAL(std::string("abcde"), contents(buffer));
+    CHECK_EQUAL(5U, buffer.getStatistics().bytesIn);
+    CHECK_EQUAL(2U, buffer.getStatistics().rejectedWrites);
+    CHECK_EQUAL(10U, buffer.getStatistics().rejectedBytes);
+}
+
+TEST_CASE(highWaterStaysAfterOverflow) {
+    StringBuffer<8> buffer;
+    buffer.write("abcdef");
+    buffer.write("ghi");
+    CHECK_EQUAL(6U, buffer.getStatistics().highWater);
+
+    // Reading the buffer empty is counted as a drain, the high-water mark stays
+    CHECK_EQUAL(6U, buffer.remove(6));
+    CHECK_EQUAL(6U, buffer.getStatistics().bytesOut);
+    CHECK_EQUAL(1U, buffer.getStatistics().drains);
+    buffer.write("xy");
+    CHECK_EQUAL(6U, buffer.getStatistics().highWater);
+    CHECK_EQUAL(8U, buffer.getStatistics().bytesIn);
+    CHECK_EQUAL(1U, buffer.getStatistics().rejectedWrites);
+
+    buffer.write("012345");
+    CHECK_EQUAL(8U, buffer.getStatistics().highWater);
+}
+
+TEST_CASE(clearStatisticsStartsAtCurrentLength) {
+    StringBuffer<8> buffer;
+    buffer.write("abcdefgh");
+    buffer.write('i');
+    buffer.remove(5);
+    buffer.clearStatistics();
+    const BufferStatistics &statistics = buffer.getStatistics();
+    CHECK_EQUAL(0U, statistics.bytesIn);
+    CHECK_EQUAL(0U, statistics.bytesOut);
+    CHECK_EQUAL(0U, statistics.rejectedWrites);
+    CHECK_EQUAL(0U, statistics.rejectedBytes);
+    CHECK_EQUAL(0U, statistics.drains);
+    CHECK_EQUAL(3U, statistics.highWater);
+
+    // The contents are not touched
+    CHECK_EQUAL(std::string("fgh"), contents(buffer));
+    buffer.remove(3);
+    CHECK_EQUAL(1U, statistics.drains);
+    CHECK_EQUAL(3U, statistics.bytesOut);
+}
+#endif
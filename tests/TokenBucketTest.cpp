@@ -0,0 +1,135 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "Check.hpp"
+#include "RateLimitedPrint.hpp"
+#include "StringBuffer.hpp"
+#include "TokenBucket.hpp"
+
+using namespace Stm32Common;
+using namespace Stm32Common::Test;
+
+namespace {
+    unsigned long now_ms = 0;
+
+    unsigned long clock() { return now_ms; }
+}
+
+TEST_CASE(startsFullAndTakesUpToAvailable) {
+    now_ms = 0;
+    TokenBucket bucket(1000, 64);
+    bucket.setClock(clock);
+    CHECK_EQUAL(64U, bucket.getAvailable());
+    CHECK_EQUAL(64U, bucket.take(100));
+    CHECK_EQUAL(0U, bucket.take(1));
+}
+
+TEST_CASE(refillsAtRateUpToBurst) {
+    now_ms = 1000;
+    TokenBucket bucket(1000, 64);
+    bucket.setClock(clock);
+    bucket.take(64);
+
+    now_ms += 10;
+    CHECK_EQUAL(10U, bucket.getAvailable());
+    now_ms += 1000;
+    CHECK_EQUAL(64U, bucket.getAvailable());
+}
+
+TEST_CASE(fractionalRatesAccumulate) {
+    now_ms = 0;
+    TokenBucket bucket(300, 10);
+    bucket.setClock(clock);
+    bucket.take(10);
+
+    // 0.3 bytes per millisecond
+    for (int i = 0; i < 10; i++) {
+        now_ms++;
+        (void) bucket.getAvailable();
+    }
+    CHECK_EQUAL(3U, bucket.getAvailable());
+}
+
+TEST_CASE(consumeNeverGoesNegative) {
+    now_ms = 0;
+    TokenBucket bucket(1000, 16);
+    bucket.setClock(clock);
+    bucket.consume(100);
+    CHECK_EQUAL(0U, bucket.getAvailable());
+    now_ms += 5;
+    CHECK_EQUAL(5U, bucket.getAvailable());
+}
+
+TEST_CASE(timeUntilAvailable) {
+    now_ms = 0;
+    TokenBucket bucket(1000, 16);
+    bucket.setClock(clock);
+    bucket.take(16);
+    CHECK_EQUAL(8U, bucket.getTimeUntilAvailable(8));
+    CHECK_EQUAL(0U, bucket.getTimeUntilAvailable(0));
+    CHECK_EQUAL(UINT32_MAX, bucket.getTimeUntilAvailable(17));
+
+    TokenBucket stopped(0, 16);
+    stopped.setClock(clock);
+    stopped.take(16);
+    CHECK_EQUAL(UINT32_MAX, stopped.getTimeUntilAvailable(1));
+}
+
+TEST_CASE(survivesClockWrapAround) {
+    now_ms = 0xFFFFFFF0UL;
+    TokenBucket bucket(1000, 64);
+    bucket.setClock(clock);
+    bucket.take(64);
+    now_ms = 0x10;
+    CHECK_EQUAL(32U, bucket.getAvailable());
+}
+
+TEST_CASE(consumeOfAllWholeBytesKeepsRemainder) {
+    now_ms = 0;
+    TokenBucket bucket(300, 10);
+    bucket.setClock(clock);
+    bucket.take(10);
+
+    // 1.2 bytes, of which 0.2 stay after consuming one
+    now_ms += 4;
+    CHECK_EQUAL(1U, bucket.getAvailable());
+    bucket.consume(1);
+    now_ms += 3;
+    CHECK_EQUAL(1U, bucket.getAvailable());
+}
+
+TEST_CASE(burstIsLimitedToMaxBurst) {
+    now_ms = 0;
+    TokenBucket bucket(1000, 5000000);
+    bucket.setClock(clock);
+    CHECK_EQUAL(TokenBucket::MaxBurst, bucket.getBurst());
+    CHECK_EQUAL(static_cast<size_t>(TokenBucket::MaxBurst), bucket.getAvailable());
+
+    bucket.setRate(1000, UINT32_MAX);
+    CHECK_EQUAL(TokenBucket::MaxBurst, bucket.getBurst());
+    CHECK_EQUAL(static_cast<size_t>(TokenBucket::MaxBurst), bucket.take(SIZE_MAX));
+    CHECK_EQUAL(TokenBucket::MaxBurst, bucket.getTimeUntilAvailable(TokenBucket::MaxBurst));
+
+    now_ms += 10000000;
+    CHECK_EQUAL(static_cast<size_t>(TokenBucket::MaxBurst), bucket.getAvailable());
+}
+
+TEST_CASE(rateLimitedPrintCutsWriteShort) {
+    now_ms = 0;
+    TokenBucket bucket(1000, 10);
+    bucket.setClock(clock);
+    StringBuffer<64> target;
+    RateLimitedPrint out(target, bucket);
+
+    CHECK_EQUAL(10, out.availableForWrite());
+    CHECK_EQUAL(10U, out.print("0123456789abcdef"));
+    CHECK_EQUAL(0, out.availableForWrite());
+    CHECK_EQUAL(0U, out.write('x'));
+
+    now_ms += 3;
+    CHECK_EQUAL(3, out.availableForWrite());
+    CHECK_EQUAL(3U, out.print("xyz12"));
+    CHECK_EQUAL(std::string("0123456789xyz"), contents(target));
+}
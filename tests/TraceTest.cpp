@@ -0,0 +1,161 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <sstream>
+#include "Check.hpp"
+#include "HostHal.hpp"
+#include "StringBuffer.hpp"
+#include "Trace.hpp"
+#include "TraceDecoder.hpp"
+
+using namespace Stm32Common;
+using namespace Stm32Common::Test;
+using Trace::EventType;
+using Trace::TraceDecoder;
+
+namespace {
+    void spend(const uint64_t duration_us) { Host::HostHal::advanceTime(duration_us); }
+
+    /**
+     * Drains up to maxWords words of the sink and feeds them to the decoder, as trace2chrome does with a dump.
+     */
+    void drain(RingTraceSinkBase &sink, TraceDecoder &decoder, const size_t maxWords = SIZE_MAX) {
+        StringBuffer<512> out;
+        sink.drainTo(out, maxWords);
+        decoder.feedRaw(out.getReadPointer(), out.getLength());
+    }
+}
+
+TEST_CASE(recordsRoundTripToChromeJson) {
+    setMillis(1000);
+    RingTraceSink<64> sink;
+    Tracer::begin(&sink);
+    Tracer::name(EventType::ZONE_BEGIN, 1, "loop");
+    Tracer::name(EventType::COUNTER, 2, "rx \"level\"");
+    Tracer::name(EventType::ISR_ENTER, 53, "USART1");
+
+    Tracer::zoneBegin(1);
+    spend(10);
+    Tracer::counter(2, 42);
+    spend(5);
+    Host::HostHal::setActiveIrq(53);
+    {
+        Tracer::IsrScope isr;
+        spend(3);
+    }
+    Host::HostHal::setActiveIrq(0);
+    Tracer::wakeUp(4);
+    spend(2);
+    Tracer::zoneEnd(1);
+    Tracer::end();
+    CHECK(!Tracer::isEnabled());
+    Tracer::counter(2, 43);
+
+    TraceDecoder decoder;
+    drain(sink, decoder);
+    CHECK_EQUAL(0U, sink.getLength());
+    CHECK_EQUAL(0U, decoder.getSkippedWords());
+    CHECK_EQUAL(1000000000U, decoder.getFrequency());
+    CHECK_EQUAL(std::string("rx \"level\""), decoder.getName(EventType::COUNTER, 2));
+
+    const auto &events = decoder.getEvents();
+    CHECK_EQUAL(6U, events.size());
+    CHECK_EQUAL(1000000000ULL, events[0].cycles);
+    CHECK(events[1].type == EventType::COUNTER);
+    CHECK_EQUAL(2U, events[1].id);
+    CHECK_EQUAL(42U, events[1].value);
+    CHECK_EQUAL(1000020000ULL, events[5].cycles);
+
+    std::ostringstream json;
+    decoder.writeChromeJson(json);
+    CHECK_EQUAL(std::string(
+                    "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n"
+                    "{\"ph\":\"M\",\"pid\":1,\"name\":\"process_name\",\"args\":{\"name\":\"firmware\"}},\n"
+                    "{\"ph\":\"M\",\"pid\":1,\"tid\":1,\"name\":\"thread_name\",\"args\":{\"name\":\"main\"}},\n"
+                    "{\"ph\":\"M\",\"pid\":1,\"tid\":2,\"name\":\"thread_name\",\"args\":{\"name\":\"interrupts\"}},\n"
+                    "{\"pid\":1,\"tid\":1,\"ts\":0.000,\"ph\":\"B\",\"name\":\"loop\"},\n"
+                    "{\"pid\":1,\"tid\":1,\"ts\":10.000,\"ph\":\"C\",\"name\":\"rx \\\"level\\\"\",\"args\":{\"value\":42}},\n"
+                    "{\"pid\":1,\"tid\":2,\"ts\":15.000,\"ph\":\"B\",\"name\":\"USART1\"},\n"
+                    "{\"pid\":1,\"tid\":2,\"ts\":18.000,\"ph\":\"E\",\"name\":\"USART1\"},\n"
+                    "{\"pid\":1,\"tid\":1,\"ts\":18.000,\"ph\":\"i\",\"s\":\"t\",\"name\":\"wakeUp session 4\"},\n"
+                    "{\"pid\":1,\"tid\":1,\"ts\":20.000,\"ph\":\"E\",\"name\":\"loop\"}\n"
+                    "]}\n"),
+                json.str());
+}
+
+TEST_CASE(ringWrapKeepsRecordsAligned) {
+    setMillis(2000);
+    RingTraceSink<8> sink;
+    TraceDecoder decoder;
+    Tracer::begin(&sink);
+    drain(sink, decoder);
+    const uint32_t drops = sink.getDropCount();
+
+    // Three records per round do not divide the ring, so records are split at its end, and every drain of three
+    // words splits a record between two feeds of the decoder
+    for (uint16_t i = 0; i < 60; i += 3) {
+        for (uint16_t j = i; j < i + 3; j++) {
+            Tracer::counter(1, j);
+            spend(1);
+        }
+        drain(sink, decoder, 3);
+        drain(sink, decoder, 3);
+    }
+    CHECK_EQUAL(drops, sink.getDropCount());
+
+    // A full ring drops whole records
+    for (uint16_t j = 60; j < 65; j++) Tracer::counter(1, j);
+    CHECK_EQUAL(8U, sink.getLength());
+    CHECK_EQUAL(drops + 1, sink.getDropCount());
+    drain(sink, decoder);
+    Tracer::end();
+
+    CHECK_EQUAL(0U, decoder.getSkippedWords());
+    const auto &events = decoder.getEvents();
+    CHECK_EQUAL(64U, events.size());
+    for (size_t i = 0; i < events.size(); i++) CHECK_EQUAL(i, static_cast<size_t>(events[i].value));
+    CHECK_EQUAL(2000060000ULL, events[63].cycles);
+}
+
+TEST_CASE(decoderUnwrapsTimestamps) {
+    // The 32 bit timestamp of the host wraps after 4294.967296 ms
+    setMillis(4294);
+    RingTraceSink<16> sink;
+    Tracer::begin(&sink);
+    Tracer::zoneBegin(1);
+    spend(2000);
+    Tracer::zoneEnd(1);
+    Tracer::end();
+
+    TraceDecoder decoder;
+    drain(sink, decoder);
+    const auto &events = decoder.getEvents();
+    CHECK_EQUAL(2U, events.size());
+    CHECK_EQUAL(4294000000ULL, events[0].cycles);
+    CHECK_EQUAL(4296000000ULL, events[1].cycles);
+}
+
+TEST_CASE(decoderResynchronizesAfterLostWord) {
+    setMillis(5000);
+    RingTraceSink<16> sink;
+    Tracer::begin(&sink);
+    Tracer::counter(1, 1);
+    Tracer::counter(1, 2);
+    Tracer::counter(1, 3);
+    Tracer::end();
+
+    StringBuffer<128> out;
+    sink.drainTo(out);
+    // Lose the info word of the first counter record
+    const uint8_t *bytes = out.getReadPointer();
+    TraceDecoder decoder;
+    decoder.feedRaw(bytes, 12);
+    decoder.feedRaw(bytes + 16, out.getLength() - 16);
+    CHECK_EQUAL(1U, decoder.getSkippedWords());
+    const auto &events = decoder.getEvents();
+    CHECK_EQUAL(2U, events.size());
+    CHECK_EQUAL(2U, events[0].value);
+    CHECK_EQUAL(3U, events[1].value);
+}
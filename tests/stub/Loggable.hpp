@@ -0,0 +1,65 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef LIBSMART_STM32COMMON_TESTS_STUB_LOGGABLE_HPP
+#define LIBSMART_STM32COMMON_TESTS_STUB_LOGGABLE_HPP
+
+#include "Print.hpp"
+
+/**
+ * Stand-in for the part of libsmart Stm32ItmLogger that the stream sessions use. It discards all log output, so the
+ * stream session tests run without STM32COMMON_LOGGER_DIR.
+ */
+namespace Stm32ItmLogger {
+    class LoggerInterface : public Stm32Common::Print {
+    public:
+        enum class Severity {
+            EMERGENCY, ALERT, CRITICAL, ERROR, WARNING, NOTICE, INFORMATIONAL, DEBUGGING
+        };
+
+        LoggerInterface *setSeverity(Severity) { return this; }
+
+        using Print::write;
+
+        size_t write(uint8_t) override { return 1; }
+
+        size_t write(const uint8_t *, const size_t size) override { return size; }
+
+        size_t getWriteBuffer(uint8_t *&buffer) override {
+            buffer = nullptr;
+            return 0;
+        }
+
+        size_t setWrittenBytes(size_t) override { return 0; }
+
+        int availableForWrite() override { return INT16_MAX; }
+
+        void flush() override { ; }
+
+#ifdef LIBSMART_ENABLE_PRINTF
+        size_t printf(const char *, ...) PRINTF_OVERRIDE { return 0; }
+#endif
+    };
+
+
+    class Loggable {
+    public:
+        Loggable() = default;
+
+        explicit Loggable(LoggerInterface *logger) : logger(logger) { ; }
+
+        virtual ~Loggable() = default;
+
+        void setLogger(LoggerInterface *logger) { this->logger = logger; }
+
+        LoggerInterface *log() { return logger != nullptr ? logger : &nullLogger; }
+
+    private:
+        LoggerInterface *logger = nullptr;
+        inline static LoggerInterface nullLogger;
+    };
+}
+
+#endif
@@ -0,0 +1,155 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "ElfFile.hpp"
+#include <cstdlib>
+#include <cxxabi.h>
+#include <fstream>
+#include <iterator>
+
+using namespace Stm32Common::Tools;
+
+namespace {
+    constexpr uint32_t SHT_SYMTAB = 2;
+    constexpr uint16_t SHN_LORESERVE = 0xFF00;
+
+    /**
+     * Bounds checked little endian reads from the file image.
+     */
+    class Reader {
+    public:
+        explicit Reader(const std::vector<uint8_t> &image) : image(image) { ; }
+
+        [[nodiscard]] bool contains(const uint64_t offset, const uint64_t size) const {
+            return offset <= image.size() && size <= image.size() - offset;
+        }
+
+        [[nodiscard]] uint64_t read(const uint64_t offset, const size_t size) const {
+            if (!contains(offset, size)) return 0;
+            uint64_t value = 0;
+            for (size_t i = 0; i < size; i++) value |= static_cast<uint64_t>(image[offset + i]) << (8 * i);
+            return value;
+        }
+
+        [[nodiscard]] std::string readString(const uint64_t offset) const {
+            std::string text;
+            for (uint64_t i = offset; i < image.size() && image[i] != 0; i++) text += static_cast<char>(image[i]);
+            return text;
+        }
+
+    private:
+        const std::vector<uint8_t> &image;
+    };
+}
+
+bool ElfFile::load(const std::string &path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return fail("cannot open " + path);
+    const std::vector<uint8_t> image((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    return load(image);
+}
+
+bool ElfFile::load(const std::vector<uint8_t> &image) {
+    sections.clear();
+    symbols.clear();
+    error.clear();
+
+    const Reader reader(image);
+    if (!reader.contains(0, 16) || image[0] != 0x7F || image[1] != 'E' || image[2] != 'L' || image[3] != 'F') {
+        return fail("not an ELF file");
+    }
+    if (image[5] != 1) return fail("big endian ELF files are not supported");
+    elf64 = image[4] == 2;
+
+    // Offsets of the fields that differ between ELF32 and ELF64
+    const uint64_t sectionTable = reader.read(elf64 ? 0x28 : 0x20, elf64 ? 8 : 4);
+    const uint64_t sectionEntrySize = reader.read(elf64 ? 0x3A : 0x2E, 2);
+    const uint64_t sectionCount = reader.read(elf64 ? 0x3C : 0x30, 2);
+    const uint64_t sectionNameIndex = reader.read(elf64 ? 0x3E : 0x32, 2);
+    if (sectionEntrySize < (elf64 ? 64U : 40U) || !reader.contains(sectionTable, sectionEntrySize * sectionCount)) {
+        return fail("truncated section header table");
+    }
+
+    struct RawSection {
+        uint32_t name;
+        uint64_t offset;
+        uint32_t link;
+        uint64_t entrySize;
+    };
+    std::vector<RawSection> raw;
+    for (uint64_t i = 0; i < sectionCount; i++) {
+        const uint64_t header = sectionTable + i * sectionEntrySize;
+        Section section;
+        section.type = static_cast<uint32_t>(reader.read(header + 4, 4));
+        if (elf64) {
+            section.flags = reader.read(header + 8, 8);
+            section.address = reader.read(header + 16, 8);
+            section.size = reader.read(header + 32, 8);
+            raw.push_back({static_cast<uint32_t>(reader.read(header, 4)), reader.read(header + 24, 8),
+                           static_cast<uint32_t>(reader.read(header + 40, 4)), reader.read(header + 56, 8)});
+        } else {
+            section.flags = reader.read(header + 8, 4);
+            section.address = reader.read(header + 12, 4);
+            section.size = reader.read(header + 20, 4);
+            raw.push_back({static_cast<uint32_t>(reader.read(header, 4)), reader.read(header + 16, 4),
+                           static_cast<uint32_t>(reader.read(header + 24, 4)), reader.read(header + 36, 4)});
+        }
+        sections.push_back(section);
+    }
+    if (sectionNameIndex < sections.size()) {
+        const uint64_t names = raw[sectionNameIndex].offset;
+        for (size_t i = 0; i < sections.size(); i++) sections[i].name = reader.readString(names + raw[i].name);
+    }
+
+    for (size_t i = 0; i < sections.size(); i++) {
+        if (sections[i].type != SHT_SYMTAB || raw[i].link >= sections.size()) continue;
+        const uint64_t entrySize = raw[i].entrySize > 0 ? raw[i].entrySize : (elf64 ? 24 : 16);
+        const uint64_t strings = raw[raw[i].link].offset;
+        if (!reader.contains(raw[i].offset, sections[i].size)) return fail("truncated symbol table");
+        for (uint64_t entry = raw[i].offset; entry + entrySize <= raw[i].offset + sections[i].size;
+             entry += entrySize) {
+            Symbol symbol;
+            const auto name = static_cast<uint32_t>(reader.read(entry, 4));
+            uint8_t info;
+            if (elf64) {
+                info = static_cast<uint8_t>(reader.read(entry + 4, 1));
+                symbol.sectionIndex = static_cast<uint16_t>(reader.read(entry + 6, 2));
+                symbol.value = reader.read(entry + 8, 8);
+                symbol.size = reader.read(entry + 16, 8);
+            } else {
+                symbol.value = reader.read(entry + 4, 4);
+                symbol.size = reader.read(entry + 8, 4);
+                info = static_cast<uint8_t>(reader.read(entry + 12, 1));
+                symbol.sectionIndex = static_cast<uint16_t>(reader.read(entry + 14, 2));
+            }
+            if (name == 0) continue;
+            symbol.type = static_cast<SymbolType>(info & 0x0F);
+            symbol.name = reader.readString(strings + name);
+            symbols.push_back(symbol);
+        }
+    }
+    return true;
+}
+
+const ElfFile::Section *ElfFile::getSection(const Symbol &symbol) const {
+    if (symbol.sectionIndex == 0 || symbol.sectionIndex >= SHN_LORESERVE) return nullptr;
+    if (symbol.sectionIndex >= sections.size()) return nullptr;
+    return &sections[symbol.sectionIndex];
+}
+
+std::string ElfFile::demangle(const std::string &name) {
+    if (name.compare(0, 2, "_Z") != 0) return name;
+    int status = 0;
+    char *demangled = abi::__cxa_demangle(name.c_str(), nullptr, nullptr, &status);
+    if (status != 0 || demangled == nullptr) return name;
+    std::string result(demangled);
+    std::free(demangled);
+    return result;
+}
+
+bool ElfFile::fail(const std::string &message) {
+    error = message;
+    return false;
+}
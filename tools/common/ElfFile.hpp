@@ -0,0 +1,100 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef LIBSMART_STM32COMMON_TOOLS_ELFFILE_HPP
+#define LIBSMART_STM32COMMON_TOOLS_ELFFILE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Stm32Common::Tools {
+    /**
+     * @brief Reads the sections and the symbol table of a little endian ELF file, 32 or 64 bit.
+     *
+     * Works on linked firmware images as well as on object files. Debug information is not read.
+     */
+    class ElfFile {
+    public:
+        struct Section {
+            std::string name;
+            uint32_t type;
+            uint64_t flags;
+            uint64_t address;
+            uint64_t size;
+
+            [[nodiscard]] bool isAllocated() const { return (flags & 0x2) != 0; } // SHF_ALLOC
+
+            [[nodiscard]] bool isWritable() const { return (flags & 0x1) != 0; } // SHF_WRITE
+
+            [[nodiscard]] bool isNoBits() const { return type == 8; } // SHT_NOBITS
+
+            /**
+             * @brief Returns true if the section occupies flash: allocated and with contents.
+             */
+            [[nodiscard]] bool isInFlash() const { return isAllocated() && !isNoBits(); }
+
+            /**
+             * @brief Returns true if the section occupies RAM: allocated and writable.
+             */
+            [[nodiscard]] bool isInRam() const { return isAllocated() && isWritable(); }
+        };
+
+        enum class SymbolType : uint8_t {
+            NOTYPE = 0,
+            OBJECT = 1,
+            FUNC = 2,
+            SECTION = 3,
+            FILE = 4
+        };
+
+        struct Symbol {
+            std::string name;
+            uint64_t value;
+            uint64_t size;
+            SymbolType type;
+            uint16_t sectionIndex;
+        };
+
+        /**
+         * @brief Reads the file. Returns false and sets the error if it is not a readable ELF file.
+         */
+        bool load(const std::string &path);
+
+        /**
+         * @brief Reads an ELF image from memory.
+         */
+        bool load(const std::vector<uint8_t> &image);
+
+        [[nodiscard]] const std::vector<Section> &getSections() const { return sections; }
+
+        [[nodiscard]] const std::vector<Symbol> &getSymbols() const { return symbols; }
+
+        /**
+         * @brief Returns the section of a symbol, or nullptr for undefined, absolute and common symbols.
+         */
+        [[nodiscard]] const Section *getSection(const Symbol &symbol) const;
+
+        [[nodiscard]] bool is64Bit() const { return elf64; }
+
+        [[nodiscard]] const std::string &getError() const { return error; }
+
+        /**
+         * @brief Demangles a C++ symbol name. Other names are returned unchanged.
+         */
+        [[nodiscard]] static std::string demangle(const std::string &name);
+
+    private:
+        bool fail(const std::string &message);
+
+        std::vector<Section> sections;
+        std::vector<Symbol> symbols;
+        bool elf64 = false;
+        std::string error;
+    };
+}
+
+#endif
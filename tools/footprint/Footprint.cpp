@@ -0,0 +1,337 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "Footprint.hpp"
+#include <cstdio>
+#include <cstring>
+#include <regex>
+
+using namespace Stm32Common::Tools;
+
+namespace {
+    const std::string sizeofPrefix = "footprint_sizeof_";
+
+    std::string escape(const std::string &text) {
+        std::string escaped;
+        for (const char c: text) {
+            if (c == '"' || c == '\\') {
+                escaped += '\\';
+                escaped += c;
+            } else if (static_cast<unsigned char>(c) < 0x20) {
+                char code[8];
+                std::snprintf(code, sizeof(code), "\\u%04x", c);
+                escaped += code;
+            } else {
+                escaped += c;
+            }
+        }
+        return escaped;
+    }
+
+    bool contains(const Footprint::RegionUsage &region, const uint64_t address) {
+        return address >= region.origin && address - region.origin < region.length;
+    }
+
+    /**
+     * Sections without contents in flash. The map file does not tell, and ld prints a load address for them, too.
+     */
+    bool isNoBits(const std::string &outputSection) {
+        for (const char *prefix: {".bss", ".tbss", ".noinit", "._user_heap_stack", ".heap", ".stack"}) {
+            if (outputSection.compare(0, std::strlen(prefix), prefix) == 0) return true;
+        }
+        return false;
+    }
+
+    std::string getBaseName(const std::string &path) {
+        const size_t slash = path.find_last_of("/\\");
+        return slash == std::string::npos ? path : path.substr(slash + 1);
+    }
+
+    /**
+     * Removes the object and the source file extension: "Print.cpp.obj" -> "Print".
+     */
+    std::string stripExtensions(std::string path) {
+        for (const char *extension: {".obj", ".o", ".cpp", ".cc", ".c", ".s", ".S"}) {
+            const std::string suffix(extension);
+            if (path.size() > suffix.size() && path.compare(path.size() - suffix.size(), suffix.size(), suffix) == 0) {
+                path.erase(path.size() - suffix.size());
+            }
+        }
+        return path;
+    }
+
+    /**
+     * Splits a name at "::" outside of template arguments and parentheses.
+     */
+    std::vector<std::string> splitScopes(const std::string &name) {
+        std::vector<std::string> parts;
+        int depth = 0;
+        size_t start = 0;
+        for (size_t i = 0; i < name.size(); i++) {
+            const char c = name[i];
+            if (c == '<' || c == '(' || c == '{' || c == '[') depth++;
+            if (c == '>' || c == ')' || c == '}' || c == ']') depth--;
+            if (depth == 0 && c == ':' && i + 1 < name.size() && name[i + 1] == ':') {
+                parts.push_back(name.substr(start, i - start));
+                start = i + 2;
+                i++;
+            }
+        }
+        parts.push_back(name.substr(start));
+        return parts;
+    }
+
+    std::string stripTemplateArguments(const std::string &name) {
+        const size_t open = name.find('<');
+        return open == std::string::npos ? name : name.substr(0, open);
+    }
+
+    void writeUsages(std::ostream &out, const char *key, const std::map<std::string, Footprint::Usage> &usages) {
+        out << "  \"" << key << "\": [";
+        bool first = true;
+        for (const auto &[name, usage]: usages) {
+            out << (first ? "\n" : ",\n");
+            out << "    {\"name\": \"" << escape(name) << "\", \"flash\": " << usage.flash << ", \"ram\": "
+                << usage.ram << '}';
+            first = false;
+        }
+        out << (first ? "],\n" : "\n  ],\n");
+    }
+}
+
+void Footprint::addMap(const MapFile &map) {
+    haveMap = true;
+    total = {};
+    sections.clear();
+    components.clear();
+    memory.clear();
+    for (const MapFile::Region &region: map.getRegions()) {
+        memory.push_back({region.name, region.origin, region.length, 0});
+    }
+
+    for (const MapFile::InputSection &input: map.getInputSections()) {
+        Usage usage;
+        const MapFile::Region *region = map.findRegion(input.address);
+        const bool noBits = isNoBits(input.outputSection);
+        const bool copied = input.loadAddress != input.address && !noBits;
+        if (region == nullptr) {
+            // A map file without memory regions, e.g. of a host program
+            if (noBits) {
+                usage.ram = input.size;
+            } else if (input.outputSection.compare(0, 5, ".data") == 0) {
+                usage.flash = usage.ram = input.size;
+            } else {
+                usage.flash = input.size;
+            }
+        } else {
+            if (region->isWritable()) usage.ram = input.size;
+            else usage.flash = input.size;
+            // Initialised data is copied from flash at startup
+            const MapFile::Region *loadRegion = map.findRegion(input.loadAddress);
+            if (copied && loadRegion != nullptr && !loadRegion->isWritable()) usage.flash = input.size;
+        }
+
+        total.add(usage);
+        sections[input.outputSection].add(usage);
+        components[input.name == "*fill*" ? "(fill)" : getComponent(input.file)].add(usage);
+        for (RegionUsage &regionUsage: memory) {
+            if (contains(regionUsage, input.address) || (copied && contains(regionUsage, input.loadAddress))) {
+                regionUsage.used += input.size;
+            }
+        }
+    }
+}
+
+void Footprint::addElf(const ElfFile &elf, const bool withSymbols) {
+    if (!haveMap) {
+        total = {};
+        sections.clear();
+        for (const ElfFile::Section &section: elf.getSections()) {
+            if (!section.isAllocated() || section.size == 0) continue;
+            Usage usage;
+            if (section.isInFlash()) usage.flash = section.size;
+            if (section.isInRam()) usage.ram = section.size;
+            total.add(usage);
+            sections[section.name].add(usage);
+        }
+    }
+
+    for (const ElfFile::Symbol &symbol: elf.getSymbols()) {
+        if (symbol.size == 0) continue;
+        if (symbol.type != ElfFile::SymbolType::FUNC && symbol.type != ElfFile::SymbolType::OBJECT) continue;
+        const ElfFile::Section *section = elf.getSection(symbol);
+        if (section == nullptr || !section->isAllocated()) continue;
+
+        Usage usage;
+        if (section->isInFlash()) usage.flash = symbol.size;
+        if (section->isInRam()) usage.ram = symbol.size;
+        const std::string name = ElfFile::demangle(symbol.name);
+        scopes[getScope(name)].add(usage);
+        if (withSymbols) symbols[name].add(usage);
+    }
+}
+
+void Footprint::addSizes(const ElfFile &object) {
+    for (const ElfFile::Symbol &symbol: object.getSymbols()) {
+        if (symbol.name.compare(0, sizeofPrefix.size(), sizeofPrefix) != 0) continue;
+        sizes[symbol.name.substr(sizeofPrefix.size())] = symbol.size;
+    }
+}
+
+void Footprint::writeJson(std::ostream &out) const {
+    out << "{\n";
+    out << "  \"memory\": [";
+    for (size_t i = 0; i < memory.size(); i++) {
+        out << (i == 0 ? "\n" : ",\n");
+        out << "    {\"name\": \"" << escape(memory[i].name) << "\", \"origin\": " << memory[i].origin
+            << ", \"length\": " << memory[i].length << ", \"used\": " << memory[i].used << '}';
+    }
+    out << (memory.empty() ? "],\n" : "\n  ],\n");
+    out << "  \"totals\": {\"flash\": " << total.flash << ", \"ram\": " << total.ram << "},\n";
+    writeUsages(out, "sections", sections);
+    writeUsages(out, "components", components);
+    writeUsages(out, "scopes", scopes);
+    writeUsages(out, "symbols", symbols);
+    out << "  \"sizes\": [";
+    bool first = true;
+    for (const auto &[name, size]: sizes) {
+        out << (first ? "\n" : ",\n");
+        out << "    {\"name\": \"" << escape(name) << "\", \"size\": " << size << '}';
+        first = false;
+    }
+    out << (first ? "]\n" : "\n  ]\n");
+    out << "}\n";
+}
+
+std::vector<Footprint::Regression> Footprint::compare(std::istream &baseline, const uint64_t tolerance) const {
+    // Current values by "list/name/field", in the escaped form of the JSON output
+    std::map<std::string, uint64_t> current;
+    current["totals/flash"] = total.flash;
+    current["totals/ram"] = total.ram;
+    const std::pair<const char *, const std::map<std::string, Usage> *> lists[] = {
+        {"sections", &sections}, {"components", &components}, {"scopes", &scopes}, {"symbols", &symbols}
+    };
+    for (const auto &[list, usages]: lists) {
+        for (const auto &[name, usage]: *usages) {
+            current[std::string(list) + "/" + escape(name) + "/flash"] = usage.flash;
+            current[std::string(list) + "/" + escape(name) + "/ram"] = usage.ram;
+        }
+    }
+    for (const auto &[name, size]: sizes) current["sizes/" + escape(name) + "/size"] = size;
+
+    static const std::regex listPattern(R"re(^\s*"(\w+)": \[)re");
+    static const std::regex totalsPattern(R"re("totals": \{"flash": (\d+), "ram": (\d+)\})re");
+    static const std::regex usagePattern(R"re(\{"name": "((?:[^"\\]|\\.)*)", "flash": (\d+), "ram": (\d+)\})re");
+    static const std::regex sizePattern(R"re(\{"name": "((?:[^"\\]|\\.)*)", "size": (\d+)\})re");
+
+    std::map<std::string, uint64_t> before;
+    bool baselineHasSymbols = false;
+    std::string list;
+    std::string line;
+    std::smatch match;
+    while (std::getline(baseline, line)) {
+        if (std::regex_search(line, match, listPattern)) list = match[1];
+        if (std::regex_search(line, match, totalsPattern)) {
+            before["totals/flash"] = std::stoull(match[1]);
+            before["totals/ram"] = std::stoull(match[2]);
+        } else if (std::regex_search(line, match, usagePattern)) {
+            if (list == "symbols") baselineHasSymbols = true;
+            before[list + "/" + match[1].str() + "/flash"] = std::stoull(match[2]);
+            before[list + "/" + match[1].str() + "/ram"] = std::stoull(match[3]);
+        } else if (std::regex_search(line, match, sizePattern)) {
+            before[list + "/" + match[1].str() + "/size"] = std::stoull(match[2]);
+        }
+    }
+
+    std::vector<Regression> regressions;
+    for (const auto &[entry, after]: current) {
+        // Symbols are only compared if the baseline lists them
+        if (entry.compare(0, 8, "symbols/") == 0 && !baselineHasSymbols) continue;
+        const auto found = before.find(entry);
+        const uint64_t old = found == before.end() ? 0 : found->second;
+        if (after > old + tolerance) regressions.push_back({entry, old, after});
+    }
+    return regressions;
+}
+
+std::string Footprint::getComponent(const std::string &file) {
+    if (file.empty()) return "(linker)";
+
+    // Archive member: "/usr/lib/.../libc_nano.a(lib_a-memcpy.o)"
+    const size_t open = file.find('(');
+    if (open != std::string::npos && file.back() == ')') {
+        const std::string archive = getBaseName(file.substr(0, open));
+        if (archive.find("stm32common") == std::string::npos) return archive;
+        return "Stm32Common/" + stripExtensions(file.substr(open + 1, file.size() - open - 2));
+    }
+
+    std::string path = file;
+    for (char &c: path) {
+        if (c == '\\') c = '/';
+    }
+    const size_t src = path.rfind("/src/");
+    if (src != std::string::npos) return "Stm32Common/" + stripExtensions(path.substr(src + 5));
+    if (path.compare(0, 4, "src/") == 0) return "Stm32Common/" + stripExtensions(path.substr(4));
+    if (path.find("Drivers/CMSIS") != std::string::npos) return "CMSIS";
+    if (path.find("Drivers/STM32") != std::string::npos) return "HAL";
+
+    // Relative to the project: "CMakeFiles/<target>.dir/Core/Src/main.c.obj" or "./Core/Src/main.o"
+    const size_t dir = path.find(".dir/");
+    if (dir != std::string::npos) path = path.substr(dir + 5);
+    while (path.compare(0, 2, "./") == 0) path = path.substr(2);
+    const size_t slash = path.find('/');
+    if (slash == std::string::npos || slash == 0) return stripExtensions(getBaseName(path));
+    return path.substr(0, slash);
+}
+
+std::string Footprint::getScope(const std::string &name) {
+    std::string scoped = name;
+    // "vtable for X" and friends belong to the class X itself
+    for (const char *prefix: {"vtable for ", "construction vtable for ", "VTT for ", "typeinfo for ",
+                              "typeinfo name for "}) {
+        const std::string text(prefix);
+        if (scoped.compare(0, text.size(), text) == 0) {
+            scoped = scoped.substr(text.size()) + "::";
+            break;
+        }
+    }
+    for (const char *prefix: {"non-virtual thunk to ", "virtual thunk to ", "guard variable for "}) {
+        const std::string text(prefix);
+        if (scoped.compare(0, text.size(), text) == 0) scoped = scoped.substr(text.size());
+    }
+
+    // Cut the parameter list and operator names, which may contain brackets themselves
+    const size_t op = scoped.find("::operator");
+    if (op != std::string::npos) scoped = scoped.substr(0, op + 2);
+    int depth = 0;
+    size_t nameStart = 0;
+    for (size_t i = 0; i < scoped.size(); i++) {
+        const char c = scoped[i];
+        if (c == '<') depth++;
+        if (c == '>') depth--;
+        if (depth == 0 && c == ' ') nameStart = i + 1; // Return type of a function template
+        if (depth == 0 && c == '(') {
+            scoped = scoped.substr(0, i);
+            break;
+        }
+    }
+    scoped = scoped.substr(nameStart);
+
+    std::vector<std::string> parts = splitScopes(scoped);
+    if (parts.size() < 2) return "(global)";
+    parts.pop_back();
+
+    if (parts[0] == "std" || parts[0] == "__gnu_cxx") {
+        std::string part = parts.size() > 1 ? parts[1] : "";
+        if ((part == "__cxx11" || part == "__1") && parts.size() > 2) part = parts[2];
+        part = stripTemplateArguments(part);
+        if (part.compare(0, 9, "_Function") == 0 || part == "function") return "std::function";
+        return part.empty() ? parts[0] : parts[0] + "::" + part;
+    }
+
+    std::string scope = parts[0];
+    for (size_t i = 1; i < parts.size(); i++) scope += "::" + parts[i];
+    return scope;
+}
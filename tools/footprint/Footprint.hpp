@@ -0,0 +1,111 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef LIBSMART_STM32COMMON_TOOLS_FOOTPRINT_HPP
+#define LIBSMART_STM32COMMON_TOOLS_FOOTPRINT_HPP
+
+#include <cstdint>
+#include <istream>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "ElfFile.hpp"
+#include "MapFile.hpp"
+
+namespace Stm32Common::Tools {
+    /**
+     * @brief Attributes flash and RAM of a firmware image to components, sections and symbol scopes.
+     *
+     * - The map file gives the memory regions, the output sections and the components. A component is the library
+     *   source file ("Stm32Common/Print"), a vendor directory ("HAL", "Core") or an archive ("libc_nano.a").
+     * - The ELF file gives the scopes, i.e. the class or namespace of every symbol, e.g.
+     *   "Stm32Common::StringBuffer<256u>" or "std::function". Template instantiations are found this way,
+     *   wherever they have been instantiated.
+     * - Object files compiled from SizeProbe.cpp give the sizeof table.
+     *
+     * The JSON output is sorted by name with one entry per line, so two reports can be compared with diff.
+     */
+    class Footprint {
+    public:
+        struct Usage {
+            uint64_t flash = 0;
+            uint64_t ram = 0;
+
+            void add(const Usage &usage) {
+                flash += usage.flash;
+                ram += usage.ram;
+            }
+        };
+
+        struct RegionUsage {
+            std::string name;
+            uint64_t origin;
+            uint64_t length;
+            uint64_t used;
+        };
+
+        struct Regression {
+            std::string entry;
+            uint64_t before;
+            uint64_t after;
+        };
+
+        /**
+         * @brief Adds the sections of a map file. Sets the totals, the sections, the memory and the components.
+         */
+        void addMap(const MapFile &map);
+
+        /**
+         * @brief Adds the symbols of an ELF file to the scopes, and to the symbols if withSymbols is true. Sets the
+         * totals and the sections, unless a map file has been added.
+         */
+        void addElf(const ElfFile &elf, bool withSymbols = false);
+
+        /**
+         * @brief Adds the "footprint_sizeof_" symbols of an object file compiled from SizeProbe.cpp.
+         */
+        void addSizes(const ElfFile &object);
+
+        [[nodiscard]] const Usage &getTotal() const { return total; }
+
+        [[nodiscard]] const std::map<std::string, Usage> &getComponents() const { return components; }
+
+        [[nodiscard]] const std::map<std::string, Usage> &getScopes() const { return scopes; }
+
+        [[nodiscard]] const std::map<std::string, uint64_t> &getSizes() const { return sizes; }
+
+        void writeJson(std::ostream &out) const;
+
+        /**
+         * @brief Compares the report with a baseline written by writeJson().
+         *
+         * @return The totals, sections, components, scopes and sizes that have grown by more than tolerance bytes.
+         */
+        [[nodiscard]] std::vector<Regression> compare(std::istream &baseline, uint64_t tolerance) const;
+
+        /**
+         * @brief Returns the component of an object file name of the map file.
+         */
+        [[nodiscard]] static std::string getComponent(const std::string &file);
+
+        /**
+         * @brief Returns the class or namespace of a demangled symbol name.
+         */
+        [[nodiscard]] static std::string getScope(const std::string &name);
+
+    private:
+        bool haveMap = false;
+        Usage total;
+        std::vector<RegionUsage> memory;
+        std::map<std::string, Usage> sections;
+        std::map<std::string, Usage> components;
+        std::map<std::string, Usage> scopes;
+        std::map<std::string, Usage> symbols;
+        std::map<std::string, uint64_t> sizes;
+    };
+}
+
+#endif
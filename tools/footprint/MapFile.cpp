@@ -0,0 +1,148 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "MapFile.hpp"
+#include <fstream>
+#include <sstream>
+
+using namespace Stm32Common::Tools;
+
+namespace {
+    bool isHex(const std::string &token) {
+        return token.size() > 2 && token[0] == '0' && (token[1] == 'x' || token[1] == 'X');
+    }
+
+    uint64_t parseHex(const std::string &token) {
+        return std::stoull(token, nullptr, 16);
+    }
+
+    std::vector<std::string> split(const std::string &line) {
+        std::istringstream in(line);
+        std::vector<std::string> tokens;
+        std::string token;
+        while (in >> token) tokens.push_back(token);
+        return tokens;
+    }
+
+    std::string trimRight(const std::string &text) {
+        const size_t end = text.find_last_not_of(" \t\r");
+        return end == std::string::npos ? std::string() : text.substr(0, end + 1);
+    }
+}
+
+bool MapFile::load(const std::string &path) {
+    std::ifstream in(path);
+    return in && load(in);
+}
+
+bool MapFile::load(std::istream &in) {
+    regions.clear();
+    inputSections.clear();
+    outputSection.clear();
+
+    enum { PREAMBLE, MEMORY, SECTIONS } part = PREAMBLE;
+    std::string line;
+    std::string pendingName; // Input or output section whose name filled the line
+    bool pendingIsOutput = false;
+
+    while (std::getline(in, line)) {
+        line = trimRight(line);
+        if (line == "Memory Configuration") {
+            part = MEMORY;
+            continue;
+        }
+        if (line == "Linker script and memory map") {
+            part = SECTIONS;
+            continue;
+        }
+
+        if (part == MEMORY) {
+            const std::vector<std::string> tokens = split(line);
+            if (tokens.size() >= 3 && isHex(tokens[1]) && isHex(tokens[2]) && tokens[0] != "*default*") {
+                regions.push_back({tokens[0], parseHex(tokens[1]), parseHex(tokens[2]),
+                                   tokens.size() > 3 ? tokens[3] : ""});
+            }
+            continue;
+        }
+        if (part != SECTIONS || line.empty()) continue;
+
+        // The address and size of a section with a long name follow on the next line
+        if (!pendingName.empty()) {
+            const std::string name = pendingName;
+            pendingName.clear();
+            if (line[0] == ' ' && isHex(split(line)[0])) {
+                if (pendingIsOutput) {
+                    line = name + " " + line;
+                } else {
+                    addInputSection(name, line);
+                    continue;
+                }
+            }
+        }
+
+        if (line[0] != ' ') {
+            // Output section: ".text 0x08000110 0x5d2c" or ".data 0x20000000 0xc load address 0x08005e40"
+            const std::vector<std::string> tokens = split(line);
+            if (tokens.size() == 1) {
+                if (tokens[0][0] == '.') {
+                    pendingName = tokens[0];
+                    pendingIsOutput = true;
+                } else {
+                    outputSection.clear(); // e.g. /DISCARD/
+                }
+                continue;
+            }
+            if (tokens.size() < 3 || !isHex(tokens[1])) continue;
+            outputSection = tokens[0];
+            outputAddress = parseHex(tokens[1]);
+            outputLoadAddress = outputAddress;
+            if (tokens.size() >= 6 && tokens[3] == "load" && tokens[4] == "address" && isHex(tokens[5])) {
+                outputLoadAddress = parseHex(tokens[5]);
+            }
+            continue;
+        }
+
+        // Input section: " .text.name 0x08000150 0x1c file.o", " *fill* 0x0800016c 0x4" or " .text.long_name"
+        if (line.size() < 2 || line[1] == ' ' || outputSection.empty()) continue;
+        const size_t nameEnd = line.find(' ', 1);
+        const std::string name = line.substr(1, nameEnd == std::string::npos ? std::string::npos : nameEnd - 1);
+        if (name[0] == '*' && name != "*fill*") continue; // Linker script pattern, e.g. " *(.text*)"
+        if (nameEnd == std::string::npos) {
+            pendingName = name;
+            pendingIsOutput = false;
+            continue;
+        }
+        addInputSection(name, line.substr(nameEnd));
+    }
+    return true;
+}
+
+void MapFile::addInputSection(const std::string &name, const std::string &fields) {
+    std::vector<std::string> tokens = split(fields);
+    if (tokens.size() < 2 || !isHex(tokens[0]) || !isHex(tokens[1])) return;
+
+    InputSection section;
+    section.outputSection = outputSection;
+    section.name = name;
+    section.address = parseHex(tokens[0]);
+    section.size = parseHex(tokens[1]);
+    section.loadAddress = section.address - outputAddress + outputLoadAddress;
+    // The file name may contain spaces
+    const size_t fileStart = fields.find(tokens[1]) + tokens[1].size();
+    const size_t first = fields.find_first_not_of(' ', fileStart);
+    if (first != std::string::npos) section.file = fields.substr(first);
+
+    if (section.size == 0) return;
+    // Without memory regions, output sections at address 0 are not loaded, e.g. .comment
+    if (regions.empty() ? outputAddress == 0 : findRegion(section.address) == nullptr) return;
+    inputSections.push_back(section);
+}
+
+const MapFile::Region *MapFile::findRegion(const uint64_t address) const {
+    for (const Region &region: regions) {
+        if (region.contains(address)) return &region;
+    }
+    return nullptr;
+}
@@ -0,0 +1,71 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef LIBSMART_STM32COMMON_TOOLS_MAPFILE_HPP
+#define LIBSMART_STM32COMMON_TOOLS_MAPFILE_HPP
+
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <vector>
+
+namespace Stm32Common::Tools {
+    /**
+     * @brief Reads the memory regions and the input sections of a GNU ld map file (-Wl,-Map=...).
+     *
+     * Discarded input sections and sections outside the memory regions, e.g. debug information, are ignored.
+     */
+    class MapFile {
+    public:
+        struct Region {
+            std::string name;
+            uint64_t origin;
+            uint64_t length;
+            std::string attributes;
+
+            [[nodiscard]] bool contains(const uint64_t address) const {
+                return address >= origin && address - origin < length;
+            }
+
+            /**
+             * @brief Returns true for writable regions, i.e. RAM. Other regions count as flash.
+             */
+            [[nodiscard]] bool isWritable() const { return attributes.find('w') != std::string::npos; }
+        };
+
+        struct InputSection {
+            std::string outputSection;
+            std::string name; // e.g. ".text._ZN11Stm32Common5Print5writeEh", "*fill*" or "COMMON"
+            uint64_t address;
+            uint64_t loadAddress; // Equal to the address, unless the output section is copied at startup
+            uint64_t size;
+            std::string file; // Object file or "archive.a(member.o)", empty for fill and linker generated data
+        };
+
+        bool load(const std::string &path);
+
+        bool load(std::istream &in);
+
+        [[nodiscard]] const std::vector<Region> &getRegions() const { return regions; }
+
+        [[nodiscard]] const std::vector<InputSection> &getInputSections() const { return inputSections; }
+
+        /**
+         * @brief Returns the region that contains the address, or nullptr.
+         */
+        [[nodiscard]] const Region *findRegion(uint64_t address) const;
+
+    private:
+        void addInputSection(const std::string &name, const std::string &fields);
+
+        std::vector<Region> regions;
+        std::vector<InputSection> inputSections;
+        std::string outputSection;
+        uint64_t outputAddress = 0;
+        uint64_t outputLoadAddress = 0;
+    };
+}
+
+#endif
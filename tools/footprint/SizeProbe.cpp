@@ -0,0 +1,50 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * The sizeof table of footprint. Compile this file with the compiler and flags of the firmware, e.g.
+ *
+ * arm-none-eabi-g++ -std=c++17 -mcpu=cortex-m3 -mthumb -fno-rtti -DSTM32F103xB -DUSE_HAL_DRIVER -I... -c
+ *     SizeProbe.cpp -o SizeProbe.o
+ *
+ * and pass the object file with --sizes. Every probe is an array with the size of the type, so the sizes are read
+ * from the symbol table of the object file without running code on the target.
+ */
+
+#include <functional>
+#include "DeferredCallQueue.hpp"
+#include "LatencyHistogram.hpp"
+#include "RingBuffer.hpp"
+#include "RunEvery.hpp"
+#include "Scheduler.hpp"
+#include "StackMonitor.hpp"
+#include "StaticString.hpp"
+#include "StreamRxTx.hpp"
+#include "StringBuffer.hpp"
+#include "Trace.hpp"
+
+#define FOOTPRINT_SIZEOF(name, ...) \
+    extern "C" const char footprint_sizeof_##name[sizeof(__VA_ARGS__)]; \
+    extern "C" const char footprint_sizeof_##name[sizeof(__VA_ARGS__)] = {1}
+
+using namespace Stm32Common;
+
+FOOTPRINT_SIZEOF(StringBuffer_64, StringBuffer<64>);
+FOOTPRINT_SIZEOF(StringBuffer_256, StringBuffer<256>);
+FOOTPRINT_SIZEOF(StringBuffer_1024, StringBuffer<1024>);
+FOOTPRINT_SIZEOF(StreamRxTx_64_64, StreamRxTx<64, 64>);
+FOOTPRINT_SIZEOF(StreamRxTx_256_256, StreamRxTx<256, 256>);
+FOOTPRINT_SIZEOF(RingBuffer_uint8_64, RingBuffer<uint8_t, 64>);
+FOOTPRINT_SIZEOF(RingBuffer_uint32_16, RingBuffer<uint32_t, 16>);
+FOOTPRINT_SIZEOF(StaticString_32, StaticString<32>);
+FOOTPRINT_SIZEOF(StaticString_128, StaticString<128>);
+FOOTPRINT_SIZEOF(Scheduler_8, Scheduler<8>);
+FOOTPRINT_SIZEOF(Scheduler_16, Scheduler<16>);
+FOOTPRINT_SIZEOF(DeferredCallQueue_8, DeferredCallQueue<8>);
+FOOTPRINT_SIZEOF(LatencyHistogram_3_28, LatencyHistogram<>);
+FOOTPRINT_SIZEOF(RingTraceSink_256, RingTraceSink<256>);
+FOOTPRINT_SIZEOF(StackMonitor_4, StackMonitor<4>);
+FOOTPRINT_SIZEOF(RunEvery, RunEvery);
+FOOTPRINT_SIZEOF(std_function, std::function<void()>);
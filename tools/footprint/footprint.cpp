@@ -0,0 +1,115 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * Attributes flash and RAM of a firmware image to library components, sections and symbol scopes.
+ *
+ * Usage: footprint [--map FILE] [--elf FILE] [--sizes OBJECT]... [--symbols] [--baseline FILE] [--tolerance BYTES]
+ *                  [--output FILE]
+ *
+ * Example for the build output of examples/stm32f1_blinker:
+ *
+ * footprint --map build/stm32f1_blinker.map --elf build/stm32f1_blinker.elf --output footprint.json
+ *
+ * With --baseline, the report is compared with an earlier report. Every total, section, component, scope or size
+ * that has grown by more than the tolerance (default 0 bytes) is listed on stderr and the exit code is 1.
+ */
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "Footprint.hpp"
+
+using namespace Stm32Common::Tools;
+
+namespace {
+    int usage() {
+        std::cerr << "Usage: footprint [--map FILE] [--elf FILE] [--sizes OBJECT]... [--symbols] [--baseline FILE] "
+                "[--tolerance BYTES] [--output FILE]\n";
+        return 2;
+    }
+}
+
+int main(const int argc, char *argv[]) {
+    const char *mapPath = nullptr;
+    const char *elfPath = nullptr;
+    const char *baselinePath = nullptr;
+    const char *outputPath = nullptr;
+    std::vector<const char *> sizePaths;
+    bool withSymbols = false;
+    uint64_t tolerance = 0;
+
+    for (int i = 1; i < argc; i++) {
+        const bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--map") == 0 && hasValue) {
+            mapPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--elf") == 0 && hasValue) {
+            elfPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--sizes") == 0 && hasValue) {
+            sizePaths.push_back(argv[++i]);
+        } else if (std::strcmp(argv[i], "--symbols") == 0) {
+            withSymbols = true;
+        } else if (std::strcmp(argv[i], "--baseline") == 0 && hasValue) {
+            baselinePath = argv[++i];
+        } else if (std::strcmp(argv[i], "--tolerance") == 0 && hasValue) {
+            tolerance = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--output") == 0 && hasValue) {
+            outputPath = argv[++i];
+        } else {
+            return usage();
+        }
+    }
+    if (mapPath == nullptr && elfPath == nullptr && sizePaths.empty()) return usage();
+
+    Footprint footprint;
+    if (mapPath != nullptr) {
+        MapFile map;
+        if (!map.load(mapPath)) {
+            std::cerr << "footprint: cannot open " << mapPath << '\n';
+            return 1;
+        }
+        footprint.addMap(map);
+    }
+    if (elfPath != nullptr) {
+        ElfFile elf;
+        if (!elf.load(elfPath)) {
+            std::cerr << "footprint: " << elfPath << ": " << elf.getError() << '\n';
+            return 1;
+        }
+        footprint.addElf(elf, withSymbols);
+    }
+    for (const char *path: sizePaths) {
+        ElfFile object;
+        if (!object.load(path)) {
+            std::cerr << "footprint: " << path << ": " << object.getError() << '\n';
+            return 1;
+        }
+        footprint.addSizes(object);
+    }
+
+    if (outputPath != nullptr) {
+        std::ofstream out(outputPath);
+        footprint.writeJson(out);
+    } else {
+        footprint.writeJson(std::cout);
+    }
+    std::cerr << "flash " << footprint.getTotal().flash << " B, ram " << footprint.getTotal().ram << " B\n";
+
+    if (baselinePath == nullptr) return 0;
+    std::ifstream baseline(baselinePath);
+    if (!baseline) {
+        std::cerr << "footprint: cannot open " << baselinePath << '\n';
+        return 1;
+    }
+    const std::vector<Footprint::Regression> regressions = footprint.compare(baseline, tolerance);
+    for (const Footprint::Regression &regression: regressions) {
+        std::cerr << regression.entry << ": " << regression.before << " -> " << regression.after << " (+"
+                << regression.after - regression.before << ")\n";
+    }
+    return regressions.empty() ? 0 : 1;
+}
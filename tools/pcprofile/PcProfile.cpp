@@ -0,0 +1,191 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "PcProfile.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <sstream>
+
+using namespace Stm32Common::Tools;
+
+namespace {
+    const char *const outsideName = "(outside flash)";
+    const char *const unknownName = "(unknown)";
+
+    std::string escape(const std::string &text) {
+        std::string escaped;
+        for (const char c: text) {
+            if (c == '"' || c == '\\') {
+                escaped += '\\';
+                escaped += c;
+            } else if (static_cast<unsigned char>(c) < 0x20) {
+                char code[8];
+                std::snprintf(code, sizeof(code), "\\u%04x", c);
+                escaped += code;
+            } else {
+                escaped += c;
+            }
+        }
+        return escaped;
+    }
+
+    bool parseNumber(const std::string &text, const int radix, uint64_t &value) {
+        if (text.empty()) return false;
+        char *end = nullptr;
+        value = std::strtoull(text.c_str(), &end, radix);
+        return *end == '\0';
+    }
+
+    std::vector<std::string> split(const std::string &line) {
+        std::istringstream in(line);
+        std::vector<std::string> tokens;
+        std::string token;
+        while (in >> token) tokens.push_back(token);
+        return tokens;
+    }
+
+    double percent(const uint64_t part, const uint64_t total) {
+        return total > 0 ? 100.0 * static_cast<double>(part) / static_cast<double>(total) : 0.0;
+    }
+}
+
+void SymbolTable::load(const ElfFile &elf) {
+    for (const ElfFile::Symbol &symbol: elf.getSymbols()) {
+        if (symbol.type != ElfFile::SymbolType::FUNC || elf.getSection(symbol) == nullptr) continue;
+        add(ElfFile::demangle(symbol.name), symbol.value & ~1ULL, symbol.size);
+    }
+}
+
+void SymbolTable::add(const std::string &name, const uint64_t address, const uint64_t size) {
+    const auto position = std::lower_bound(functions.begin(), functions.end(), address,
+                                           [](const Function &function, const uint64_t value) {
+                                               return function.address < value;
+                                           });
+    // Aliases share the address, the first name wins
+    if (position != functions.end() && position->address == address) return;
+    functions.insert(position, {name, address, size});
+}
+
+const SymbolTable::Function *SymbolTable::find(const uint64_t address) const {
+    const auto next = std::upper_bound(functions.begin(), functions.end(), address,
+                                       [](const uint64_t value, const Function &function) {
+                                           return value < function.address;
+                                       });
+    if (next == functions.begin()) return nullptr;
+    const Function &function = *(next - 1);
+    if (function.size > 0) return address - function.address < function.size ? &function : nullptr;
+    return next == functions.end() || address < next->address ? &function : nullptr;
+}
+
+const SymbolTable::Function *SymbolTable::findFirst(const uint64_t begin, const uint64_t end) const {
+    const auto first = std::lower_bound(functions.begin(), functions.end(), begin,
+                                        [](const Function &function, const uint64_t value) {
+                                            return function.address < value;
+                                        });
+    return first != functions.end() && first->address < end ? &*first : nullptr;
+}
+
+
+bool PcProfile::fail(const std::string &message) {
+    error = message;
+    return false;
+}
+
+bool PcProfile::parse(std::istream &in) {
+    buckets.clear();
+    entries.clear();
+    error.clear();
+    bool inDump = false;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (!inDump) {
+            const size_t header = line.find("pcsampler ");
+            if (header == std::string::npos) continue;
+            base = bucketShift = scaleShift = rate = samples = other = 0;
+            for (const std::string &token: split(line.substr(header + 10))) {
+                const size_t equals = token.find('=');
+                if (equals == std::string::npos) continue;
+                const std::string key = token.substr(0, equals);
+                uint64_t value = 0;
+                if (!parseNumber(token.substr(equals + 1), 0, value)) return fail("invalid header: " + line);
+                if (key == "base") base = value;
+                else if (key == "shift") bucketShift = static_cast<unsigned int>(value);
+                else if (key == "scale") scaleShift = static_cast<unsigned int>(value);
+                else if (key == "rate") rate = value;
+                else if (key == "samples") samples = value;
+                else if (key == "other") other = value;
+            }
+            if (bucketShift >= 32 || scaleShift >= 32) return fail("invalid header: " + line);
+            inDump = true;
+            continue;
+        }
+
+        // The dump lines may carry a prefix, e.g. a log tag, so only the last tokens are significant
+        const std::vector<std::string> tokens = split(line);
+        if (tokens.empty()) continue;
+        if (tokens.back() == "end") return true;
+        if (tokens.size() < 2) continue;
+        Bucket bucket{};
+        if (!parseNumber(tokens[tokens.size() - 2], 16, bucket.address)) continue;
+        if (!parseNumber(tokens.back(), 10, bucket.count)) continue;
+        buckets.push_back(bucket);
+    }
+    return fail(inDump ? "dump without end" : "no pcsampler dump found");
+}
+
+void PcProfile::symbolize(const SymbolTable &symbols) {
+    std::map<std::string, uint64_t> samplesByName;
+    const uint64_t bucketSize = getBucketSize();
+    for (const Bucket &bucket: buckets) {
+        const SymbolTable::Function *function = symbols.find(bucket.address);
+        if (function == nullptr) function = symbols.findFirst(bucket.address, bucket.address + bucketSize);
+        samplesByName[function != nullptr ? function->name : unknownName] += bucket.count << scaleShift;
+    }
+    if (other > 0) samplesByName[outsideName] += other;
+
+    entries.clear();
+    for (const auto &[name, count]: samplesByName) entries.push_back({name, count});
+    std::stable_sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b) {
+        return a.samples > b.samples;
+    });
+}
+
+void PcProfile::writeText(std::ostream &out) const {
+    uint64_t total = 0;
+    for (const Entry &entry: entries) total += entry.samples;
+    out << "samples " << samples << ", rate " << rate << " Hz, bucket " << getBucketSize() << " B, scale "
+            << (1ULL << scaleShift) << '\n';
+    out << "      %    samples  function\n";
+    for (const Entry &entry: entries) {
+        char columns[32];
+        std::snprintf(columns, sizeof(columns), "%7.2f %10llu  ", percent(entry.samples, total),
+                      static_cast<unsigned long long>(entry.samples));
+        out << columns << entry.name << '\n';
+    }
+}
+
+void PcProfile::writeJson(std::ostream &out) const {
+    uint64_t total = 0;
+    for (const Entry &entry: entries) total += entry.samples;
+    out << "{\n";
+    out << "  \"samples\": " << samples << ",\n";
+    out << "  \"rate\": " << rate << ",\n";
+    out << "  \"bucket_size\": " << getBucketSize() << ",\n";
+    out << "  \"scale\": " << (1ULL << scaleShift) << ",\n";
+    out << "  \"functions\": [";
+    bool first = true;
+    for (const Entry &entry: entries) {
+        char share[16];
+        std::snprintf(share, sizeof(share), "%.2f", percent(entry.samples, total));
+        out << (first ? "\n" : ",\n");
+        out << "    {\"name\": \"" << escape(entry.name) << "\", \"samples\": " << entry.samples << ", \"percent\": "
+                << share << '}';
+        first = false;
+    }
+    out << (first ? "]\n" : "\n  ]\n");
+    out << "}\n";
+}
@@ -0,0 +1,125 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef LIBSMART_STM32COMMON_TOOLS_PCPROFILE_HPP
+#define LIBSMART_STM32COMMON_TOOLS_PCPROFILE_HPP
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "ElfFile.hpp"
+
+namespace Stm32Common::Tools {
+    /**
+     * @brief The functions of a firmware image, sorted by address.
+     */
+    class SymbolTable {
+    public:
+        struct Function {
+            std::string name;
+            uint64_t address;
+            uint64_t size;
+        };
+
+        /**
+         * @brief Adds the function symbols of an ELF file. The Thumb bit of the addresses is cleared and the names
+         * are demangled.
+         */
+        void load(const ElfFile &elf);
+
+        /**
+         * @brief Adds a function. A size of 0 means the function extends to the next one.
+         */
+        void add(const std::string &name, uint64_t address, uint64_t size);
+
+        /**
+         * @brief Returns the function containing the address, or nullptr.
+         */
+        [[nodiscard]] const Function *find(uint64_t address) const;
+
+        /**
+         * @brief Returns the first function starting in [begin, end), or nullptr.
+         */
+        [[nodiscard]] const Function *findFirst(uint64_t begin, uint64_t end) const;
+
+        [[nodiscard]] size_t getCount() const { return functions.size(); }
+
+    private:
+        std::vector<Function> functions;
+    };
+
+
+    /**
+     * @brief Turns the histogram dump of Stm32Common::PcSampler into a flat profile.
+     *
+     * The samples of a bucket are attributed to the function containing the start of the bucket, or else to the
+     * first function starting in the bucket. A smaller bucket size, i.e. more buckets, gives a sharper profile.
+     */
+    class PcProfile {
+    public:
+        struct Bucket {
+            uint64_t address;
+            uint64_t count;
+        };
+
+        struct Entry {
+            std::string name;
+            uint64_t samples;
+        };
+
+        /**
+         * @brief Reads the first dump of the stream. Other lines, e.g. log output around the dump, and a prefix on
+         * every line, e.g. a log tag, are skipped. Returns false and sets the error if there is no complete dump.
+         */
+        bool parse(std::istream &in);
+
+        /**
+         * @brief Attributes the samples to the functions. Sorted by samples, descending, then by name.
+         */
+        void symbolize(const SymbolTable &symbols);
+
+        void writeText(std::ostream &out) const;
+
+        void writeJson(std::ostream &out) const;
+
+        [[nodiscard]] const std::vector<Bucket> &getBuckets() const { return buckets; }
+
+        [[nodiscard]] const std::vector<Entry> &getEntries() const { return entries; }
+
+        [[nodiscard]] uint64_t getBase() const { return base; }
+
+        [[nodiscard]] uint64_t getBucketSize() const { return 1ULL << bucketShift; }
+
+        [[nodiscard]] unsigned int getScaleShift() const { return scaleShift; }
+
+        [[nodiscard]] uint64_t getRate() const { return rate; }
+
+        /**
+         * @brief Returns the number of samples taken, including the ones outside the histogram.
+         */
+        [[nodiscard]] uint64_t getSamples() const { return samples; }
+
+        [[nodiscard]] uint64_t getOther() const { return other; }
+
+        [[nodiscard]] const std::string &getError() const { return error; }
+
+    private:
+        bool fail(const std::string &message);
+
+        std::vector<Bucket> buckets;
+        std::vector<Entry> entries;
+        uint64_t base = 0;
+        unsigned int bucketShift = 0;
+        unsigned int scaleShift = 0;
+        uint64_t rate = 0;
+        uint64_t samples = 0;
+        uint64_t other = 0;
+        std::string error;
+    };
+}
+
+#endif
@@ -0,0 +1,81 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * Symbolizes the histogram dump of Stm32Common::PcSampler into a flat profile.
+ *
+ * Usage: pcprofile --elf FILE [--json] [DUMP]
+ *
+ * DUMP is the captured output of the firmware, e.g. a terminal log or the ITM output, stdin if omitted. The first
+ * dump in it is used. Example:
+ *
+ * pcprofile --elf build/stm32f1_blinker.elf itm.log
+ */
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include "PcProfile.hpp"
+
+using namespace Stm32Common::Tools;
+
+namespace {
+    int usage() {
+        std::cerr << "Usage: pcprofile --elf FILE [--json] [DUMP]\n";
+        return 2;
+    }
+}
+
+int main(const int argc, char *argv[]) {
+    const char *elfPath = nullptr;
+    const char *dumpPath = nullptr;
+    bool json = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--elf") == 0 && i + 1 < argc) {
+            elfPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--json") == 0) {
+            json = true;
+        } else if (argv[i][0] != '-' && dumpPath == nullptr) {
+            dumpPath = argv[i];
+        } else {
+            return usage();
+        }
+    }
+    if (elfPath == nullptr) return usage();
+
+    ElfFile elf;
+    if (!elf.load(elfPath)) {
+        std::cerr << "pcprofile: " << elfPath << ": " << elf.getError() << '\n';
+        return 1;
+    }
+    SymbolTable symbols;
+    symbols.load(elf);
+
+    PcProfile profile;
+    bool parsed;
+    if (dumpPath != nullptr) {
+        std::ifstream dump(dumpPath);
+        if (!dump) {
+            std::cerr << "pcprofile: cannot open " << dumpPath << '\n';
+            return 1;
+        }
+        parsed = profile.parse(dump);
+    } else {
+        parsed = profile.parse(std::cin);
+    }
+    if (!parsed) {
+        std::cerr << "pcprofile: " << profile.getError() << '\n';
+        return 1;
+    }
+
+    profile.symbolize(symbols);
+    if (json) {
+        profile.writeJson(std::cout);
+    } else {
+        profile.writeText(std::cout);
+    }
+    return 0;
+}
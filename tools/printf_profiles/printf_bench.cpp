@@ -0,0 +1,93 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * Measures snprintf() of src/printf/printf.c, built with one printf profile.
+ *
+ * Usage: printf_bench_<profile>
+ *
+ * printf.c replaces the snprintf() of the C library, as in the firmware. Prints the median time of a telemetry line
+ * with integers only and, if the profile supports %f, of one with floating point numbers. The output of the
+ * conversions that differ between the profiles is printed, too.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include "printf_config.h"
+
+extern "C" void putchar_(const char c) {
+    std::fputc(c, stdout);
+}
+
+namespace {
+    char line[128];
+    volatile size_t blackhole = 0;
+
+    void integerLine(const uint32_t i) {
+        blackhole += std::snprintf(line, sizeof(line), "t=%lu id=%u state=%s rssi=%d count=%08lx\r\n",
+                                   static_cast<unsigned long>(i), 42U, "RUNNING", -67,
+                                   static_cast<unsigned long>(i * 2654435761U));
+    }
+
+#if PRINTF_SUPPORT_DECIMAL_SPECIFIERS
+    void floatLine(const uint32_t i) {
+        blackhole += std::snprintf(line, sizeof(line), "t=%lu temperature=%.2f voltage=%.3f\r\n",
+                                   static_cast<unsigned long>(i), 21.5 + (i & 0xff) * 0.01, 3.3 - (i & 0x0f) * 0.001);
+    }
+#endif
+
+    struct Nanos {
+        double value;
+    };
+
+    Nanos measure(void (*run)(uint32_t)) {
+        constexpr uint32_t Iterations = 200000;
+        constexpr size_t Runs = 5;
+        double nsPerOp[Runs];
+        for (double &result: nsPerOp) {
+            const auto start = std::chrono::steady_clock::now();
+            for (uint32_t i = 0; i < Iterations; i++) run(i);
+            const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+            result = elapsed.count() / Iterations;
+        }
+        // Median by insertion sort
+        for (size_t i = 1; i < Runs; i++) {
+            for (size_t j = i; j > 0 && nsPerOp[j - 1] > nsPerOp[j]; j--) {
+                const double swap = nsPerOp[j];
+                nsPerOp[j] = nsPerOp[j - 1];
+                nsPerOp[j - 1] = swap;
+            }
+        }
+        return {nsPerOp[Runs / 2]};
+    }
+
+    // iostream formats floating point numbers with the replaced snprintf(), which may lack %g
+    std::ostream &operator<<(std::ostream &out, const Nanos nanos) {
+        const auto tenths = static_cast<unsigned long>(nanos.value * 10 + 0.5);
+        return out << tenths / 10 << '.' << tenths % 10 << " ns";
+    }
+
+#if PRINTF_SUPPORT_DECIMAL_SPECIFIERS || PRINTF_SUPPORT_EXPONENTIAL_SPECIFIERS
+    const char *format(const char *format, const double value) {
+        std::snprintf(line, sizeof(line), format, value);
+        return line;
+    }
+#endif
+}
+
+int main() {
+    std::cout << "profile " << PRINTF_BENCH_NAME << '\n';
+    std::cout << "integer line: " << measure(integerLine) << '\n';
+#if PRINTF_SUPPORT_DECIMAL_SPECIFIERS
+    std::cout << "float line:   " << measure(floatLine) << '\n';
+    std::cout << "%.2f of 1234.5678:  \"" << format("%.2f", 1234.5678) << "\"\n";
+    std::cout << "%.2f of 1e10:       \"" << format("%.2f", 1e10) << "\"\n";
+#endif
+#if PRINTF_SUPPORT_EXPONENTIAL_SPECIFIERS
+    std::cout << "%.3e of 1234.5678:  \"" << format("%.3e", 1234.5678) << "\"\n";
+#endif
+    return 0;
+}
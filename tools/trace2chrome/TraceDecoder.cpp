@@ -0,0 +1,190 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "TraceDecoder.hpp"
+#include <cstdio>
+
+using namespace Stm32Common::Trace;
+
+namespace {
+    constexpr int mainThread = 1;
+    constexpr int isrThread = 2;
+
+    void writeString(std::ostream &out, const std::string &text) {
+        out << '"';
+        for (const char c: text) {
+            if (c == '"' || c == '\\') {
+                out << '\\' << c;
+            } else if (static_cast<unsigned char>(c) < 0x20) {
+                char escaped[8];
+                std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                out << escaped;
+            } else {
+                out << c;
+            }
+        }
+        out << '"';
+    }
+}
+
+void TraceDecoder::feedRaw(const uint8_t *data, const size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        partialWord |= static_cast<uint32_t>(data[i]) << (partialBytes * 8);
+        if (++partialBytes == 4) {
+            feedWord(partialWord);
+            partialWord = 0;
+            partialBytes = 0;
+        }
+    }
+}
+
+void TraceDecoder::feedItm(const uint8_t *data, const size_t length, const uint8_t port) {
+    itmPending.insert(itmPending.end(), data, data + length);
+    const size_t n = itmPending.size();
+    size_t i = 0;
+    while (i < n) {
+        const uint8_t header = itmPending[i];
+
+        if ((header & 0x03) != 0) {
+            // Source packet with 1, 2 or 4 payload bytes, software sources are the stimulus ports
+            const size_t size = (header & 0x03) == 3 ? 4 : header & 0x03;
+            if (i + size >= n) break;
+            if ((header & 0x04) == 0 && (header >> 3) == port) feedRaw(&itmPending[i + 1], size);
+            i += 1 + size;
+            continue;
+        }
+
+        // Sync, overflow and short local timestamps are single bytes, the other protocol packets are followed by
+        // bytes with a continuation bit
+        const bool hasPayload = header != 0x00 && header != 0x80 && header != 0x70
+                                && ((header & 0xcf) == 0xc0 || header == 0x94 || header == 0xb4
+                                    || ((header & 0x0b) == 0x08 && (header & 0x80) != 0));
+        if (!hasPayload) {
+            i++;
+            continue;
+        }
+        size_t j = i + 1;
+        while (j < n && (itmPending[j] & 0x80) != 0) j++;
+        if (j >= n) break;
+        i = j + 1;
+    }
+    itmPending.erase(itmPending.begin(), itmPending.begin() + static_cast<std::ptrdiff_t>(i));
+}
+
+void TraceDecoder::feedWord(const uint32_t word) {
+    if (pendingNameBytes > 0) {
+        for (size_t i = 0; i < 4 && pendingNameBytes > 0; i++, pendingNameBytes--) {
+            pendingName += static_cast<char>(word >> (i * 8));
+        }
+        if (pendingNameBytes == 0) names[pendingNameKey] = pendingName;
+        return;
+    }
+
+    words[wordCount++] = word;
+    if (wordCount < recordWords) return;
+    wordCount = 0;
+
+    // A word is missing or the stream started within a record, resynchronize one word later
+    if (!isValidInfo(words[1])) {
+        skippedWords++;
+        words[0] = words[1];
+        wordCount = 1;
+        return;
+    }
+    addRecord(words[0], words[1]);
+}
+
+std::string TraceDecoder::getName(const EventType space, const uint8_t id) const {
+    const auto it = names.find({space, id});
+    return it == names.end() ? std::string() : it->second;
+}
+
+void TraceDecoder::addRecord(const uint32_t timestamp, const uint32_t info) {
+    const Record record = unpack(timestamp, info);
+    if (record.type == EventType::SYNC) {
+        if (timestamp != 0) frequency = timestamp;
+        return;
+    }
+
+    if (haveTimestamp && timestamp < lastTimestamp) wraps++;
+    haveTimestamp = true;
+    lastTimestamp = timestamp;
+
+    if (record.type == EventType::NAME) {
+        pendingNameKey = {static_cast<EventType>(record.value >> 8), record.id};
+        pendingName.clear();
+        pendingNameBytes = record.value & 0xff;
+        if (pendingNameBytes == 0) names[pendingNameKey] = pendingName;
+        return;
+    }
+    events.push_back({wraps << 32 | timestamp, record.type, record.id, record.value});
+}
+
+std::string TraceDecoder::getExceptionName(const uint8_t exception) const {
+    std::string name = getName(EventType::ISR_ENTER, exception);
+    if (!name.empty()) return name;
+    switch (exception) {
+        case 2: return "NMI";
+        case 3: return "HardFault";
+        case 11: return "SVCall";
+        case 14: return "PendSV";
+        case 15: return "SysTick";
+        default: break;
+    }
+    return exception < 16 ? "Exception " + std::to_string(exception) : "IRQ " + std::to_string(exception - 16);
+}
+
+void TraceDecoder::writeChromeJson(std::ostream &out) const {
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+    out << R"({"ph":"M","pid":1,"name":"process_name","args":{"name":"firmware"}},)" << '\n';
+    out << R"({"ph":"M","pid":1,"tid":1,"name":"thread_name","args":{"name":"main"}},)" << '\n';
+    out << R"({"ph":"M","pid":1,"tid":2,"name":"thread_name","args":{"name":"interrupts"}})";
+
+    const uint64_t start = events.empty() ? 0 : events.front().cycles;
+    unsigned isrDepth = 0;
+    for (const Event &event: events) {
+        char ts[32];
+        std::snprintf(ts, sizeof(ts), "%.3f", static_cast<double>(event.cycles - start) * 1e6 / frequency);
+        const int tid = isrDepth > 0 || event.type == EventType::ISR_ENTER ? isrThread : mainThread;
+
+        out << ",\n{\"pid\":1,\"tid\":" << tid << ",\"ts\":" << ts << ",";
+        switch (event.type) {
+            case EventType::ZONE_BEGIN:
+            case EventType::ZONE_END: {
+                std::string name = getName(EventType::ZONE_BEGIN, event.id);
+                if (name.empty()) name = "zone " + std::to_string(event.id);
+                out << "\"ph\":\"" << (event.type == EventType::ZONE_BEGIN ? 'B' : 'E') << "\",\"name\":";
+                writeString(out, name);
+                break;
+            }
+            case EventType::COUNTER: {
+                std::string name = getName(EventType::COUNTER, event.id);
+                if (name.empty()) name = "counter " + std::to_string(event.id);
+                out << "\"ph\":\"C\",\"name\":";
+                writeString(out, name);
+                out << ",\"args\":{\"value\":" << event.value << '}';
+                break;
+            }
+            case EventType::WAKEUP:
+                out << R"("ph":"i","s":"t","name":"wakeUp session )" << static_cast<unsigned>(event.id) << '"';
+                break;
+            case EventType::ISR_ENTER:
+            case EventType::ISR_EXIT:
+                if (event.type == EventType::ISR_ENTER) {
+                    isrDepth++;
+                } else if (isrDepth > 0) {
+                    isrDepth--;
+                }
+                out << "\"ph\":\"" << (event.type == EventType::ISR_ENTER ? 'B' : 'E') << "\",\"name\":";
+                writeString(out, getExceptionName(event.id));
+                break;
+            default:
+                out << R"("ph":"i","s":"t","name":"unknown")";
+                break;
+        }
+        out << '}';
+    }
+    out << "\n]}\n";
+}
@@ -0,0 +1,93 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef LIBSMART_STM32COMMON_TOOLS_TRACEDECODER_HPP
+#define LIBSMART_STM32COMMON_TOOLS_TRACEDECODER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "TraceRecord.hpp"
+
+namespace Stm32Common::Trace {
+    /**
+     * @brief Decodes the trace record stream of Stm32Common::Tracer and writes it as Chrome Trace Event JSON.
+     *
+     * The stream is either fed as raw little endian words, e.g. drained from a RingTraceSink, or as ITM packets
+     * captured from SWO, from which the words of one stimulus port are taken.
+     */
+    class TraceDecoder {
+    public:
+        struct Event {
+            uint64_t cycles; // Unwrapped timestamp
+            EventType type;
+            uint8_t id;
+            uint16_t value;
+        };
+
+        explicit TraceDecoder(uint32_t defaultFrequency = 72000000) : frequency(defaultFrequency) { ; }
+
+        /**
+         * @brief Feeds raw bytes, four bytes make one little endian word.
+         */
+        void feedRaw(const uint8_t *data, size_t length);
+
+        /**
+         * @brief Feeds ITM packets, only software source packets of the given stimulus port are decoded.
+         */
+        void feedItm(const uint8_t *data, size_t length, uint8_t port);
+
+        void feedWord(uint32_t word);
+
+        [[nodiscard]] const std::vector<Event> &getEvents() const { return events; }
+
+        /**
+         * @brief Returns the name given to the id by a NAME record, or an empty string.
+         */
+        [[nodiscard]] std::string getName(EventType space, uint8_t id) const;
+
+        [[nodiscard]] uint32_t getFrequency() const { return frequency; }
+
+        /**
+         * @brief Returns the number of words that have been skipped because they did not form a valid record.
+         */
+        [[nodiscard]] size_t getSkippedWords() const { return skippedWords; }
+
+        void writeChromeJson(std::ostream &out) const;
+
+    private:
+        void addRecord(uint32_t timestamp, uint32_t info);
+
+        [[nodiscard]] std::string getExceptionName(uint8_t exception) const;
+
+        std::vector<Event> events;
+        std::map<std::pair<EventType, uint8_t>, std::string> names;
+        uint32_t frequency;
+
+        // Record assembly
+        uint32_t words[recordWords] = {};
+        size_t wordCount = 0;
+        std::string pendingName;
+        size_t pendingNameBytes = 0;
+        std::pair<EventType, uint8_t> pendingNameKey{};
+        size_t skippedWords = 0;
+
+        // Timestamp unwrapping
+        bool haveTimestamp = false;
+        uint32_t lastTimestamp = 0;
+        uint64_t wraps = 0;
+
+        // Byte assembly of feedRaw() and feedItm()
+        uint32_t partialWord = 0;
+        size_t partialBytes = 0;
+        std::vector<uint8_t> itmPending;
+    };
+}
+
+#endif
@@ -0,0 +1,73 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * Converts a trace record stream of Stm32Common::Tracer to Chrome Trace Event JSON.
+ *
+ * Usage: trace2chrome [--itm PORT] [--frequency HZ] INPUT [OUTPUT]
+ *
+ * INPUT is a raw dump of a RingTraceSink, or with --itm a binary SWO capture, e.g. from OpenOCD
+ * "tpiu config internal swo.bin uart off 72000000". Without OUTPUT the JSON is written to stdout. The frequency is
+ * only used if the stream contains no SYNC record.
+ */
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <vector>
+#include "TraceDecoder.hpp"
+
+int main(const int argc, char *argv[]) {
+    int port = -1;
+    uint32_t frequency = 72000000;
+    const char *input = nullptr;
+    const char *output = nullptr;
+
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--itm") == 0 && i + 1 < argc) {
+            port = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--frequency") == 0 && i + 1 < argc) {
+            frequency = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (input == nullptr) {
+            input = argv[i];
+        } else if (output == nullptr) {
+            output = argv[i];
+        } else {
+            input = nullptr;
+            break;
+        }
+    }
+    if (input == nullptr || port > 31) {
+        std::cerr << "Usage: trace2chrome [--itm PORT] [--frequency HZ] INPUT [OUTPUT]\n";
+        return 2;
+    }
+
+    std::ifstream in(input, std::ios::binary);
+    if (!in) {
+        std::cerr << "trace2chrome: cannot open " << input << '\n';
+        return 1;
+    }
+    const std::vector<uint8_t> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+    Stm32Common::Trace::TraceDecoder decoder(frequency);
+    if (port >= 0) {
+        decoder.feedItm(data.data(), data.size(), static_cast<uint8_t>(port));
+    } else {
+        decoder.feedRaw(data.data(), data.size());
+    }
+
+    if (output != nullptr) {
+        std::ofstream out(output);
+        decoder.writeChromeJson(out);
+    } else {
+        decoder.writeChromeJson(std::cout);
+    }
+    std::cerr << decoder.getEvents().size() << " events";
+    if (decoder.getSkippedWords() > 0) std::cerr << ", " << decoder.getSkippedWords() << " words skipped";
+    std::cerr << '\n';
+    return 0;
+}